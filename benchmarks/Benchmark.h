@@ -0,0 +1,194 @@
+#pragma once
+
+#include "../src/Profiler/AllocationCounter.h"
+
+#include <rapidjson/ostreamwrapper.h>
+#include <rapidjson/prettywriter.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <array>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Benchmark {
+    struct Result {
+        std::string name;
+        uint64_t iterations;
+        double nsPerIteration;
+        // Выделения из кучи за все итерации по подсистемам (сборка с BATTLECITY_COUNT_ALLOCATIONS).
+        std::array<AllocationCounter::Counters, AllocationCounter::TAGS_COUNT> allocations;
+    };
+
+    /**
+     * Функция выполняет function iterations раз и возвращает среднее время одного вызова.
+     * */
+    template<typename Function>
+    Result run(const std::string& name, const uint64_t iterations, Function&& function) {
+        std::array<AllocationCounter::Counters, AllocationCounter::TAGS_COUNT> allocations;
+        for (size_t i = 0; i < allocations.size(); ++i) {
+            allocations[i] = AllocationCounter::getCounters(static_cast<AllocationCounter::ETag>(i));
+        }
+        const auto start = std::chrono::steady_clock::now();
+        for (uint64_t i = 0; i < iterations; ++i) {
+            function(i);
+        }
+        const auto finish = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < allocations.size(); ++i) {
+            const AllocationCounter::Counters counters =
+                    AllocationCounter::getCounters(static_cast<AllocationCounter::ETag>(i));
+            allocations[i] = { counters.count - allocations[i].count, counters.bytes - allocations[i].bytes };
+        }
+        const double totalNs = static_cast<double>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(finish - start).count());
+        return { name, iterations, iterations ? totalNs / static_cast<double>(iterations) : 0.0, allocations };
+    }
+
+    /**
+     * Функция возвращает выделения из кучи за все итерации замера без разделения по подсистемам.
+     * */
+    inline AllocationCounter::Counters getTotalAllocations(const Result& result) {
+        AllocationCounter::Counters total;
+        for (const AllocationCounter::Counters& counters : result.allocations) {
+            total.count += counters.count;
+            total.bytes += counters.bytes;
+        }
+        return total;
+    }
+
+    inline void print(const Result& result) {
+        std::cout << result.name << ": " << result.nsPerIteration << " ns/iter ("
+                  << result.iterations << " iterations";
+        if (AllocationCounter::isEnabled() && result.iterations > 0) {
+            std::cout << ", " << static_cast<double>(getTotalAllocations(result).count) / result.iterations
+                      << " allocations/iter";
+        }
+        std::cout << ")" << std::endl;
+    }
+
+    /**
+     * Результаты одного запуска набора замеров. Каждый результат сразу выводится в консоль,
+     * а в конце может быть сохранен в JSON, чтобы сравнивать замеры между коммитами:
+     * { "suite", "context": { "date", "build", ... }, "benchmarks": [ { "name", "iterations",
+     * "nsPerIteration" } ] }. В сборке с BATTLECITY_COUNT_ALLOCATIONS замер дополнительно содержит
+     * "allocationsPerIteration", "allocatedBytesPerIteration" и "allocationsByTag": { подсистема:
+     * выделения за все итерации } для подсистем, которые выделяли память.
+     * */
+    class Report {
+    public:
+        explicit Report(std::string suite) : m_suite(std::move(suite)) {}
+
+        /**
+         * Метод добавляет в раздел context строку, описывающую окружение (например, видеокарту).
+         * */
+        void setContext(const std::string& key, const std::string& value) {
+            m_context.emplace_back(key, value);
+        }
+
+        void add(const Result& result) {
+            print(result);
+            m_results.push_back(result);
+        }
+
+        /**
+         * Метод сохраняет результаты в JSON файл.
+         * @return false, если файл не удалось записать. В std::cerr будет выведено сообщение.
+         * */
+        bool writeJSON(const std::string& path) const {
+            std::ofstream file(path, std::ios::out | std::ios::trunc);
+            if (! file.is_open()) {
+                std::cerr << "Can't write benchmark results: " << path << std::endl;
+                return false;
+            }
+            rapidjson::OStreamWrapper stream(file);
+            rapidjson::PrettyWriter<rapidjson::OStreamWrapper> writer(stream);
+            writer.StartObject();
+            writer.Key("suite");
+            writer.String(m_suite.c_str());
+            writer.Key("context");
+            writer.StartObject();
+            char date[32];
+            const std::time_t now = std::time(nullptr);
+            std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+            writer.Key("date");
+            writer.String(date);
+            writer.Key("build");
+#ifdef NDEBUG
+            writer.String("release");
+#else
+            writer.String("debug");
+#endif
+            for (const auto& entry : m_context) {
+                writer.Key(entry.first.c_str());
+                writer.String(entry.second.c_str());
+            }
+            writer.EndObject();
+            writer.Key("benchmarks");
+            writer.StartArray();
+            for (const Result& result : m_results) {
+                writer.StartObject();
+                writer.Key("name");
+                writer.String(result.name.c_str());
+                writer.Key("iterations");
+                writer.Uint64(result.iterations);
+                writer.Key("nsPerIteration");
+                writer.Double(result.nsPerIteration);
+                if (AllocationCounter::isEnabled()) {
+                    writeAllocations(writer, result);
+                }
+                writer.EndObject();
+            }
+            writer.EndArray();
+            writer.EndObject();
+            file << std::endl;
+            if (! file) {
+                std::cerr << "Can't write benchmark results: " << path << std::endl;
+                return false;
+            }
+            std::cout << "Benchmark results written to " << path << std::endl;
+            return true;
+        }
+
+    private:
+        template<typename Writer>
+        static void writeAllocations(Writer& writer, const Result& result) {
+            const AllocationCounter::Counters total = getTotalAllocations(result);
+            const double iterations = result.iterations ? static_cast<double>(result.iterations) : 1.0;
+            writer.Key("allocationsPerIteration");
+            writer.Double(static_cast<double>(total.count) / iterations);
+            writer.Key("allocatedBytesPerIteration");
+            writer.Double(static_cast<double>(total.bytes) / iterations);
+            writer.Key("allocationsByTag");
+            writer.StartObject();
+            for (size_t i = 0; i < result.allocations.size(); ++i) {
+                if (result.allocations[i].count > 0) {
+                    writer.Key(AllocationCounter::getTagName(static_cast<AllocationCounter::ETag>(i)));
+                    writer.Uint64(result.allocations[i].count);
+                }
+            }
+            writer.EndObject();
+        }
+
+    private:
+        std::string m_suite;
+        std::vector<std::pair<std::string, std::string>> m_context;
+        std::vector<Result> m_results;
+    };
+
+    /**
+     * Функция возвращает путь из аргумента "--json <path>" или пустую строку.
+     * */
+    inline std::string getJSONPath(const int argc, char** argv) {
+        for (int i = 1; i + 1 < argc; ++i) {
+            if (std::strcmp(argv[i], "--json") == 0) {
+                return argv[i + 1];
+            }
+        }
+        return {};
+    }
+}
@@ -0,0 +1,236 @@
+#include "Benchmark.h"
+
+#include <glad/glad.h>
+
+#include "../src/ResourceManager/ResourceManager.h"
+#include "../src/Renderer/ShaderProgram.h"
+#include "../src/Renderer/Palette.h"
+#include "../src/Renderer/Texture2D.h"
+#include "../src/Renderer/AnimatedSprite.h"
+#include "../src/Renderer/PacketRenderer.h"
+#include "../src/Renderer/RenderPacket.h"
+#include "../src/Renderer/Renderer.h"
+#include "../src/Renderer/OffscreenContext.h"
+#include "../src/Renderer/FrameBuffer.h"
+#include "../src/Game/Random.h"
+#include "../src/Exception/Exception.h"
+
+#include <glm/mat4x4.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <string>
+
+namespace {
+    constexpr unsigned int FRAME_WIDTH = 640;
+    constexpr unsigned int FRAME_HEIGHT = 480;
+    // Шаг симуляции игры (Game::TICK_DURATION).
+    constexpr uint64_t TICK_DURATION = 1000000000 / 60;
+    // Сколько спрайтов сцены выводится за один вызов отрисовки.
+    constexpr unsigned int SCENE_BATCH_CAPACITY = 1024;
+    constexpr glm::vec2 SCENE_SPRITE_SIZE(16.f, 16.f);
+
+    const std::array<std::string, 8> TANK_SUBTEXTURES = {
+        "yellowType1_Top1", "yellowType1_Top2", "yellowType1_Left1", "yellowType1_Left2",
+        "yellowType1_Bottom1", "yellowType1_Bottom2", "yellowType1_Right1", "yellowType1_Right2"
+    };
+
+    /**
+     * Контекст без видимого окна и собственный буфер кадра FRAME_WIDTH x FRAME_HEIGHT, поэтому
+     * вертикальная синхронизация не влияет на замеры.
+     * */
+    class OffscreenTarget {
+    public:
+        OffscreenTarget(const OffscreenTarget&) = delete;
+        OffscreenTarget& operator=(const OffscreenTarget&) = delete;
+
+        /**
+         * @throw Exception::Exception, если не удалось создать контекст или буфер кадра.
+         * */
+        OffscreenTarget() : m_frameBuffer(FRAME_WIDTH, FRAME_HEIGHT) {
+            m_frameBuffer.bind();
+            RenderEngine::Renderer::setClearColour(0, 0, 0, 1);
+        }
+
+        ~OffscreenTarget() {
+            // Ресурсы удаляются, пока контекст еще текущий.
+            ResourceManager::unloadAllResources();
+        }
+
+    private:
+        RenderEngine::OffscreenContext m_context;
+        RenderEngine::FrameBuffer m_frameBuffer;
+    };
+
+    void loadResources(const std::string& executablePath) {
+        // unloadAllResources() забывает и путь к ресурсам.
+        ResourceManager::unloadAllResources();
+        ResourceManager::setExecutablePath(executablePath);
+        if (! ResourceManager::loadJSONResources("res/resources.json")) {
+            throw Exception::Exception("Can't load res/resources.json");
+        }
+    }
+
+    void benchmarkResources(Benchmark::Report& report, const std::string& executablePath) {
+        // Разбор JSON вместе с чтением и загрузкой текстур и сборкой шейдеров.
+        report.add(Benchmark::run("ResourceManager/loadJSONResources", 20, [&](uint64_t) {
+            loadResources(executablePath);
+        }));
+        // Ленивый режим: индекс файла и только то, что нужно танку на первом экране.
+        report.add(Benchmark::run("ResourceManager/loadJSONResources/lazy", 20, [&](uint64_t) {
+            ResourceManager::setLazyLoading(true);
+            loadResources(executablePath);
+            ResourceManager::setLazyLoading(false);
+        }));
+        report.add(Benchmark::run("ResourceManager/loadJSONResources/lazyFirstUse", 20, [&](uint64_t) {
+            ResourceManager::setLazyLoading(true);
+            loadResources(executablePath);
+            ResourceManager::setLazyLoading(false);
+            if (! ResourceManager::getAnimatedSprite("tankAnimatedSprite")) {
+                throw Exception::Exception("Can't load tankAnimatedSprite lazily");
+            }
+        }));
+        loadResources(executablePath);
+
+        // Имена создаются заранее, замеряется только поиск.
+        const std::array<std::string, 2> textureNames = { "mapTextureAtlas", "tanksTextureAtlas" };
+        const std::string shaderName = "spriteShader";
+        const std::string animatedSpriteName = "tankAnimatedSprite";
+        uint64_t checksum = 0;
+        report.add(Benchmark::run("ResourceManager/getTexture", 1000000, [&](const uint64_t i) {
+            checksum += ResourceManager::getTexture(textureNames[i % textureNames.size()])->width();
+        }));
+        // Владельцы ресурсов хранят дескрипторы и не ищут ресурс по имени каждый кадр.
+        const std::array<ResourceManager::TextureHandle, 2> textureHandles = {
+            ResourceManager::getTextureHandle(textureNames[0]), ResourceManager::getTextureHandle(textureNames[1])
+        };
+        report.add(Benchmark::run("ResourceManager/getTexture/handle", 1000000, [&](const uint64_t i) {
+            checksum += ResourceManager::getTexture(textureHandles[i % textureHandles.size()])->width();
+        }));
+        report.add(Benchmark::run("ResourceManager/getShaderProgram", 1000000, [&](uint64_t) {
+            checksum += ResourceManager::getShaderProgram(shaderName)->isCompiled();
+        }));
+        report.add(Benchmark::run("ResourceManager/getAnimatedSprite", 1000000, [&](uint64_t) {
+            checksum += ResourceManager::getAnimatedSprite(animatedSpriteName) != nullptr;
+        }));
+
+        const auto pTanksTexture = ResourceManager::getTexture("tanksTextureAtlas");
+        float uvChecksum = 0.f;
+        report.add(Benchmark::run("Texture2D/getSubTexture", 1000000, [&](const uint64_t i) {
+            uvChecksum += pTanksTexture->getSubTexture(TANK_SUBTEXTURES[i % TANK_SUBTEXTURES.size()]).rightTopUV.x;
+        }));
+
+        const auto pTankSprite = ResourceManager::getAnimatedSprite("tankAnimatedSprite")->clone();
+        pTankSprite->setState("tankTopState");
+        report.add(Benchmark::run("AnimatedSprite/update", 1000000, [&](uint64_t) {
+            pTankSprite->update(TICK_DURATION);
+        }));
+
+        const auto pShaderProgram = ResourceManager::getShaderProgram("spriteShader");
+        pShaderProgram->use();
+        const glm::mat4 projection = glm::ortho(0.f, static_cast<float>(FRAME_WIDTH),
+                                                0.f, static_cast<float>(FRAME_HEIGHT), -100.f, 100.f);
+        report.add(Benchmark::run("ShaderProgram/setUniform/mat4", 1000000, [&](uint64_t) {
+            pShaderProgram->setUniform("projectionMat", projection);
+        }));
+        report.add(Benchmark::run("ShaderProgram/setUniform/int", 1000000, [&](uint64_t) {
+            pShaderProgram->setUniform("tex", 0);
+        }));
+        glFinish();
+        std::cout << "  checksum: " << checksum + static_cast<uint64_t>(uvChecksum) << std::endl;
+    }
+
+    /**
+     * Функция рисует сцену из spritesCount танков в случайных позициях двумя способами:
+     * пакетом кадра, как игра (PacketRenderer), и отдельным вызовом отрисовки на каждый спрайт
+     * (Sprite::render). Время кадра включает ожидание видеокарты (glFinish).
+     * */
+    void benchmarkScene(Benchmark::Report& report, const unsigned int spritesCount) {
+        const auto tanksTexture = ResourceManager::getTextureHandle("tanksTextureAtlas");
+        const auto pTanksTexture = ResourceManager::getTexture(tanksTexture);
+        const auto shaderProgram = ResourceManager::getShaderProgramHandle(pTanksTexture->isIndexed() ? "indexedSpriteShader"
+                                                                                                       : "spriteShader");
+        const auto pShaderProgram = ResourceManager::getShaderProgram(shaderProgram);
+        const std::string prefix = "Scene/sprites=" + std::to_string(spritesCount);
+
+        RenderEngine::RenderPacket packet;
+        packet.cameraSize = glm::vec2(FRAME_WIDTH, FRAME_HEIGHT);
+        packet.beginPass("sprites");
+        std::array<RenderEngine::Texture2D::SubTexture2D, TANK_SUBTEXTURES.size()> subTextures;
+        for (size_t i = 0; i < subTextures.size(); ++i) {
+            subTextures[i] = pTanksTexture->getSubTexture(TANK_SUBTEXTURES[i]);
+        }
+        Random random(spritesCount);
+        for (unsigned int i = 0; i < spritesCount; ++i) {
+            const glm::vec2 position(random.nextInt(FRAME_WIDTH - 16), random.nextInt(FRAME_HEIGHT - 16));
+            packet.addSprite(tanksTexture, subTextures[i % subTextures.size()], position, SCENE_SPRITE_SIZE);
+        }
+
+        pShaderProgram->use();
+        pShaderProgram->setUniform("tex", 0);
+        if (pTanksTexture->isIndexed()) {
+            pShaderProgram->setUniform("palette", static_cast<GLint>(RenderEngine::Palette::TEXTURE_UNIT));
+        }
+        RenderEngine::PacketRenderer packetRenderer(shaderProgram, SCENE_BATCH_CAPACITY);
+        packetRenderer.addTexture(tanksTexture);
+        auto renderPacket = [&]() {
+            RenderEngine::Renderer::clear();
+            packetRenderer.setCamera(packet);
+            packetRenderer.drawSprites(packet);
+            glFinish();
+        };
+        // Первый кадр создает ресурсы драйвера и не учитывается.
+        renderPacket();
+        RenderEngine::Renderer::resetFrameStats();
+        const uint64_t batchedFrames = std::max<uint64_t>(10, 200000 / spritesCount);
+        report.add(Benchmark::run(prefix + "/PacketRenderer", batchedFrames, [&](uint64_t) {
+            renderPacket();
+        }));
+        std::cout << "  draw calls per frame: " << RenderEngine::Renderer::getFrameStats().drawCalls / batchedFrames
+                  << std::endl;
+
+        const auto pSprite = ResourceManager::getAnimatedSprite("tankAnimatedSprite")->clone();
+        pSprite->setState("tankTopState");
+        pSprite->setSize(SCENE_SPRITE_SIZE);
+        auto renderSprites = [&]() {
+            RenderEngine::Renderer::clear();
+            packetRenderer.setCamera(packet);
+            for (const auto& sprite : packet.sprites) {
+                pSprite->setPosition(sprite.position);
+                pSprite->render();
+            }
+            glFinish();
+        };
+        renderSprites();
+        report.add(Benchmark::run(prefix + "/Sprite::render", std::max<uint64_t>(3, 20000 / spritesCount),
+                                  [&](uint64_t) {
+            renderSprites();
+        }));
+    }
+}
+
+int main(int argc, char** argv) {
+    try {
+        OffscreenTarget target;
+        Benchmark::Report report("Engine");
+        report.setContext("renderer", RenderEngine::Renderer::getRendererStr());
+        report.setContext("glVersion", RenderEngine::Renderer::getVersionStr());
+        std::cout << "Renderer: " << RenderEngine::Renderer::getRendererStr() << std::endl;
+
+        benchmarkResources(report, argv[0]);
+        for (const unsigned int spritesCount : { 1000u, 10000u, 100000u }) {
+            benchmarkScene(report, spritesCount);
+        }
+
+        const std::string JSONPath = Benchmark::getJSONPath(argc, argv);
+        if (! JSONPath.empty() && ! report.writeJSON(JSONPath)) {
+            return 1;
+        }
+    } catch (const std::exception& ex) {
+        std::cerr << ex.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
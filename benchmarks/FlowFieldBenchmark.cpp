@@ -0,0 +1,89 @@
+#include "Benchmark.h"
+
+#include "../src/Game/FlowField.h"
+#include "../src/Game/Terrain.h"
+#include "../src/Game/Pathfinder.h"
+
+#include <vector>
+
+namespace {
+    uint32_t nextRandom(uint32_t& state) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+
+    /**
+     * Функция строит случайную карту, похожую на уровни игры: треть кирпича, немного бетона
+     * и воды. Орел стоит в середине нижней строки.
+     * */
+    NavigationGrid makeGrid(const unsigned int size, std::vector<unsigned int>& bricks) {
+        NavigationGrid grid(size, size);
+        uint32_t state = 0x9E3779B9u ^ size;
+        for (unsigned int i = 0; i < grid.costs.size(); ++i) {
+            const uint32_t roll = nextRandom(state) % 100;
+            if (roll < 35) {
+                grid.costs[i] = Terrain::BRICK_NAVIGATION_COST;
+                bricks.push_back(i);
+            } else if (roll < 45) {
+                grid.costs[i] = NavigationGrid::IMPASSABLE;
+            } else {
+                grid.costs[i] = 1;
+            }
+        }
+        grid.costs[grid.index(size / 2, 0)] = NavigationGrid::IMPASSABLE;
+        return grid;
+    }
+
+    void benchmarkMap(Benchmark::Report& report, const unsigned int size, const uint64_t rebuildIterations) {
+        std::vector<unsigned int> bricks;
+        Pathfinder pathfinder(makeGrid(size, bricks), 1);
+        pathfinder.setTarget(0, size / 2, 0);
+        const std::string prefix = "FlowField/" + std::to_string(size) + "x" + std::to_string(size);
+
+        FlowField& flowField = pathfinder.getFlowField(0);
+        uint64_t checksum = 0;
+        report.add(Benchmark::run(prefix + "/FullRebuild", rebuildIterations, [&](uint64_t) {
+            pathfinder.rebuild(0);
+            checksum += flowField.getDistance(0, size - 1);
+        }));
+
+        // Каждая итерация разрушает новую кирпичную клетку, как при перестрелке.
+        const uint64_t updates = std::min<uint64_t>(bricks.size(), 20000);
+        report.add(Benchmark::run(prefix + "/DestroyBrick", updates, [&](const uint64_t i) {
+            const unsigned int cell = bricks[i];
+            pathfinder.setCellCost(cell % size, cell / size, 1);
+            checksum += flowField.getDistance(0, size - 1);
+        }));
+        report.add(Benchmark::run(prefix + "/RestoreBrick", updates, [&](const uint64_t i) {
+            const unsigned int cell = bricks[i];
+            pathfinder.setCellCost(cell % size, cell / size, Terrain::BRICK_NAVIGATION_COST);
+            checksum += flowField.getDistance(0, size - 1);
+        }));
+
+        // Цель игрока сдвигается каждый шаг, а поле никто не читает: перестройка откладывается.
+        report.add(Benchmark::run(prefix + "/MoveTarget", 1000000, [&](const uint64_t i) {
+            pathfinder.setTarget(0, static_cast<unsigned int>(i % size), size - 1);
+        }));
+        pathfinder.setTarget(0, size / 2, 0);
+
+        uint64_t directions = 0;
+        report.add(Benchmark::run(prefix + "/DirectionLookup", 1000000, [&](const uint64_t i) {
+            directions += static_cast<uint64_t>(pathfinder.getDirection(0, i % size, (i / size) % size));
+        }));
+        std::cout << "  checksum: " << checksum + directions << std::endl;
+    }
+}
+
+int main(int argc, char** argv) {
+    Benchmark::Report report("FlowField");
+    benchmarkMap(report, 13, 20000);
+    benchmarkMap(report, 52, 2000);
+    benchmarkMap(report, 256, 50);
+    const std::string JSONPath = Benchmark::getJSONPath(argc, argv);
+    if (! JSONPath.empty() && ! report.writeJSON(JSONPath)) {
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,140 @@
+#include "Benchmark.h"
+
+#include "../src/Game/Game.h"
+#include "../src/Game/GameSnapshot.h"
+#include "../src/Game/BulletPool.h"
+#include "../src/Game/Level.h"
+#include "../src/Game/Terrain.h"
+#include "../src/Game/Random.h"
+#include "../src/Renderer/OffscreenContext.h"
+#include "../src/ResourceManager/ResourceManager.h"
+#include "../src/Exception/Exception.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+    /**
+     * Контекст без видимого окна для игры; ресурсы удаляются, пока он еще текущий.
+     * */
+    class OffscreenTarget {
+    public:
+        OffscreenTarget(const OffscreenTarget&) = delete;
+        OffscreenTarget& operator=(const OffscreenTarget&) = delete;
+
+        OffscreenTarget() = default;
+        ~OffscreenTarget() {
+            ResourceManager::unloadAllResources();
+        }
+
+    private:
+        RenderEngine::OffscreenContext m_context;
+    };
+
+    /**
+     * Функция строит описание уровня size x size: сплошной кирпич по краям и через строку,
+     * орел в середине нижней строки.
+     * */
+    std::vector<std::string> makeLevelDescription(const unsigned int size) {
+        std::vector<std::string> description(size, std::string(size, 'D'));
+        for (unsigned int y = 0; y < size; y += 2) {
+            std::fill(description[y].begin(), description[y].end(), '4');
+        }
+        description[size - 1][size / 2] = 'E';
+        return description;
+    }
+
+    /**
+     * Функция выпускает bullets снарядов и разрушает damagedCells кирпичных клеток игры.
+     * Разрушения проходят через слушателей Terrain, как попадания снарядов в игре.
+     * */
+    void populate(Game& game, const unsigned int bullets, const unsigned int damagedCells) {
+        BulletPool& bulletPool = *game.getBulletPool();
+        Terrain& terrain = *game.getTerrain();
+        Random random(bullets);
+        for (unsigned int i = 0; i < bullets; ++i) {
+            const auto offset = static_cast<float>(random.nextInt(terrain.width() * Level::BLOCK_SIZE));
+            bulletPool.spawn(glm::vec2(offset, offset), Tank::EOrientation::Top, 0.0000003f);
+        }
+        unsigned int damaged = 0;
+        for (unsigned int y = 0; y < terrain.height() && damaged < damagedCells; y += 2) {
+            for (unsigned int x = 0; x < terrain.width() && damaged < damagedCells; ++x) {
+                terrain.setWallMask(x, y, Level::TopLeft);
+                ++damaged;
+            }
+        }
+    }
+
+    /**
+     * Замер Game::saveSnapshot() и Game::restoreSnapshot() на игре двух игроков с картой
+     * levelSize x levelSize. Игре нужен контекст OpenGL (спрайты и отрисовка карты).
+     * */
+    void benchmarkEntities(Benchmark::Report& report, const unsigned int levelSize,
+                           const unsigned int bullets, const unsigned int damagedCells) {
+        Game game(glm::vec2(levelSize * Level::BLOCK_SIZE));
+        game.setPlayersCount(2);
+        game.setLevelDescription(makeLevelDescription(levelSize));
+        game.init();
+        if (! game.getTerrain() || ! game.getBulletPool()) {
+            throw Exception::Exception("Can't initialize the game");
+        }
+
+        auto pInitial = std::make_unique<GameSnapshot>();
+        auto pDamaged = std::make_unique<GameSnapshot>();
+        auto pSnapshot = std::make_unique<GameSnapshot>();
+        game.prepareSnapshot(*pSnapshot);
+        game.saveSnapshot(*pInitial);
+        populate(game, bullets, damagedCells);
+        game.saveSnapshot(*pDamaged);
+
+        const std::string prefix = "Snapshot/" + std::to_string(levelSize) + "x" + std::to_string(levelSize) +
+                                   "/bullets=" + std::to_string(bullets) +
+                                   "/damagedCells=" + std::to_string(damagedCells);
+        uint64_t checksum = 0;
+        report.add(Benchmark::run(prefix + "/Save", 100000, [&](uint64_t) {
+            game.saveSnapshot(*pSnapshot);
+            checksum += pSnapshot->bulletsCount;
+        }));
+        // Откат на несколько шагов: разрушения совпадают, копируются только снаряды и счетчики.
+        report.add(Benchmark::run(prefix + "/RestoreUnchanged", 100000, [&](uint64_t) {
+            game.restoreSnapshot(*pDamaged);
+            checksum += game.getBulletPool()->size();
+        }));
+        // Каждое восстановление переключает damagedCells клеток, обновляя поиск пути.
+        const uint64_t iterations = damagedCells > 64 ? 200 : 20000;
+        report.add(Benchmark::run(prefix + "/RestoreChanged", iterations, [&](const uint64_t i) {
+            game.restoreSnapshot(i % 2 ? *pDamaged : *pInitial);
+            checksum += game.getBulletPool()->size();
+        }));
+        std::cout << "checksum: " << checksum + game.getStateHash() << std::endl;
+    }
+}
+
+int main(int argc, char** argv) {
+    try {
+        OffscreenTarget target;
+        Benchmark::Report report("Snapshot");
+        std::cout << "sizeof(GameSnapshot): " << sizeof(GameSnapshot) << " bytes + 1 byte per cell" << std::endl;
+        ResourceManager::setExecutablePath(argv[0]);
+        for (const unsigned int bullets : { 0u, 8u, 64u }) {
+            for (const unsigned int damagedCells : { 0u, 1u, 16u, 256u }) {
+                benchmarkEntities(report, 26, bullets, damagedCells);
+            }
+        }
+        benchmarkEntities(report, 64, 64, 0);
+        benchmarkEntities(report, 64, 64, 16);
+        benchmarkEntities(report, 256, 64, 0);
+        benchmarkEntities(report, 256, 64, 256);
+
+        const std::string JSONPath = Benchmark::getJSONPath(argc, argv);
+        if (! JSONPath.empty() && ! report.writeJSON(JSONPath)) {
+            return 1;
+        }
+    } catch (const std::exception& ex) {
+        std::cerr << ex.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
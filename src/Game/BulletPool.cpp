@@ -0,0 +1,102 @@
+#include "BulletPool.h"
+
+#include "../Renderer/RenderPacket.h"
+
+#include <algorithm>
+
+BulletPool::BulletPool(const unsigned int capacity,
+                       const RenderEngine::TextureHandle texture,
+                       const glm::vec2& bulletSize) :
+                       m_capacity(capacity),
+                       m_activeCount(0),
+                       m_highWaterMark(0),
+                       m_droppedCount(0),
+                       m_bullets(capacity),
+                       m_bulletSize(bulletSize),
+                       m_texture(texture) {
+    resolveSubTextures();
+}
+
+BulletPool::~BulletPool() {}
+
+void BulletPool::resolveSubTextures() {
+    const RenderEngine::Texture2D* pTexture = RenderEngine::getTexturePool().get(m_texture);
+    if (! pTexture) {
+        return;
+    }
+    // Порядок совпадает с порядком Tank::EOrientation.
+    m_subTextures[static_cast<size_t>(Tank::EOrientation::Top)] = pTexture->getSubTexture("bulletTop");
+    m_subTextures[static_cast<size_t>(Tank::EOrientation::Bottom)] = pTexture->getSubTexture("bulletBottom");
+    m_subTextures[static_cast<size_t>(Tank::EOrientation::Left)] = pTexture->getSubTexture("bulletLeft");
+    m_subTextures[static_cast<size_t>(Tank::EOrientation::Right)] = pTexture->getSubTexture("bulletRight");
+}
+
+bool BulletPool::spawn(const glm::vec2& position, const Tank::EOrientation eOrientation,
+                       const float velocity) noexcept {
+    if (m_activeCount == m_capacity) {
+        ++m_droppedCount;
+        return false;
+    }
+    Bullet& bullet = m_bullets[m_activeCount++];
+    bullet.position = position;
+    bullet.velocity = velocity;
+    bullet.eOrientation = eOrientation;
+    switch (eOrientation) {
+        case Tank::EOrientation::Top:
+            bullet.moveOffset = glm::vec2(0.f, 1.f);
+            break;
+        case Tank::EOrientation::Bottom:
+            bullet.moveOffset = glm::vec2(0.f, -1.f);
+            break;
+        case Tank::EOrientation::Left:
+            bullet.moveOffset = glm::vec2(-1.f, 0.f);
+            break;
+        case Tank::EOrientation::Right:
+            bullet.moveOffset = glm::vec2(1.f, 0.f);
+            break;
+    }
+    if (m_activeCount > m_highWaterMark) {
+        m_highWaterMark = m_activeCount;
+    }
+    return true;
+}
+
+void BulletPool::update(const uint64_t delta, const glm::vec2& bounds) noexcept {
+    update(delta, bounds, [](const Bullet&) { return false; });
+}
+
+void BulletPool::appendSprites(RenderEngine::RenderPacket& packet) const {
+    if (! m_texture) {
+        return;
+    }
+    const glm::vec2 halfSize = 0.5f * m_bulletSize;
+    for (unsigned int i = 0; i < m_activeCount; ++i) {
+        const Bullet& bullet = m_bullets[i];
+        packet.addSprite(m_texture, m_subTextures[static_cast<size_t>(bullet.eOrientation)],
+                         bullet.position - halfSize, m_bulletSize);
+    }
+}
+
+void BulletPool::clear() noexcept {
+    m_activeCount = 0;
+}
+
+void BulletPool::assign(const Bullet* bullets, const unsigned int count) noexcept {
+    m_activeCount = std::min(count, m_capacity);
+    std::copy(bullets, bullets + m_activeCount, m_bullets.begin());
+    if (m_activeCount > m_highWaterMark) {
+        m_highWaterMark = m_activeCount;
+    }
+}
+
+void BulletPool::resetHighWaterMark() noexcept {
+    m_highWaterMark = m_activeCount;
+    m_droppedCount = 0;
+}
+
+void BulletPool::despawn(const unsigned int index) noexcept {
+    --m_activeCount;
+    if (index != m_activeCount) {
+        m_bullets[index] = m_bullets[m_activeCount];
+    }
+}
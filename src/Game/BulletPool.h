@@ -0,0 +1,123 @@
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include <glm/vec2.hpp>
+
+#include "Tank.h"
+#include "../Renderer/Texture2D.h"
+#include "../Renderer/ResourceHandles.h"
+
+namespace RenderEngine {
+    struct RenderPacket;
+}
+
+/**
+ * Пул снарядов фиксированной емкости. Активные снаряды хранятся плотно в начале массива,
+ * удаление выполняется обменом с последним активным снарядом. Вся память выделяется в
+ * конструкторе, появление и исчезновение снаряда память не выделяет.
+ * */
+class BulletPool {
+public:
+    struct Bullet {
+        glm::vec2 position;
+        glm::vec2 moveOffset;
+        float velocity;
+        Tank::EOrientation eOrientation;
+    };
+
+    BulletPool() = delete;
+    BulletPool(const BulletPool&) = delete;
+    BulletPool& operator=(const BulletPool&) = delete;
+
+    /**
+     * @param capacity максимальное количество одновременно существующих снарядов.
+     * @param texture атлас, содержащий спрайты снарядов bulletTop, bulletBottom, bulletLeft
+     * и bulletRight. Пустой дескриптор создает пул без отрисовки (для бенчмарков и симуляции
+     * без окна).
+     * @param bulletSize размер снаряда на экране.
+     * */
+    BulletPool(unsigned int capacity,
+               RenderEngine::TextureHandle texture,
+               const glm::vec2& bulletSize);
+    ~BulletPool();
+
+    /**
+     * Метод выпускает снаряд.
+     * @param position позиция центра снаряда.
+     * @param eOrientation направление полета.
+     * @param velocity скорость в пикселях за наносекунду.
+     * @return false, если пул заполнен. Такой выстрел учитывается в droppedCount().
+     * */
+    bool spawn(const glm::vec2& position, Tank::EOrientation eOrientation, float velocity) noexcept;
+    /**
+     * Метод перемещает снаряды и удаляет вылетевшие за пределы прямоугольника [0, bounds].
+     * */
+    void update(uint64_t delta, const glm::vec2& bounds) noexcept;
+    /**
+     * Метод перемещает снаряды, удаляет вылетевшие за пределы [0, bounds] и те, для которых
+     * isStopped(const Bullet&) вернул true (попадание в стену или танк).
+     * */
+    template<typename CollisionHandler>
+    void update(uint64_t delta, const glm::vec2& bounds, CollisionHandler&& isStopped);
+    /**
+     * Метод добавляет спрайты всех активных снарядов в пакет кадра. Подряд идущие команды
+     * с одной текстурой рисуются одним вызовом отрисовки.
+     * */
+    void appendSprites(RenderEngine::RenderPacket& packet) const;
+    /**
+     * Метод заново находит спрайты снарядов в атласе по именам. Вызывается после перезагрузки
+     * атласа, в которой области могли переместиться.
+     * */
+    void resolveSubTextures();
+    void clear() noexcept;
+    /**
+     * Метод заменяет активные снаряды копией массива bullets (восстановление снимка).
+     * Лишние снаряды сверх емкости отбрасываются.
+     * */
+    void assign(const Bullet* bullets, unsigned int count) noexcept;
+    const Bullet* data() const noexcept { return m_bullets.data(); }
+
+    unsigned int capacity() const noexcept { return m_capacity; }
+    unsigned int size() const noexcept { return m_activeCount; }
+    const Bullet& getBullet(unsigned int index) const noexcept { return m_bullets[index]; }
+    /**
+     * Максимальное количество одновременно активных снарядов с момента создания пула или
+     * последнего вызова resetHighWaterMark(). Используется для подбора емкости пула.
+     * */
+    unsigned int highWaterMark() const noexcept { return m_highWaterMark; }
+    unsigned int droppedCount() const noexcept { return m_droppedCount; }
+    void resetHighWaterMark() noexcept;
+
+private:
+    void despawn(unsigned int index) noexcept;
+
+private:
+    unsigned int m_capacity;
+    unsigned int m_activeCount;
+    unsigned int m_highWaterMark;
+    unsigned int m_droppedCount;
+    std::vector<Bullet> m_bullets;
+
+    glm::vec2 m_bulletSize;
+    std::array<RenderEngine::Texture2D::SubTexture2D, 4> m_subTextures;
+    RenderEngine::TextureHandle m_texture;
+};
+
+template<typename CollisionHandler>
+void BulletPool::update(const uint64_t delta, const glm::vec2& bounds, CollisionHandler&& isStopped) {
+    unsigned int i = 0;
+    while (i < m_activeCount) {
+        Bullet& bullet = m_bullets[i];
+        bullet.position += static_cast<float>(delta) * bullet.velocity * bullet.moveOffset;
+        if (bullet.position.x < 0.f || bullet.position.y < 0.f ||
+            bullet.position.x > bounds.x || bullet.position.y > bounds.y ||
+            isStopped(static_cast<const Bullet&>(bullet))) {
+            // На место удаленного снаряда встает последний, его тоже нужно обработать.
+            despawn(i);
+            continue;
+        }
+        ++i;
+    }
+}
@@ -0,0 +1,166 @@
+#include "FlowField.h"
+
+#include <algorithm>
+#include <climits>
+
+namespace {
+    // Куча std::push_heap/std::pop_heap максимальная, поэтому сравнение обратное.
+    const auto nodeCompare = [](const auto& lhs, const auto& rhs) {
+        return lhs.distance > rhs.distance;
+    };
+}
+
+FlowField::FlowField(const NavigationGrid& grid) :
+                     m_grid(grid),
+                     m_targetX(UINT_MAX),
+                     m_targetY(UINT_MAX),
+                     m_dirty(false),
+                     m_distances(grid.costs.size(), UNREACHABLE),
+                     m_directions(grid.costs.size(), EDirection::None) {
+    m_heap.reserve(grid.costs.size());
+    m_affected.reserve(grid.costs.size());
+}
+
+void FlowField::setTarget(const unsigned int x, const unsigned int y) noexcept {
+    if (x == m_targetX && y == m_targetY) {
+        return;
+    }
+    m_targetX = x;
+    m_targetY = y;
+    m_dirty = true;
+}
+
+void FlowField::rebuild() {
+    m_dirty = false;
+    std::fill(m_distances.begin(), m_distances.end(), UNREACHABLE);
+    std::fill(m_directions.begin(), m_directions.end(), EDirection::None);
+    m_heap.clear();
+    if (m_targetX >= m_grid.width || m_targetY >= m_grid.height) {
+        return;
+    }
+    const unsigned int target = m_grid.index(m_targetX, m_targetY);
+    m_distances[target] = 0;
+    push(target);
+    propagate();
+}
+
+void FlowField::onCellChanged(const unsigned int x, const unsigned int y, const uint8_t oldCost) {
+    // Устаревшее поле все равно будет построено заново по текущей сетке.
+    if (m_dirty || m_targetX >= m_grid.width || m_targetY >= m_grid.height) {
+        return;
+    }
+    const unsigned int cell = m_grid.index(x, y);
+    const unsigned int target = m_grid.index(m_targetX, m_targetY);
+    const uint8_t newCost = m_grid.costs[cell];
+    if (cell == target || newCost == oldCost) {
+        return;
+    }
+
+    const bool becameWorse = newCost == NavigationGrid::IMPASSABLE ||
+                             (oldCost != NavigationGrid::IMPASSABLE && newCost > oldCost);
+    if (becameWorse) {
+        // Все клетки, чей кратчайший путь проходил через cell, образуют поддерево с корнем
+        // в cell. Сбрасываем их и заново считаем от границы поддерева.
+        m_affected.clear();
+        if (m_distances[cell] != UNREACHABLE) {
+            m_affected.push_back(cell);
+        }
+        for (size_t i = 0; i < m_affected.size(); ++i) {
+            const unsigned int current = m_affected[i];
+            const unsigned int currentX = current % m_grid.width;
+            const unsigned int currentY = current / m_grid.width;
+            const unsigned int neighbours[] {
+                currentY + 1 < m_grid.height ? current + m_grid.width : UINT_MAX,
+                currentY > 0 ? current - m_grid.width : UINT_MAX,
+                currentX > 0 ? current - 1 : UINT_MAX,
+                currentX + 1 < m_grid.width ? current + 1 : UINT_MAX
+            };
+            for (const unsigned int neighbour : neighbours) {
+                if (neighbour != UINT_MAX && m_distances[neighbour] != UNREACHABLE &&
+                    getParent(neighbour) == current) {
+                    m_affected.push_back(neighbour);
+                }
+            }
+        }
+        for (const unsigned int affected : m_affected) {
+            m_distances[affected] = UNREACHABLE;
+            m_directions[affected] = EDirection::None;
+        }
+        m_heap.clear();
+        for (const unsigned int affected : m_affected) {
+            if (m_grid.costs[affected] == NavigationGrid::IMPASSABLE) {
+                continue;
+            }
+            const unsigned int affectedX = affected % m_grid.width;
+            const unsigned int affectedY = affected / m_grid.width;
+            if (affectedY + 1 < m_grid.height) relax(affected, affected + m_grid.width, EDirection::Top);
+            if (affectedY > 0) relax(affected, affected - m_grid.width, EDirection::Bottom);
+            if (affectedX > 0) relax(affected, affected - 1, EDirection::Left);
+            if (affectedX + 1 < m_grid.width) relax(affected, affected + 1, EDirection::Right);
+        }
+        propagate();
+        return;
+    }
+
+    // Стоимость уменьшилась: расстояния могут только уменьшиться, достаточно улучшить саму
+    // клетку и распространить улучшение дальше.
+    m_heap.clear();
+    if (y + 1 < m_grid.height) relax(cell, cell + m_grid.width, EDirection::Top);
+    if (y > 0) relax(cell, cell - m_grid.width, EDirection::Bottom);
+    if (x > 0) relax(cell, cell - 1, EDirection::Left);
+    if (x + 1 < m_grid.width) relax(cell, cell + 1, EDirection::Right);
+    propagate();
+}
+
+void FlowField::push(const unsigned int index) {
+    m_heap.push_back({ m_distances[index], index });
+    std::push_heap(m_heap.begin(), m_heap.end(), nodeCompare);
+}
+
+void FlowField::propagate() {
+    while (! m_heap.empty()) {
+        std::pop_heap(m_heap.begin(), m_heap.end(), nodeCompare);
+        const Node node = m_heap.back();
+        m_heap.pop_back();
+        if (node.distance != m_distances[node.index]) {
+            // Устаревшая запись, клетка уже улучшена позже.
+            continue;
+        }
+        const unsigned int x = node.index % m_grid.width;
+        const unsigned int y = node.index / m_grid.width;
+        // Соседу, лежащему сверху, нужно ехать вниз, чтобы попасть в текущую клетку.
+        if (y + 1 < m_grid.height) relax(node.index + m_grid.width, node.index, EDirection::Bottom);
+        if (y > 0) relax(node.index - m_grid.width, node.index, EDirection::Top);
+        if (x > 0) relax(node.index - 1, node.index, EDirection::Right);
+        if (x + 1 < m_grid.width) relax(node.index + 1, node.index, EDirection::Left);
+    }
+}
+
+void FlowField::relax(const unsigned int index, const unsigned int neighbour, const EDirection direction) {
+    const uint8_t cost = m_grid.costs[index];
+    if (cost == NavigationGrid::IMPASSABLE || m_distances[neighbour] == UNREACHABLE ||
+        index == m_grid.index(m_targetX, m_targetY)) {
+        return;
+    }
+    const uint32_t distance = m_distances[neighbour] + cost;
+    if (distance < m_distances[index]) {
+        m_distances[index] = distance;
+        m_directions[index] = direction;
+        push(index);
+    }
+}
+
+unsigned int FlowField::getParent(const unsigned int index) const noexcept {
+    switch (m_directions[index]) {
+        case EDirection::Top:
+            return index + m_grid.width;
+        case EDirection::Bottom:
+            return index - m_grid.width;
+        case EDirection::Left:
+            return index - 1;
+        case EDirection::Right:
+            return index + 1;
+        default:
+            return UINT_MAX;
+    }
+}
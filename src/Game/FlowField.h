@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Сетка проходимости уровня. Стоимость клетки - цена въезда в нее, 0 означает, что клетка
+ * непроходима. Нулевая строка сетки - нижняя строка уровня.
+ * */
+struct NavigationGrid {
+    static constexpr uint8_t IMPASSABLE = 0;
+
+    unsigned int width = 0;
+    unsigned int height = 0;
+    std::vector<uint8_t> costs;
+
+    NavigationGrid() = default;
+    NavigationGrid(unsigned int _width, unsigned int _height, uint8_t cost = 1) :
+        width(_width), height(_height), costs(static_cast<size_t>(_width) * _height, cost) {}
+
+    unsigned int index(unsigned int x, unsigned int y) const noexcept { return y * width + x; }
+    uint8_t getCost(unsigned int x, unsigned int y) const noexcept { return costs[index(x, y)]; }
+};
+
+/**
+ * Поле направлений к одной цели, построенное алгоритмом Дейкстры от цели. Для каждой клетки
+ * хранится расстояние до цели и направление на соседнюю клетку, ближайшую к цели, поэтому
+ * танк узнает направление движения за O(1). При изменении стоимости одной клетки поле
+ * пересчитывается только в затронутой области. Смена цели только помечает поле устаревшим:
+ * полная перестройка выполняется при первом запросе направления или расстояния, поэтому цель,
+ * которая меняется каждый шаг (клетка танка, в том числе при повторной симуляции после
+ * отката), ничего не стоит, пока поле никто не читает.
+ * */
+class FlowField {
+public:
+    enum class EDirection : uint8_t {
+        None,
+        Top,
+        Bottom,
+        Left,
+        Right
+    };
+
+    static constexpr uint32_t UNREACHABLE = UINT32_MAX;
+
+    FlowField() = delete;
+    /**
+     * @param grid сетка проходимости. Сетка должна жить дольше поля, ее размер не должен
+     * меняться.
+     * */
+    explicit FlowField(const NavigationGrid& grid);
+
+    /**
+     * Метод задает клетку-цель. Если цель изменилась, поле будет полностью перестроено при
+     * следующем запросе.
+     * */
+    void setTarget(unsigned int x, unsigned int y) noexcept;
+    /**
+     * Метод полностью перестраивает поле.
+     * */
+    void rebuild();
+    /**
+     * Метод перестраивает поле, если цель менялась после последнего построения.
+     * */
+    void update() {
+        if (m_dirty) {
+            rebuild();
+        }
+    }
+    bool isDirty() const noexcept { return m_dirty; }
+    /**
+     * Метод обновляет поле после изменения стоимости клетки в сетке.
+     * @param oldCost стоимость клетки до изменения.
+     * */
+    void onCellChanged(unsigned int x, unsigned int y, uint8_t oldCost);
+
+    EDirection getDirection(unsigned int x, unsigned int y) {
+        update();
+        return m_directions[m_grid.index(x, y)];
+    }
+    uint32_t getDistance(unsigned int x, unsigned int y) {
+        update();
+        return m_distances[m_grid.index(x, y)];
+    }
+    unsigned int getTargetX() const noexcept { return m_targetX; }
+    unsigned int getTargetY() const noexcept { return m_targetY; }
+
+private:
+    struct Node {
+        uint32_t distance;
+        unsigned int index;
+    };
+
+    void push(unsigned int index);
+    /**
+     * Метод распространяет расстояния из клеток, находящихся в очереди.
+     * */
+    void propagate();
+    /**
+     * Метод пытается улучшить расстояние клетки index через соседа neighbour.
+     * */
+    void relax(unsigned int index, unsigned int neighbour, EDirection direction);
+    /**
+     * Метод возвращает индекс клетки, на которую указывает направление клетки index.
+     * */
+    unsigned int getParent(unsigned int index) const noexcept;
+
+private:
+    const NavigationGrid& m_grid;
+    unsigned int m_targetX;
+    unsigned int m_targetY;
+    // Цель изменилась, а поле еще не перестроено.
+    bool m_dirty;
+    std::vector<uint32_t> m_distances;
+    std::vector<EDirection> m_directions;
+    // Рабочие массивы хранятся между вызовами, чтобы обновления не выделяли память.
+    std::vector<Node> m_heap;
+    std::vector<unsigned int> m_affected;
+};
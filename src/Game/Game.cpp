@@ -1,76 +1,454 @@
 #include "Game.h"
 
 #include <iostream>
+#include <algorithm>
+#include <string>
 
 #include "../Renderer/ShaderProgram.h"
 #include "../ResourceManager/ResourceManager.h"
+#include "../Renderer/Palette.h"
 #include "../Renderer/Texture2D.h"
 #include "../Renderer/Sprite.h"
 #include "../Renderer/AnimatedSprite.h"
+#include "../Renderer/PacketRenderer.h"
+#include "../Renderer/DebugOverlay.h"
+#include "../Renderer/ScaledRenderTarget.h"
+#include "../Renderer/Renderer.h"
 
 #include <GLFW/glfw3.h>
-#include <glm/mat4x4.hpp>
-#include <glm/gtc/matrix_transform.hpp>
 
 #include "Tank.h"
+#include "BulletPool.h"
+#include "Level.h"
+#include "Pathfinder.h"
+#include "Terrain.h"
+#include "TerrainRenderer.h"
+#include "Replay.h"
+#include "GameSnapshot.h"
+#include "../Exception/Exception.h"
+#include "../Utils/Hash.h"
+#include "../Profiler/Profiler.h"
+#include "../Profiler/AllocationCounter.h"
 
 Game::Game(const glm::vec2& windowSize) noexcept :
            m_eCurrentGameState(EGameState::Active) ,
            m_windowSize(windowSize) {
     m_keys.fill(false);
+    m_pressedKeys.fill(false);
 }
 
+static_assert(GLFW_KEY_LAST + 1 == 349, "Game::KEYS_COUNT must match GLFW_KEY_LAST");
+static_assert(GLFW_KEY_F3 == 292, "Game::DEBUG_OVERLAY_KEY must match GLFW_KEY_F3");
+static_assert(GLFW_KEY_P == 80, "Game::PAUSE_KEY must match GLFW_KEY_P");
+static_assert(GameSnapshot::KEYS_COUNT == GLFW_KEY_LAST + 1, "GameSnapshot::KEYS_COUNT must match GLFW_KEY_LAST");
+
 Game::~Game() {}
 
+namespace {
+    // Емкость одного вызова отрисовки пакета кадра: все снаряды и танки с запасом.
+    constexpr unsigned int PACKET_BATCH_CAPACITY = 128;
+
+    // Окраска танков игроков: строки палитры атласа танков.
+    constexpr const char* PLAYER_PALETTE_ROWS[Game::PLAYERS_COUNT] = { "yellow", "green" };
+
+    void addSprite(RenderEngine::RenderPacket& packet, const RenderEngine::Sprite& sprite, const uint8_t paletteRow = 0) {
+        packet.addSprite(sprite.getTexture(), sprite.getSubTexture(), sprite.getPosition(), sprite.getSize(),
+                         paletteRow);
+    }
+}
+
 void Game::render() {
-    ResourceManager::getAnimatedSprite("NewAnimatedSprite")->render();
-    if (m_pTank) {
-        m_pTank->render();
-    }
-}
-
-void Game::update(uint64_t delta) {
-    ResourceManager::getAnimatedSprite("NewAnimatedSprite")->update(delta);
-    if (m_pTank) {
-        if (m_keys[GLFW_KEY_W]) {
-            m_pTank->setOrientation(Tank::EOrientation::Top);
-            m_pTank->move(true);
-        } else if (m_keys[GLFW_KEY_A]) {
-            m_pTank->setOrientation(Tank::EOrientation::Left);
-            m_pTank->move(true);
-        } else if (m_keys[GLFW_KEY_S]) {
-            m_pTank->setOrientation(Tank::EOrientation::Bottom);
-            m_pTank->move(true);
-        } else if (m_keys[GLFW_KEY_D]) {
-            m_pTank->setOrientation(Tank::EOrientation::Right);
-            m_pTank->move(true);
+    PROFILE_SCOPE("Game::render");
+    ALLOCATION_TAG(Render);
+    fillRenderPacket(m_renderPacket);
+    render(m_renderPacket);
+}
+
+void Game::fillRenderPacket(RenderEngine::RenderPacket& packet) const {
+    PROFILE_SCOPE("Game::fillRenderPacket");
+    ALLOCATION_TAG(Render);
+    packet.clear();
+    packet.tick = m_tickCount;
+    packet.cameraPosition = glm::vec2(0.f);
+    packet.cameraSize = glm::vec2(m_windowSize);
+    packet.showDebugOverlay = m_debugOverlayVisible.load(std::memory_order_relaxed);
+    packet.beginPass("map");
+    if (const RenderEngine::AnimatedSprite* pDecorationSprite = m_spriteInstances.get(m_decorationSprite)) {
+        addSprite(packet, *pDecorationSprite);
+    }
+    packet.beginPass("tanks");
+    for (const auto& pTank : m_pTanks) {
+        if (pTank) {
+            addSprite(packet, pTank->getSprite(), pTank->getPaletteRow());
+        }
+    }
+    packet.beginPass("effects");
+    if (m_pBulletPool) {
+        m_pBulletPool->appendSprites(packet);
+    }
+    if (m_pTerrain) {
+        packet.terrainRevision = m_terrainRevision;
+        packet.firstTerrainRevision = m_terrainRevision - m_wallMaskChanges.size();
+        if (m_renderedTerrainRevision.load(std::memory_order_acquire) < packet.firstTerrainRevision) {
+            // Журнал уже не содержит всех изменений, которых не видела отрисовка.
+            packet.firstTerrainRevision = m_terrainRevision;
+            packet.wallMasks.resize(m_pTerrain->width() * m_pTerrain->height());
+            m_pTerrain->saveWallMasks(packet.wallMasks.data());
         } else {
-            m_pTank->move(false);
+            packet.wallMaskChanges.assign(m_wallMaskChanges.begin(), m_wallMaskChanges.end());
+        }
+        packet.eagleDestroyed = m_pTerrain->isEagleDestroyed();
+    }
+}
+
+void Game::render(const RenderEngine::RenderPacket& packet) {
+    PROFILE_SCOPE("Game::renderPacket");
+    ALLOCATION_TAG(Render);
+    RenderEngine::Renderer::resetFrameStats();
+    RenderEngine::Renderer::beginGpuFrame();
+    if (m_pScaledRenderTarget) {
+        m_pScaledRenderTarget->begin();
+    }
+    {
+        PROFILE_GPU_PASS("clear");
+        RenderEngine::Renderer::clear();
+    }
+    if (m_pPacketRenderer) {
+        m_pPacketRenderer->setCamera(packet);
+        if (m_pTerrainRenderer) {
+            PROFILE_GPU_PASS("map");
+            if (packet.wallMasks.size() == m_pTerrainRenderer->cellsCount()) {
+                m_pTerrainRenderer->sync(packet.wallMasks.data(), packet.eagleDestroyed, packet.terrainRevision);
+            } else {
+                m_pTerrainRenderer->applyChanges(packet.wallMaskChanges.data(), packet.wallMaskChanges.size(),
+                                                 packet.firstTerrainRevision, packet.eagleDestroyed);
+            }
+            m_renderedTerrainRevision.store(m_pTerrainRenderer->getRevision(), std::memory_order_release);
+            m_pTerrainRenderer->render();
+        }
+        m_pPacketRenderer->drawSprites(packet);
+    }
+    if (m_pScaledRenderTarget) {
+        PROFILE_GPU_PASS("upscale");
+        m_pScaledRenderTarget->present();
+    }
+    // Выделения кадра, как и счетчики OpenGL, снимаются до отрисовки оверлея.
+    AllocationCounter::endFrame();
+    if (m_pDebugOverlay) {
+        // Счетчики берутся до отрисовки оверлея, чтобы он показывал только работу игры.
+        m_pDebugOverlay->addFrame(RenderEngine::Renderer::getFrameStats());
+        if (packet.showDebugOverlay) {
+            PROFILE_GPU_PASS("ui");
+            m_pDebugOverlay->render(packet.cameraSize);
         }
-        m_pTank->update(delta);
     }
+    RenderEngine::Renderer::endGpuFrame();
+    ResourceManager::updateTextures();
+}
+
+void Game::pollHotReload() {
+    if (ResourceManager::pollHotReload()) {
+        resolveSubTextures();
+    }
+}
+
+void Game::resolveSubTextures() {
+    m_spriteInstances.forEach([](RenderEngine::AnimatedSprite& sprite) { sprite.resolveSubTexture(); });
+    if (m_pBulletPool) {
+        m_pBulletPool->resolveSubTextures();
+    }
+    if (m_pTerrainRenderer) {
+        m_pTerrainRenderer->resolveSubTextures();
+    }
+}
+
+void Game::update(const uint64_t delta) {
+    PROFILE_SCOPE("Game::update");
+    ALLOCATION_TAG(Game);
+    if (isPaused()) {
+        m_tickAccumulator = 0;
+        return;
+    }
+    m_tickAccumulator += delta;
+    // После долгой остановки (перетаскивание окна, отладчик) не пытаемся догнать все шаги.
+    if (m_tickAccumulator > MAX_TICKS_PER_UPDATE * TICK_DURATION) {
+        m_tickAccumulator = MAX_TICKS_PER_UPDATE * TICK_DURATION;
+    }
+    while (m_tickAccumulator >= TICK_DURATION) {
+        m_tickAccumulator -= TICK_DURATION;
+        tick();
+    }
+}
+
+void Game::tick() {
+    PlayerInputs inputs{};
+    inputs[0] = pollLocalInput();
+    simulateTick(inputs);
+}
+
+uint8_t Game::pollLocalInput() noexcept {
+    processInput();
+    uint8_t input = 0;
+    if (isKeyActive(GLFW_KEY_W)) input |= Up;
+    if (isKeyActive(GLFW_KEY_S)) input |= Down;
+    if (isKeyActive(GLFW_KEY_A)) input |= Left;
+    if (isKeyActive(GLFW_KEY_D)) input |= Right;
+    if (m_pressedKeys[GLFW_KEY_SPACE]) input |= Fire;
+    return input;
+}
+
+void Game::simulateTick(const PlayerInputs& inputs) {
+    PROFILE_SCOPE("Game::simulateTick");
+    ALLOCATION_TAG(Game);
+    if (RenderEngine::AnimatedSprite* pDecorationSprite = m_spriteInstances.get(m_decorationSprite)) {
+        pDecorationSprite->update(TICK_DURATION);
+    }
+    for (unsigned int player = 0; player < PLAYERS_COUNT; ++player) {
+        Tank* pTank = m_pTanks[player].get();
+        if (! pTank) {
+            continue;
+        }
+        updateTank(*pTank, inputs[player]);
+        if (m_pBulletPool && (inputs[player] & Fire)) {
+            m_pBulletPool->spawn(pTank->getBarrelPosition(), pTank->getOrientation(), BULLET_VELOCITY);
+        }
+    }
+    updatePlayerPathTargets();
+    if (m_pBulletPool) {
+        m_pBulletPool->update(TICK_DURATION, m_windowSize, [this](const BulletPool::Bullet& bullet) {
+            return m_pTerrain && m_pTerrain->hit(bullet.position, bullet.eOrientation);
+        });
+    }
+    ++m_tickCount;
+    if (m_pReplayRecorder && m_tickCount % STATE_HASH_INTERVAL == 0) {
+        m_pReplayRecorder->recordStateHash(m_tickCount, getStateHash());
+    }
+}
+
+void Game::updateTank(Tank& tank, const uint8_t input) noexcept {
+    // При нескольких нажатых направлениях действует первое в порядке: вверх, влево, вниз, вправо.
+    if (input & Up) {
+        tank.setOrientation(Tank::EOrientation::Top);
+        tank.move(true);
+    } else if (input & Left) {
+        tank.setOrientation(Tank::EOrientation::Left);
+        tank.move(true);
+    } else if (input & Down) {
+        tank.setOrientation(Tank::EOrientation::Bottom);
+        tank.move(true);
+    } else if (input & Right) {
+        tank.setOrientation(Tank::EOrientation::Right);
+        tank.move(true);
+    } else {
+        tank.move(false);
+    }
+    tank.update(TICK_DURATION);
+}
+
+void Game::updatePlayerPathTargets() {
+    if (! m_pPathfinder) {
+        return;
+    }
+    for (unsigned int player = 0; player < PLAYERS_COUNT; ++player) {
+        if (m_pTanks[player]) {
+            const glm::uvec2 tankCell = m_pLevel->getCellAt(m_pTanks[player]->getCenter());
+            m_pPathfinder->setTarget(EPathTarget::Player + player, tankCell.x, tankCell.y);
+        }
+    }
+}
+
+void Game::processInput() noexcept {
+    // Все события, накопившиеся к началу шага, применяются в нем в порядке поступления, даже если
+    // за один update() выполняется несколько шагов: последующие шаги получают только новые события.
+    m_pressedKeys.fill(false);
+    InputEvent event;
+    while (m_inputQueue.pop(event)) {
+        if (m_pReplayRecorder) {
+            m_pReplayRecorder->recordInput(m_tickCount, event);
+        }
+        applyInputEvent(event);
+    }
+}
+
+void Game::applyInputEvent(const InputEvent& event) noexcept {
+    m_keys[event.key] = event.action != GLFW_RELEASE;
+    if (event.action == GLFW_PRESS) {
+        m_pressedKeys[event.key] = true;
+    }
+}
+
+bool Game::isKeyActive(const int key) const noexcept {
+    // Клавиша, нажатая и отпущенная за один шаг, все равно действует в этом шаге.
+    return m_keys[key] || m_pressedKeys[key];
 }
 
 void Game::setKey(const int key, const int action) noexcept {
-    m_keys[key] = action;
+    // GLFW передает GLFW_KEY_UNKNOWN (-1) для клавиш без кода.
+    if (key < 0 || key >= static_cast<int>(m_keys.size()) || action == GLFW_REPEAT) {
+        return;
+    }
+    if (key == DEBUG_OVERLAY_KEY) {
+        if (action == GLFW_PRESS) {
+            m_debugOverlayVisible.store(! m_debugOverlayVisible.load(std::memory_order_relaxed),
+                                        std::memory_order_relaxed);
+        }
+        return;
+    }
+    if (key == PAUSE_KEY) {
+        if (action == GLFW_PRESS) {
+            m_eCurrentGameState.store(isPaused() ? EGameState::Active : EGameState::Pause,
+                                      std::memory_order_relaxed);
+        }
+        return;
+    }
+    pushInputEvent({ static_cast<int16_t>(key), static_cast<uint8_t>(action) });
+}
+
+void Game::pushInputEvent(const InputEvent& event) noexcept {
+    if (event.key < 0 || event.key >= static_cast<int>(m_keys.size())) {
+        return;
+    }
+    m_inputQueue.push(event);
+}
+
+void Game::setPlayersCount(const unsigned int playersCount) noexcept {
+    m_playersCount = std::min(std::max(playersCount, 1u), PLAYERS_COUNT);
+}
+
+void Game::setSeed(const uint64_t seed) noexcept {
+    m_seed = seed;
+    m_random.setSeed(seed);
+}
+
+uint64_t Game::getStateHash() const noexcept {
+    Utils::Fnv1a hash;
+    hash.add(m_tickCount);
+    hash.add(m_random.getState());
+    for (const auto& pTank : m_pTanks) {
+        if (pTank) {
+            hash.add(pTank->getPosition());
+            hash.add(pTank->getOrientation());
+        }
+    }
+    if (m_pBulletPool) {
+        for (unsigned int i = 0; i < m_pBulletPool->size(); ++i) {
+            const BulletPool::Bullet& bullet = m_pBulletPool->getBullet(i);
+            hash.add(bullet.position);
+            hash.add(bullet.eOrientation);
+        }
+    }
+    if (m_pTerrain) {
+        for (unsigned int y = 0; y < m_pTerrain->height(); ++y) {
+            for (unsigned int x = 0; x < m_pTerrain->width(); ++x) {
+                hash.add(m_pTerrain->getWallMask(x, y));
+            }
+        }
+    }
+    return hash.value();
+}
+
+void Game::prepareSnapshot(GameSnapshot& snapshot) const {
+    snapshot.wallMasks.resize(m_pTerrain ? static_cast<size_t>(m_pTerrain->width()) * m_pTerrain->height() : 0);
+}
+
+void Game::saveSnapshot(GameSnapshot& snapshot) const {
+    static_assert(BULLET_POOL_CAPACITY <= GameSnapshot::MAX_BULLETS, "GameSnapshot can't hold all bullets");
+    static_assert(PLAYERS_COUNT <= GameSnapshot::MAX_TANKS, "GameSnapshot can't hold all tanks");
+
+    snapshot.tickCount = m_tickCount;
+    snapshot.randomState = m_random.getState();
+    std::copy(m_keys.begin(), m_keys.end(), snapshot.keys.begin());
+
+    snapshot.tanksCount = 0;
+    for (const auto& pTank : m_pTanks) {
+        if (pTank) {
+            snapshot.tanks[snapshot.tanksCount++] = pTank->getState();
+        }
+    }
+    if (const RenderEngine::AnimatedSprite* pDecorationSprite = m_spriteInstances.get(m_decorationSprite)) {
+        snapshot.decorationAnimation = pDecorationSprite->getAnimationState();
+    }
+
+    snapshot.bulletsCount = 0;
+    if (m_pBulletPool) {
+        snapshot.bulletsCount = m_pBulletPool->size();
+        std::copy(m_pBulletPool->data(), m_pBulletPool->data() + snapshot.bulletsCount, snapshot.bullets.begin());
+    }
+
+    prepareSnapshot(snapshot);
+    snapshot.terrainWidth = 0;
+    snapshot.terrainHeight = 0;
+    snapshot.eagleDestroyed = false;
+    if (m_pTerrain) {
+        snapshot.terrainWidth = m_pTerrain->width();
+        snapshot.terrainHeight = m_pTerrain->height();
+        snapshot.eagleDestroyed = m_pTerrain->isEagleDestroyed();
+        m_pTerrain->saveWallMasks(snapshot.wallMasks.data());
+    }
+}
+
+void Game::restoreSnapshot(const GameSnapshot& snapshot) {
+    const unsigned int terrainWidth = m_pTerrain ? m_pTerrain->width() : 0;
+    const unsigned int terrainHeight = m_pTerrain ? m_pTerrain->height() : 0;
+    if (snapshot.terrainWidth != terrainWidth || snapshot.terrainHeight != terrainHeight) {
+        throw Exception::Exception("Snapshot terrain size " + std::to_string(snapshot.terrainWidth) + "x" +
+                                   std::to_string(snapshot.terrainHeight) + " doesn't match the level");
+    }
+
+    m_tickCount = snapshot.tickCount;
+    m_random.setState(snapshot.randomState);
+    std::copy(snapshot.keys.begin(), snapshot.keys.end(), m_keys.begin());
+    m_pressedKeys.fill(false);
+
+    unsigned int tankIndex = 0;
+    for (const auto& pTank : m_pTanks) {
+        if (pTank && tankIndex < snapshot.tanksCount) {
+            pTank->setState(snapshot.tanks[tankIndex++]);
+        }
+    }
+    updatePlayerPathTargets();
+    if (RenderEngine::AnimatedSprite* pDecorationSprite = m_spriteInstances.get(m_decorationSprite)) {
+        pDecorationSprite->setAnimationState(snapshot.decorationAnimation);
+    }
+
+    if (m_pBulletPool) {
+        m_pBulletPool->assign(snapshot.bullets.data(), snapshot.bulletsCount);
+    }
+    if (m_pTerrain) {
+        m_pTerrain->restoreWallMasks(snapshot.wallMasks.data(), snapshot.eagleDestroyed);
+    }
 }
 
 void Game::init() {
     ResourceManager::loadJSONResources("res/resources.json");
+    // В ленивом режиме ресурсы первого уровня загружаются сразу, а не при первом обращении.
+    const auto& levelsPrefetch = ResourceManager::getLevelsPrefetch();
+    if (! levelsPrefetch.empty()) {
+        ResourceManager::prefetchResources(levelsPrefetch.front());
+    }
 
-    auto pSpriteShaderProgram = ResourceManager::getShaderProgram("spriteShader");
+    const auto spriteShaderProgram = ResourceManager::getShaderProgramHandle("spriteShader");
+    auto pSpriteShaderProgram = ResourceManager::getShaderProgram(spriteShaderProgram);
     if (! pSpriteShaderProgram) {
         std::cerr << "Can't find shader program: spriteShader" << std::endl;
         return;
     }
 
-    auto pTextureAtlas = ResourceManager::getTexture("mapTextureAtlas");
-    if (! pTextureAtlas) {
+    const auto indexedSpriteShaderProgram = ResourceManager::getShaderProgramHandle("indexedSpriteShader");
+    auto pIndexedSpriteShaderProgram = ResourceManager::getShaderProgram(indexedSpriteShaderProgram);
+    if (! pIndexedSpriteShaderProgram) {
+        std::cerr << "Can't find shader program: indexedSpriteShader" << std::endl;
+        return;
+    }
+
+    const auto textureAtlas = ResourceManager::getTextureHandle("mapTextureAtlas");
+    if (! ResourceManager::getTexture(textureAtlas)) {
         std::cerr << "Can't find texture atlas: mapTextureAtlas" << std::endl;
         return;
     }
 
-    auto pTanksTextureAtlas = ResourceManager::getTexture("tanksTextureAtlas");
+    const auto tanksTextureAtlas = ResourceManager::getTextureHandle("tanksTextureAtlas");
+    auto pTanksTextureAtlas = ResourceManager::getTexture(tanksTextureAtlas);
     if (! pTanksTextureAtlas) {
         std::cerr << "Can't find texture atlas: tanksTextureAtlas" << std::endl;
         return;
@@ -104,15 +482,27 @@ void Game::init() {
 
     pAnimatedSprite->setState("waterState");
 
-    glm::mat4 projectionMatrix = glm::ortho(0.f, static_cast<float>(m_windowSize.x),
-                                            0.f, static_cast<float>(m_windowSize.y),
-                                            -100.f, 100.f);
-
+    // Матрица проекции задается камерой каждого пакета кадра в PacketRenderer::setCamera().
     pSpriteShaderProgram->use();
     pSpriteShaderProgram->setUniform("tex", 0);
-    pSpriteShaderProgram->setUniform("projectionMat", projectionMatrix);
+    pIndexedSpriteShaderProgram->use();
+    pIndexedSpriteShaderProgram->setUniform("tex", 0);
+    pIndexedSpriteShaderProgram->setUniform("palette", static_cast<GLint>(RenderEngine::Palette::TEXTURE_UNIT));
+
+    m_pPacketRenderer = std::make_unique<RenderEngine::PacketRenderer>(spriteShaderProgram, PACKET_BATCH_CAPACITY);
+    m_pPacketRenderer->addTexture(textureAtlas);
+    m_pPacketRenderer->addTexture(tanksTextureAtlas,
+                                  pTanksTextureAtlas->isIndexed() ? indexedSpriteShaderProgram
+                                                                  : RenderEngine::ShaderProgramHandle());
+    m_pDebugOverlay = std::make_unique<RenderEngine::DebugOverlay>(spriteShaderProgram);
+    if (m_internalResolution.x > 0 && m_internalResolution.y > 0) {
+        m_pScaledRenderTarget = std::make_unique<RenderEngine::ScaledRenderTarget>(
+                m_internalResolution.x, m_internalResolution.y, spriteShaderProgram);
+    }
 
     pAnimatedSprite->setState("waterState");
+    m_spriteInstances.destroy(m_decorationSprite);
+    m_decorationSprite = m_spriteInstances.insert(pAnimatedSprite->clone());
 
     auto pTanksAnimatedSprite = ResourceManager::getAnimatedSprite("tankAnimatedSprite");
     if (! pTanksAnimatedSprite) {
@@ -120,5 +510,49 @@ void Game::init() {
         return;
     }
 
-    m_pTank = std::make_unique<Tank>(pTanksAnimatedSprite, 0.0000001f, glm::vec2(100, 100));
+    // Каждый танк анимируется отдельно, поэтому получает свою копию спрайта.
+    for (unsigned int player = 0; player < m_playersCount; ++player) {
+        m_pTanks[player] = std::make_unique<Tank>(m_spriteInstances,
+                                                  m_spriteInstances.insert(pTanksAnimatedSprite->clone()),
+                                                  0.0000001f, PLAYER_START_POSITIONS[player]);
+        const auto& pPalette = pTanksTextureAtlas->getPalette();
+        const int paletteRow = pPalette ? pPalette->findRow(PLAYER_PALETTE_ROWS[player]) : -1;
+        if (paletteRow >= 0) {
+            m_pTanks[player]->setPaletteRow(static_cast<uint8_t>(paletteRow));
+        }
+    }
+
+    const auto& levels = ResourceManager::getLevels();
+    if (! m_levelDescription.empty() || ! levels.empty()) {
+        m_pLevel = std::make_unique<Level>(m_levelDescription.empty() ? levels.front() : m_levelDescription);
+        m_pTerrain = std::make_unique<Terrain>(*m_pLevel);
+        m_pTerrainRenderer = std::make_unique<TerrainRenderer>(*m_pTerrain, textureAtlas, spriteShaderProgram);
+        m_pPathfinder = std::make_unique<Pathfinder>(m_pTerrain->buildNavigationGrid(),
+                                                     EPathTarget::PathTargetsCount);
+        const glm::uvec2 eagleCell = m_pLevel->getEagleCell();
+        m_pPathfinder->setTarget(EPathTarget::Eagle, eagleCell.x, eagleCell.y);
+
+        // Новый TerrainRenderer показывает карту в ревизии 0.
+        m_wallMaskChanges.clear();
+        m_wallMaskChanges.reserve(MAX_WALL_MASK_CHANGES);
+        m_terrainRevision = 0;
+        m_renderedTerrainRevision.store(0, std::memory_order_relaxed);
+
+        // Попадание меняет одну клетку: обновляем только ее поля направлений и запоминаем ее для
+        // следующего пакета кадра.
+        m_pTerrain->addCellChangedListener([this](const unsigned int x, const unsigned int y) {
+            m_pPathfinder->setCellCost(x, y, m_pTerrain->getNavigationCost(x, y));
+            // Журнал очищается, когда отрисовка получила все изменения. При переполнении
+            // следующий пакет передает маски всей карты.
+            if (m_renderedTerrainRevision.load(std::memory_order_acquire) >= m_terrainRevision
+                || m_wallMaskChanges.size() == MAX_WALL_MASK_CHANGES) {
+                m_wallMaskChanges.clear();
+            }
+            m_wallMaskChanges.push_back({ y * m_pTerrain->width() + x, m_pTerrain->getWallMask(x, y) });
+            ++m_terrainRevision;
+        });
+    }
+
+    m_pBulletPool = std::make_unique<BulletPool>(BULLET_POOL_CAPACITY,
+                                                 textureAtlas, glm::vec2(25, 25));
 }
\ No newline at end of file
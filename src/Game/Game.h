@@ -1,29 +1,258 @@
 #pragma once
 
 #include <array>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
 #include <glm/vec2.hpp>
 
+#include "InputQueue.h"
+#include "Random.h"
+#include "../Renderer/RenderPacket.h"
+#include "../Utils/HandlePool.h"
+
 class Tank;
+class BulletPool;
+class Level;
+class Pathfinder;
+class Terrain;
+class TerrainRenderer;
+class ReplayRecorder;
+struct GameSnapshot;
+
+namespace RenderEngine {
+    class AnimatedSprite;
+    class DebugOverlay;
+    class PacketRenderer;
+    class ScaledRenderTarget;
+}
 
 class Game {
 public:
     Game(const glm::vec2& windowSize) noexcept;
     ~Game();
 
+    // Длительность шага симуляции в наносекундах (60 шагов в секунду).
+    static constexpr uint64_t TICK_DURATION = 1000000000 / 60;
+    static constexpr unsigned int PLAYERS_COUNT = 2;
+
+    // Кнопки игрока, упакованные в битовую маску. В сетевой игре передаются только эти маски.
+    enum EInputButton : uint8_t {
+        Up = 1 << 0,
+        Down = 1 << 1,
+        Left = 1 << 2,
+        Right = 1 << 3,
+        // Выстрел действует только в шаге, в котором кнопка нажата.
+        Fire = 1 << 4
+    };
+    using PlayerInputs = std::array<uint8_t, PLAYERS_COUNT>;
+
+    /**
+     * Метод рисует текущее состояние: заполняет пакет кадра и сразу рисует его.
+     * */
     void render();
+    /**
+     * Метод описывает текущее состояние симуляции пакетом кадра. Не обращается к OpenGL и
+     * после первых кадров не выделяет память, поэтому вызывается в потоке симуляции.
+     * */
+    void fillRenderPacket(RenderEngine::RenderPacket& packet) const;
+    /**
+     * Метод очищает кадр и рисует пакет. Вызывается только в потоке, владеющем контекстом
+     * OpenGL, и не читает состояние симуляции.
+     * */
+    void render(const RenderEngine::RenderPacket& packet);
+    /**
+     * Метод применяет горячую перезагрузку ресурсов и после перезагрузки атласов заново находит
+     * области спрайтов, снарядов и карты. Меняет и объекты OpenGL, и состояние симуляции, поэтому
+     * вызывается между шагами симуляции с текущим контекстом OpenGL (с потоком отрисовки - через
+     * RenderThread::runTask()). Сцена использует копии анимированных спрайтов, поэтому измененные
+     * в файле ресурсов состояния анимации появятся только после следующего init().
+     * */
+    void pollHotReload();
+    /**
+     * Метод продвигает симуляцию на delta наносекунд. Симуляция выполняется шагами
+     * фиксированной длины TICK_DURATION, остаток переносится на следующий вызов.
+     * */
     void update(uint64_t delta);
+    /**
+     * Метод применяет накопленные события клавиатуры и возвращает маску EInputButton
+     * локального игрока для следующего шага. Вызывается один раз перед каждым шагом.
+     * */
+    uint8_t pollLocalInput() noexcept;
+    /**
+     * Метод выполняет один шаг симуляции с заданными масками кнопок игроков. Используется
+     * сетевой игрой, которая сама решает, какие маски подать (в том числе при откате).
+     * */
+    void simulateTick(const PlayerInputs& inputs);
+    /**
+     * Метод ставит событие клавиатуры в очередь ввода. Может вызываться из другого потока,
+     * чем update(). События с неизвестным кодом клавиши отбрасываются. DEBUG_OVERLAY_KEY
+     * и PAUSE_KEY не попадают в симуляцию и переключают отладочный оверлей и паузу.
+     * */
     void setKey(int key, int action) noexcept;
+    /**
+     * Метод ставит готовое событие в очередь ввода (используется при воспроизведении повтора).
+     * */
+    void pushInputEvent(const InputEvent& event) noexcept;
     void init();
+    /**
+     * Метод задает количество танков игроков (1 или 2). Вызывается до init().
+     * */
+    void setPlayersCount(unsigned int playersCount) noexcept;
+    unsigned int getPlayersCount() const noexcept { return m_playersCount; }
+
+    /**
+     * Метод задает начальное число генератора случайных чисел. Вызывается до init().
+     * */
+    void setSeed(uint64_t seed) noexcept;
+    uint64_t getSeed() const noexcept { return m_seed; }
+    /**
+     * Метод задает разрешение, в котором рисуется сцена (например, 256x240 как у NES). Кадр
+     * рисуется во внутренний буфер и выводится в текущий буфер кадра с целым масштабом и полями,
+     * поэтому стоимость отрисовки сцены не зависит от размера окна. Отладочный оверлей рисуется
+     * поверх в разрешении окна. Нулевой размер отключает режим. Вызывается до init().
+     * */
+    void setInternalResolution(const glm::uvec2& resolution) noexcept { m_internalResolution = resolution; }
+    /**
+     * Метод задает карту (строки сверху вниз, как в описании уровня) вместо первого уровня
+     * файла ресурсов, например для замеров на картах разного размера. Вызывается до init().
+     * */
+    void setLevelDescription(std::vector<std::string> description) noexcept {
+        m_levelDescription = std::move(description);
+    }
+    /**
+     * Метод подключает запись повтора: каждое применённое событие ввода и хеш состояния каждые
+     * STATE_HASH_INTERVAL шагов будут записаны. nullptr отключает запись.
+     * */
+    void setReplayRecorder(ReplayRecorder* pReplayRecorder) noexcept { m_pReplayRecorder = pReplayRecorder; }
+    /**
+     * Метод возвращает хеш состояния симуляции: номер шага, генератор случайных чисел, танки,
+     * снаряды и разрушения карты.
+     * */
+    uint64_t getStateHash() const noexcept;
+    /**
+     * Метод размечает снимок под текущую карту, чтобы saveSnapshot() не выделял память.
+     * */
+    void prepareSnapshot(GameSnapshot& snapshot) const;
+    /**
+     * Метод сохраняет состояние симуляции в снимок. Не выделяет память, если снимок подготовлен
+     * prepareSnapshot() или уже сохранялся на этой карте.
+     * */
+    void saveSnapshot(GameSnapshot& snapshot) const;
+    /**
+     * Метод восстанавливает состояние симуляции из снимка. Не выделяет память, отрисовка и
+     * поиск пути обновляются только для клеток, разрушения которых отличаются.
+     * @throw Exception, если снимок сделан на карте другого размера.
+     * */
+    void restoreSnapshot(const GameSnapshot& snapshot);
+
+    const BulletPool* getBulletPool() const noexcept { return m_pBulletPool.get(); }
+    BulletPool* getBulletPool() noexcept { return m_pBulletPool.get(); }
+    const Pathfinder* getPathfinder() const noexcept { return m_pPathfinder.get(); }
+    const Terrain* getTerrain() const noexcept { return m_pTerrain.get(); }
+    // Изменения клеток доходят до поиска пути и отрисовки через слушателей Terrain.
+    Terrain* getTerrain() noexcept { return m_pTerrain.get(); }
+    uint64_t getTickCount() const noexcept { return m_tickCount; }
+    /**
+     * В паузе update() не выполняет шагов симуляции. Сетевая игра (simulateTick()) паузу
+     * не учитывает.
+     * */
+    bool isPaused() const noexcept { return m_eCurrentGameState.load(std::memory_order_relaxed) == EGameState::Pause; }
+    /**
+     * Сколько наносекунд осталось накопить update() до следующего шага симуляции.
+     * */
+    uint64_t getTimeToNextTick() const noexcept { return TICK_DURATION - m_tickAccumulator; }
+
+    // Цели поиска пути для ИИ танков.
+    enum EPathTarget : unsigned int {
+        Eagle,
+        // Поле к танку игрока player: Player + player.
+        Player,
+        PathTargetsCount = Player + PLAYERS_COUNT
+    };
 
 private:
-    std::array<bool, 349> m_keys;
+    void tick();
+    void updateTank(Tank& tank, uint8_t input) noexcept;
+    /**
+     * Метод переносит цели полей направлений игроков в клетки их танков.
+     * */
+    void updatePlayerPathTargets();
+    void processInput() noexcept;
+    void applyInputEvent(const InputEvent& event) noexcept;
+    bool isKeyActive(int key) const noexcept;
+    /**
+     * Метод заново находит области атласов спрайтов, снарядов и карты после горячей перезагрузки.
+     * */
+    void resolveSubTextures();
+
+private:
+    // Как часто в повтор записывается хеш состояния.
+    static constexpr uint64_t STATE_HASH_INTERVAL = 60;
+    // GLFW_KEY_LAST + 1
+    static constexpr size_t KEYS_COUNT = 349;
+    // GLFW_KEY_F3
+    static constexpr int DEBUG_OVERLAY_KEY = 292;
+    // GLFW_KEY_P
+    static constexpr int PAUSE_KEY = 80;
+    // Сколько шагов симуляции можно выполнить за один вызов update().
+    static constexpr uint64_t MAX_TICKS_PER_UPDATE = 8;
+    // Емкость пула снарядов. В оригинальной игре на экране одновременно не больше десятка
+    // снарядов, запас нужен для пользовательских режимов.
+    static constexpr unsigned int BULLET_POOL_CAPACITY = 64;
+    // Скорость снаряда в пикселях за наносекунду.
+    static constexpr float BULLET_VELOCITY = 0.0000003f;
+    // Емкость журнала изменений карты. Если отрисовка отстала сильнее (например, после
+    // восстановления снимка), пакет передает маски всей карты.
+    static constexpr size_t MAX_WALL_MASK_CHANGES = 1024;
+    static constexpr glm::vec2 PLAYER_START_POSITIONS[PLAYERS_COUNT] = { glm::vec2(100, 100), glm::vec2(400, 100) };
+
+    // Клавиши, удерживаемые в текущем шаге.
+    std::array<bool, KEYS_COUNT> m_keys;
+    // Клавиши, нажатые в текущем шаге (даже если уже отпущены).
+    std::array<bool, KEYS_COUNT> m_pressedKeys;
+    InputQueue m_inputQueue;
+    uint64_t m_tickAccumulator = 0;
+    uint64_t m_tickCount = 0;
+    uint64_t m_seed = 0;
+    unsigned int m_playersCount = 1;
+    // Карта из setLevelDescription(); пустая - первый уровень файла ресурсов.
+    std::vector<std::string> m_levelDescription;
+    Random m_random;
+    ReplayRecorder* m_pReplayRecorder = nullptr;
 
     enum class EGameState {
         Active,
         Pause
     };
 
-    EGameState m_eCurrentGameState;
+    // Переключается в setKey(), который может вызываться из другого потока.
+    std::atomic<EGameState> m_eCurrentGameState;
     glm::ivec2 m_windowSize;
-    std::unique_ptr<Tank> m_pTank;
+    glm::uvec2 m_internalResolution{ 0 };
+    // Собственные экземпляры спрайтов сцены (копии спрайтов ResourceManager), объявлены раньше
+    // танков, чтобы пережить их.
+    Utils::HandlePool<RenderEngine::AnimatedSprite> m_spriteInstances;
+    Utils::Handle<RenderEngine::AnimatedSprite> m_decorationSprite;
+    std::array<std::unique_ptr<Tank>, PLAYERS_COUNT> m_pTanks;
+    std::unique_ptr<BulletPool> m_pBulletPool;
+    std::unique_ptr<Level> m_pLevel;
+    std::unique_ptr<Terrain> m_pTerrain;
+    std::unique_ptr<TerrainRenderer> m_pTerrainRenderer;
+    std::unique_ptr<RenderEngine::PacketRenderer> m_pPacketRenderer;
+    std::unique_ptr<RenderEngine::DebugOverlay> m_pDebugOverlay;
+    // Сцена во внутреннем разрешении; nullptr, если сцена рисуется сразу в окно.
+    std::unique_ptr<RenderEngine::ScaledRenderTarget> m_pScaledRenderTarget;
+    // Переключается в setKey(), который может вызываться из другого потока.
+    std::atomic<bool> m_debugOverlayVisible{ false };
+    // Пакет кадра для отрисовки в том же потоке, что и симуляция.
+    RenderEngine::RenderPacket m_renderPacket;
+    std::unique_ptr<Pathfinder> m_pPathfinder;
+    // Изменения карты, которые отрисовка еще могла не получить; последнее дает ревизию
+    // m_terrainRevision (см. RenderPacket).
+    std::vector<RenderEngine::RenderPacket::WallMaskChange> m_wallMaskChanges;
+    uint64_t m_terrainRevision = 0;
+    // Ревизия карты, до которой дошла отрисовка; пишется в render(packet), возможно из потока рендера.
+    std::atomic<uint64_t> m_renderedTerrainRevision{ 0 };
 };
\ No newline at end of file
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "Tank.h"
+#include "BulletPool.h"
+#include "../Renderer/AnimatedSprite.h"
+
+/**
+ * Снимок состояния симуляции: шаг, генератор случайных чисел, удерживаемые клавиши, танки,
+ * анимации, снаряды и разрушения карты. Все, кроме масок клеток, имеет фиксированный размер;
+ * маски занимают width * height байт и размечаются под карту один раз (Game::prepareSnapshot()),
+ * поэтому сохранение и восстановление в снимки заранее созданного кольцевого буфера (откат в
+ * сетевой игре) не выделяют память. Производное состояние (вершины отрисовки, поля направлений)
+ * в снимок не входит и пересчитывается при восстановлении только для изменившихся клеток.
+ * */
+struct GameSnapshot {
+    // GLFW_KEY_LAST + 1
+    static constexpr unsigned int KEYS_COUNT = 349;
+    static constexpr unsigned int MAX_TANKS = 2;
+    static constexpr unsigned int MAX_BULLETS = 64;
+
+    uint64_t tickCount;
+    uint64_t randomState;
+    std::array<bool, KEYS_COUNT> keys;
+
+    uint32_t tanksCount;
+    std::array<Tank::State, MAX_TANKS> tanks;
+    // Анимация декоративного спрайта NewAnimatedSprite.
+    RenderEngine::AnimatedSprite::AnimationState decorationAnimation;
+
+    uint32_t bulletsCount;
+    std::array<BulletPool::Bullet, MAX_BULLETS> bullets;
+
+    uint32_t terrainWidth;
+    uint32_t terrainHeight;
+    bool eagleDestroyed;
+    std::vector<uint8_t> wallMasks;
+};
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Событие клавиатуры. Времени события нет: событие относится к тому шагу симуляции, который
+ * извлек его из очереди (Game::processInput()).
+ * */
+struct InputEvent {
+    int16_t key;
+    uint8_t action;
+};
+
+/**
+ * Кольцевой буфер событий ввода без блокировок для одного производителя (обработчики GLFW) и
+ * одного потребителя (шаг симуляции). Производитель и потребитель могут работать в разных
+ * потоках. Порядок событий сохраняется, поэтому нажатие и отпускание внутри одного кадра не
+ * теряются.
+ * */
+class InputQueue {
+public:
+    // Емкость должна быть степенью двойки.
+    static constexpr size_t CAPACITY = 256;
+
+    InputQueue() noexcept : m_head(0), m_tail(0), m_droppedCount(0) {}
+    InputQueue(const InputQueue&) = delete;
+    InputQueue& operator=(const InputQueue&) = delete;
+
+    /**
+     * Метод добавляет событие. Вызывается только потоком-производителем.
+     * @return false, если буфер заполнен. Событие отбрасывается и учитывается в droppedCount().
+     * */
+    bool push(const InputEvent& event) noexcept {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_head.load(std::memory_order_acquire) == CAPACITY) {
+            m_droppedCount.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        m_events[tail & (CAPACITY - 1)] = event;
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Метод извлекает самое старое событие. Вызывается только потоком-потребителем.
+     * @return false, если событий нет.
+     * */
+    bool pop(InputEvent& event) noexcept {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        event = m_events[head & (CAPACITY - 1)];
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    uint64_t droppedCount() const noexcept { return m_droppedCount.load(std::memory_order_relaxed); }
+
+private:
+    static_assert((CAPACITY & (CAPACITY - 1)) == 0, "InputQueue capacity must be a power of two");
+
+    std::array<InputEvent, CAPACITY> m_events;
+    // Индексы растут неограниченно, позиция в массиве - остаток от деления на емкость.
+    // Производитель и потребитель пишут в разные кэш-линии.
+    alignas(64) std::atomic<size_t> m_head;
+    alignas(64) std::atomic<size_t> m_tail;
+    std::atomic<uint64_t> m_droppedCount;
+};
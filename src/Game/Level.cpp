@@ -0,0 +1,112 @@
+#include "Level.h"
+
+#include <algorithm>
+
+#include "../Exception/Exception.h"
+
+namespace {
+    bool parseCell(const char symbol, Level::ECellType& cellType, uint8_t& wallMask) {
+        switch (symbol) {
+            case '0': case '5':
+                wallMask = Level::TopRight | Level::BottomRight;
+                break;
+            case '1': case '6':
+                wallMask = Level::BottomLeft | Level::BottomRight;
+                break;
+            case '2': case '7':
+                wallMask = Level::TopLeft | Level::BottomLeft;
+                break;
+            case '3': case '8':
+                wallMask = Level::TopLeft | Level::TopRight;
+                break;
+            case '4': case '9':
+                wallMask = Level::AllQuarters;
+                break;
+            case 'G': case 'K':
+                wallMask = Level::BottomLeft;
+                break;
+            case 'H': case 'L':
+                wallMask = Level::BottomRight;
+                break;
+            case 'I': case 'M':
+                wallMask = Level::TopLeft;
+                break;
+            case 'J': case 'N':
+                wallMask = Level::TopRight;
+                break;
+            case 'E':
+                wallMask = Level::AllQuarters;
+                break;
+            default:
+                wallMask = 0;
+                break;
+        }
+        switch (symbol) {
+            case '0': case '1': case '2': case '3': case '4':
+            case 'G': case 'H': case 'I': case 'J':
+                cellType = Level::ECellType::Brick;
+                return true;
+            case '5': case '6': case '7': case '8': case '9':
+            case 'K': case 'L': case 'M': case 'N':
+                cellType = Level::ECellType::Beton;
+                return true;
+            case 'A':
+                cellType = Level::ECellType::Water;
+                return true;
+            case 'B':
+                cellType = Level::ECellType::Trees;
+                return true;
+            case 'C':
+                cellType = Level::ECellType::Ice;
+                return true;
+            case 'E':
+                cellType = Level::ECellType::Eagle;
+                return true;
+            case 'D':
+                cellType = Level::ECellType::Empty;
+                return true;
+            default:
+                return false;
+        }
+    }
+}
+
+Level::Level(const std::vector<std::string>& description) :
+             m_width(0),
+             m_height(static_cast<unsigned int>(description.size())),
+             m_eagleCell(0, 0) {
+    if (description.empty() || description.front().empty()) {
+        throw Exception::Exception("Empty level description");
+    }
+    m_width = static_cast<unsigned int>(description.front().size());
+    m_cells.resize(static_cast<size_t>(m_width) * m_height, ECellType::Empty);
+    m_wallMasks.resize(m_cells.size(), 0);
+
+    for (unsigned int row = 0; row < m_height; ++row) {
+        const std::string& currentRow = description[row];
+        if (currentRow.size() != m_width) {
+            throw Exception::Exception("Level row " + std::to_string(row) + " has length " +
+                                       std::to_string(currentRow.size()) + ", expected " +
+                                       std::to_string(m_width));
+        }
+        const unsigned int y = m_height - 1 - row;
+        for (unsigned int x = 0; x < m_width; ++x) {
+            ECellType cellType;
+            uint8_t wallMask;
+            if (! parseCell(currentRow[x], cellType, wallMask)) {
+                throw Exception::Exception(std::string("Unknown level symbol: ") + currentRow[x]);
+            }
+            m_cells[y * m_width + x] = cellType;
+            m_wallMasks[y * m_width + x] = wallMask;
+            if (cellType == ECellType::Eagle) {
+                m_eagleCell = glm::uvec2(x, y);
+            }
+        }
+    }
+}
+
+glm::uvec2 Level::getCellAt(const glm::vec2& position) const noexcept {
+    const float x = std::clamp(position.x / BLOCK_SIZE, 0.f, static_cast<float>(m_width - 1));
+    const float y = std::clamp(position.y / BLOCK_SIZE, 0.f, static_cast<float>(m_height - 1));
+    return { static_cast<unsigned int>(x), static_cast<unsigned int>(y) };
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <glm/vec2.hpp>
+
+
+/**
+ * Класс уровня. Хранит тип каждой клетки карты и маску четвертей стены, построенные по текстовому
+ * описанию из resources.json. Нулевая строка клеток - нижняя строка карты, первая строка
+ * описания - верхняя. Уровень неизменяем, разрушения хранит Terrain.
+ * */
+class Level {
+public:
+    enum class ECellType : uint8_t {
+        Empty,
+        Brick,
+        Beton,
+        Water,
+        Trees,
+        Ice,
+        Eagle
+    };
+
+    // Четверти клетки, из которых состоит стена.
+    enum EBlockQuarter : uint8_t {
+        TopLeft = 1,
+        TopRight = 2,
+        BottomLeft = 4,
+        BottomRight = 8,
+        AllQuarters = 15
+    };
+
+    // Размер клетки уровня в пикселях.
+    static constexpr unsigned int BLOCK_SIZE = 16;
+
+    Level() = delete;
+    /**
+     * @param description строки описания уровня одинаковой длины.
+     * @throw Exception::Exception если описание пустое, строки разной длины или встретился
+     * неизвестный символ.
+     * */
+    explicit Level(const std::vector<std::string>& description);
+
+    unsigned int width() const noexcept { return m_width; }
+    unsigned int height() const noexcept { return m_height; }
+    ECellType getCellType(unsigned int x, unsigned int y) const noexcept { return m_cells[y * m_width + x]; }
+    /**
+     * Метод возвращает маску четвертей EBlockQuarter, занятых стеной. Для клеток без стены
+     * маска равна 0, для орла - AllQuarters.
+     * */
+    uint8_t getWallMask(unsigned int x, unsigned int y) const noexcept { return m_wallMasks[y * m_width + x]; }
+    glm::uvec2 getEagleCell() const noexcept { return m_eagleCell; }
+    /**
+     * Метод возвращает клетку, в которой находится точка position (в пикселях). Точки за
+     * пределами карты прижимаются к ее краю.
+     * */
+    glm::uvec2 getCellAt(const glm::vec2& position) const noexcept;
+
+private:
+    unsigned int m_width;
+    unsigned int m_height;
+    std::vector<ECellType> m_cells;
+    std::vector<uint8_t> m_wallMasks;
+    glm::uvec2 m_eagleCell;
+};
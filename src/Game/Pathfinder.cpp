@@ -0,0 +1,30 @@
+#include "Pathfinder.h"
+
+Pathfinder::Pathfinder(NavigationGrid grid, const unsigned int targetsCount) :
+                       m_grid(std::move(grid)) {
+    // Поля хранят ссылку на m_grid, поэтому вектор не должен перераспределяться.
+    m_flowFields.reserve(targetsCount);
+    for (unsigned int i = 0; i < targetsCount; ++i) {
+        m_flowFields.emplace_back(m_grid);
+    }
+}
+
+void Pathfinder::setTarget(const unsigned int target, const unsigned int x, const unsigned int y) noexcept {
+    m_flowFields[target].setTarget(x, y);
+}
+
+void Pathfinder::rebuild(const unsigned int target) {
+    m_flowFields[target].rebuild();
+}
+
+void Pathfinder::setCellCost(const unsigned int x, const unsigned int y, const uint8_t cost) {
+    uint8_t& currentCost = m_grid.costs[m_grid.index(x, y)];
+    if (currentCost == cost) {
+        return;
+    }
+    const uint8_t oldCost = currentCost;
+    currentCost = cost;
+    for (auto& flowField : m_flowFields) {
+        flowField.onCellChanged(x, y, oldCost);
+    }
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <vector>
+
+#include "FlowField.h"
+
+/**
+ * Модуль поиска пути по сетке уровня. Хранит сетку проходимости и по одному полю направлений
+ * на каждую цель (орел, игроки). Изменение клетки сетки обновляет все поля инкрементально,
+ * смена цели перестраивает поле при первом запросе (см. FlowField).
+ * */
+class Pathfinder {
+public:
+    Pathfinder() = delete;
+    Pathfinder(const Pathfinder&) = delete;
+    Pathfinder(Pathfinder&&) = delete;
+    Pathfinder& operator=(const Pathfinder&) = delete;
+    Pathfinder& operator=(Pathfinder&&) = delete;
+
+    /**
+     * @param grid сетка проходимости уровня.
+     * @param targetsCount количество целей. Цели нумеруются с нуля.
+     * */
+    Pathfinder(NavigationGrid grid, unsigned int targetsCount);
+
+    void setTarget(unsigned int target, unsigned int x, unsigned int y) noexcept;
+    void rebuild(unsigned int target);
+    /**
+     * Метод меняет стоимость клетки и обновляет поля направлений всех целей.
+     * */
+    void setCellCost(unsigned int x, unsigned int y, uint8_t cost);
+
+    FlowField::EDirection getDirection(unsigned int target, unsigned int x, unsigned int y) {
+        return m_flowFields[target].getDirection(x, y);
+    }
+    FlowField& getFlowField(unsigned int target) noexcept { return m_flowFields[target]; }
+    const NavigationGrid& getGrid() const noexcept { return m_grid; }
+
+private:
+    NavigationGrid m_grid;
+    std::vector<FlowField> m_flowFields;
+};
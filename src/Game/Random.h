@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * Генератор псевдослучайных чисел xorshift64*. Все состояние - одно 64-битное число, поэтому
+ * его легко сохранить в повтор или снимок состояния игры и восстановить.
+ * */
+class Random {
+public:
+    explicit Random(uint64_t seed = 0) noexcept { setSeed(seed); }
+
+    void setSeed(uint64_t seed) noexcept {
+        // splitmix64: из любого начального числа, в том числе 0, получается ненулевое состояние.
+        uint64_t z = seed + 0x9E3779B97F4A7C15ull;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        m_state = (z ^ (z >> 31)) | 1;
+    }
+
+    uint64_t next() noexcept {
+        m_state ^= m_state >> 12;
+        m_state ^= m_state << 25;
+        m_state ^= m_state >> 27;
+        return m_state * 0x2545F4914F6CDD1Dull;
+    }
+
+    /**
+     * Метод возвращает число из диапазона [0, bound).
+     * */
+    uint32_t nextInt(uint32_t bound) noexcept {
+        return static_cast<uint32_t>((next() >> 32) * bound >> 32);
+    }
+
+    uint64_t getState() const noexcept { return m_state; }
+    void setState(uint64_t state) noexcept { m_state = state; }
+
+private:
+    uint64_t m_state;
+};
@@ -0,0 +1,198 @@
+#include "Replay.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iterator>
+
+#include "Game.h"
+#include "../Exception/Exception.h"
+
+namespace {
+    constexpr char MAGIC[4] { 'B', 'C', 'R', 'P' };
+    constexpr uint8_t VERSION = 1;
+
+    enum ERecordType : uint8_t {
+        Input,
+        StateHash,
+        End
+    };
+
+    class Reader {
+    public:
+        Reader(const std::vector<uint8_t>& data, const size_t offset) : m_data(data), m_offset(offset) {}
+
+        bool atEnd() const noexcept { return m_offset >= m_data.size(); }
+
+        uint8_t readU8() {
+            if (atEnd()) {
+                throw Exception::Exception("Unexpected end of replay file");
+            }
+            return m_data[m_offset++];
+        }
+
+        uint64_t readU64() {
+            uint64_t value = 0;
+            for (unsigned int i = 0; i < 8; ++i) {
+                value |= static_cast<uint64_t>(readU8()) << (8 * i);
+            }
+            return value;
+        }
+
+        uint64_t readVarint() {
+            uint64_t value = 0;
+            for (unsigned int shift = 0; shift < 64; shift += 7) {
+                const uint8_t byte = readU8();
+                value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+                if ((byte & 0x80) == 0) {
+                    return value;
+                }
+            }
+            throw Exception::Exception("Invalid varint in replay file");
+        }
+
+        size_t offset() const noexcept { return m_offset; }
+
+    private:
+        const std::vector<uint8_t>& m_data;
+        size_t m_offset;
+    };
+
+    void runUntil(Game& game, const uint64_t tick, const ReplayPlayer::TickCallback& onTick) {
+        while (game.getTickCount() < tick) {
+            game.update(Game::TICK_DURATION);
+            if (onTick) {
+                onTick(game);
+            }
+        }
+    }
+}
+
+ReplayRecorder::ReplayRecorder(const std::string& path, const ReplayHeader& header) :
+                               m_file(path, std::ios::binary | std::ios::trunc),
+                               m_lastTick(0),
+                               m_finished(false) {
+    if (! m_file.is_open()) {
+        throw Exception::Exception("Can't create replay file: " + path);
+    }
+    m_file.write(MAGIC, sizeof(MAGIC));
+    m_file.put(static_cast<char>(VERSION));
+    writeU64(header.tickDuration);
+    writeU64(header.seed);
+    writeU64(header.resourcesHash);
+}
+
+ReplayRecorder::~ReplayRecorder() {
+    if (! m_finished) {
+        finish(m_lastTick);
+    }
+}
+
+void ReplayRecorder::recordInput(const uint64_t tick, const InputEvent& event) {
+    writeRecordHeader(ERecordType::Input, tick);
+    writeVarint(static_cast<uint64_t>(event.key));
+    m_file.put(static_cast<char>(event.action));
+}
+
+void ReplayRecorder::recordStateHash(const uint64_t tick, const uint64_t hash) {
+    writeRecordHeader(ERecordType::StateHash, tick);
+    writeU64(hash);
+}
+
+void ReplayRecorder::finish(const uint64_t tick) {
+    if (m_finished) {
+        return;
+    }
+    writeRecordHeader(ERecordType::End, tick);
+    m_file.close();
+    m_finished = true;
+}
+
+void ReplayRecorder::writeRecordHeader(const uint8_t type, const uint64_t tick) {
+    m_file.put(static_cast<char>(type));
+    writeVarint(tick - m_lastTick);
+    m_lastTick = tick;
+}
+
+void ReplayRecorder::writeVarint(uint64_t value) {
+    while (value >= 0x80) {
+        m_file.put(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    m_file.put(static_cast<char>(value));
+}
+
+void ReplayRecorder::writeU64(const uint64_t value) {
+    for (unsigned int i = 0; i < 8; ++i) {
+        m_file.put(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+}
+
+ReplayPlayer::ReplayPlayer(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (! file.is_open()) {
+        throw Exception::Exception("Can't open replay file: " + path);
+    }
+    m_records.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+    if (m_records.size() < sizeof(MAGIC) + 1 ||
+        ! std::equal(std::begin(MAGIC), std::end(MAGIC), m_records.begin())) {
+        throw Exception::Exception("Not a replay file: " + path);
+    }
+    if (m_records[sizeof(MAGIC)] != VERSION) {
+        throw Exception::Exception("Unsupported replay version in file: " + path);
+    }
+    Reader reader(m_records, sizeof(MAGIC) + 1);
+    m_header.tickDuration = reader.readU64();
+    m_header.seed = reader.readU64();
+    m_header.resourcesHash = reader.readU64();
+    m_records.erase(m_records.begin(), m_records.begin() + static_cast<std::ptrdiff_t>(reader.offset()));
+}
+
+ReplayPlayer::Result ReplayPlayer::play(Game& game, const TickCallback& onTick) const {
+    if (m_header.tickDuration != Game::TICK_DURATION) {
+        throw Exception::Exception("Replay was recorded with a different tick duration");
+    }
+    Result result;
+    const auto start = std::chrono::steady_clock::now();
+
+    Reader reader(m_records, 0);
+    uint64_t tick = 0;
+    while (! reader.atEnd()) {
+        const uint8_t type = reader.readU8();
+        tick += reader.readVarint();
+        switch (type) {
+            case ERecordType::Input: {
+                InputEvent event {};
+                event.key = static_cast<int16_t>(reader.readVarint());
+                event.action = reader.readU8();
+                // Событие должно попасть в очередь до начала шага, в котором было применено.
+                runUntil(game, tick, onTick);
+                game.pushInputEvent(event);
+                ++result.inputEvents;
+                break;
+            }
+            case ERecordType::StateHash: {
+                const uint64_t hash = reader.readU64();
+                runUntil(game, tick, onTick);
+                ++result.checkedHashes;
+                if (game.getStateHash() != hash) {
+                    if (result.mismatches == 0) {
+                        result.firstMismatchTick = tick;
+                    }
+                    ++result.mismatches;
+                }
+                break;
+            }
+            case ERecordType::End:
+                runUntil(game, tick, onTick);
+                break;
+            default:
+                throw Exception::Exception("Unknown record type in replay file");
+        }
+    }
+
+    result.ticks = game.getTickCount();
+    result.elapsedNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count();
+    return result;
+}
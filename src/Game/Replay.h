@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "InputQueue.h"
+
+class Game;
+
+/**
+ * Заголовок файла повтора.
+ * */
+struct ReplayHeader {
+    uint64_t tickDuration = 0;
+    uint64_t seed = 0;
+    uint64_t resourcesHash = 0;
+};
+
+/**
+ * Запись повтора. Формат файла: сигнатура и заголовок, затем поток записей. Каждая запись -
+ * байт типа, номер шага относительно предыдущей записи (varint) и данные: для события ввода -
+ * клавиша (varint) и действие, для контрольной точки - 64-битный хеш состояния игры.
+ * */
+class ReplayRecorder {
+public:
+    ReplayRecorder(const ReplayRecorder&) = delete;
+    ReplayRecorder& operator=(const ReplayRecorder&) = delete;
+
+    /**
+     * @param path путь к создаваемому файлу.
+     * @throw Exception::Exception если файл не удалось открыть.
+     * */
+    ReplayRecorder(const std::string& path, const ReplayHeader& header);
+    ~ReplayRecorder();
+
+    /**
+     * @param tick номер шага, в котором событие было применено.
+     * */
+    void recordInput(uint64_t tick, const InputEvent& event);
+    /**
+     * @param tick количество выполненных шагов к моменту вычисления хеша.
+     * */
+    void recordStateHash(uint64_t tick, uint64_t hash);
+    /**
+     * Метод записывает итоговое количество шагов и закрывает файл.
+     * */
+    void finish(uint64_t tick);
+
+private:
+    void writeRecordHeader(uint8_t type, uint64_t tick);
+    void writeVarint(uint64_t value);
+    void writeU64(uint64_t value);
+
+private:
+    std::ofstream m_file;
+    uint64_t m_lastTick;
+    bool m_finished;
+};
+
+/**
+ * Воспроизведение повтора. Файл читается целиком, события подаются в Game шаг за шагом без
+ * отрисовки, поэтому повтор выполняется во много раз быстрее реального времени.
+ * */
+class ReplayPlayer {
+public:
+    struct Result {
+        uint64_t ticks = 0;
+        uint64_t inputEvents = 0;
+        uint64_t checkedHashes = 0;
+        uint64_t mismatches = 0;
+        // Шаг первого расхождения состояния, если mismatches > 0.
+        uint64_t firstMismatchTick = 0;
+        uint64_t elapsedNs = 0;
+    };
+
+    /**
+     * Вызывается после каждого шага воспроизведения, например для отрисовки кадра.
+     * */
+    using TickCallback = std::function<void(Game& game)>;
+
+    ReplayPlayer() = delete;
+    /**
+     * @param path путь к файлу повтора.
+     * @throw Exception::Exception если файл не найден или поврежден.
+     * */
+    explicit ReplayPlayer(const std::string& path);
+
+    const ReplayHeader& getHeader() const noexcept { return m_header; }
+    /**
+     * Метод воспроизводит повтор на только что инициализированной игре.
+     * @param onTick необязательный обработчик каждого шага; его время входит в elapsedNs.
+     * @throw Exception::Exception если файл поврежден.
+     * */
+    Result play(Game& game, const TickCallback& onTick = nullptr) const;
+
+private:
+    std::vector<uint8_t> m_records;
+    ReplayHeader m_header;
+};
@@ -2,29 +2,57 @@
 #include <string>
 #include "../Renderer/AnimatedSprite.h"
 
-Tank::Tank(std::shared_ptr<RenderEngine::AnimatedSprite> pSprite, float velocity, const glm::vec2& position)
+Tank::Tank(SpritePool& sprites, const Utils::Handle<RenderEngine::AnimatedSprite> spriteHandle,
+           float velocity, const glm::vec2& position)
     :
     m_eOrientation(EOrientation::Top),
-    m_pSprite(std::move(pSprite)),
+    m_sprites(sprites),
+    m_spriteHandle(spriteHandle),
     m_move(false),
     m_velocity(velocity),
     m_position(position),
-    m_moveOffset(glm::vec2(0, 1)) {
-    m_pSprite->setPosition(m_position);
+    m_moveOffset(glm::vec2(0, 1)),
+    m_paletteRow(0) {
+    sprite().setPosition(m_position);
+}
+
+Tank::~Tank() {
+    m_sprites.destroy(m_spriteHandle);
 }
 
 void Tank::render() const {
-    m_pSprite->render();
+    sprite().render();
 }
 
 void Tank::update(uint64_t delta) {
     if (m_move) {
         m_position += static_cast<float>(delta) * m_velocity * m_moveOffset;
-        m_pSprite->setPosition(m_position);
-        m_pSprite->update(delta);
+        sprite().setPosition(m_position);
+        sprite().update(delta);
     }
 }
 
+glm::vec2 Tank::getCenter() const {
+    return m_position + 0.5f * sprite().getSize();
+}
+
+glm::vec2 Tank::getBarrelPosition() const {
+    return getCenter() + 0.5f * sprite().getSize() * m_moveOffset;
+}
+
+Tank::State Tank::getState() const noexcept {
+    return { m_position, m_eOrientation, m_move, sprite().getAnimationState() };
+}
+
+void Tank::setState(const State& state) {
+    m_position = state.position;
+    m_move = state.move;
+    setOrientation(state.eOrientation);
+    // setOrientation() сбрасывает анимацию, поэтому кадр восстанавливается после него.
+    sprite().setAnimationState(state.animation);
+    sprite().setPosition(m_position);
+}
+
 void Tank::setOrientation(const Tank::EOrientation eOrientation) {
     if (m_eOrientation == eOrientation) {
         return;
@@ -32,22 +60,22 @@ void Tank::setOrientation(const Tank::EOrientation eOrientation) {
     m_eOrientation = eOrientation;
     switch (m_eOrientation) {
         case EOrientation::Top:
-            m_pSprite->setState("tankTopState");
+            sprite().setState("tankTopState");
             m_moveOffset.x = 0.0f;
             m_moveOffset.y = 1.0f;
             break;
         case EOrientation::Bottom:
-            m_pSprite->setState("tankBottomState");
+            sprite().setState("tankBottomState");
             m_moveOffset.x = 0.0f;
             m_moveOffset.y = -1.0f;
             break;
         case EOrientation::Left:
-            m_pSprite->setState("tankLeftState");
+            sprite().setState("tankLeftState");
             m_moveOffset.x = -1.0f;
             m_moveOffset.y = 0.0f;
             break;
         case EOrientation::Right:
-            m_pSprite->setState("tankRightState");
+            sprite().setState("tankRightState");
             m_moveOffset.x = 1.0f;
             m_moveOffset.y = 0.0f;
             break;
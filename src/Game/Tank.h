@@ -1,14 +1,17 @@
 #pragma once
 
-#include <memory>
+#include <cstdint>
 
 #include <glm/vec2.hpp>
 
-namespace RenderEngine {
-    class AnimatedSprite;
-}
+#include "../Renderer/AnimatedSprite.h"
+#include "../Utils/HandlePool.h"
 
 class Tank {
+public:
+    Tank(const Tank&) = delete;
+    Tank& operator=(const Tank&) = delete;
+
 public:
     enum class EOrientation {
         Top,
@@ -17,18 +20,62 @@ public:
         Right
     };
 
-    Tank(std::shared_ptr<RenderEngine::AnimatedSprite> pSprite, float velocity, const glm::vec2& position);
+    /**
+     * Состояние танка для снимков игры. Тривиально копируемо.
+     * */
+    struct State {
+        glm::vec2 position;
+        EOrientation eOrientation;
+        bool move;
+        RenderEngine::AnimatedSprite::AnimationState animation;
+    };
+
+    using SpritePool = Utils::HandlePool<RenderEngine::AnimatedSprite>;
+
+    /**
+     * @param sprites пул, которому принадлежит спрайт танка; должен пережить танк.
+     * @param spriteHandle собственный спрайт танка, удаляется из пула вместе с танком.
+     * */
+    Tank(SpritePool& sprites, Utils::Handle<RenderEngine::AnimatedSprite> spriteHandle,
+         float velocity, const glm::vec2& position);
+    ~Tank();
 
     void render() const;
     void setOrientation(const EOrientation eOrientation);
     void move(bool move);
     void update(uint64_t delta);
 
+    const glm::vec2& getPosition() const { return m_position; }
+    EOrientation getOrientation() const { return m_eOrientation; }
+    const RenderEngine::AnimatedSprite& getSprite() const { return sprite(); }
+    /**
+     * Строка палитры индексированного атласа танков, которой окрашивается танк.
+     * */
+    void setPaletteRow(const uint8_t paletteRow) noexcept { m_paletteRow = paletteRow; }
+    uint8_t getPaletteRow() const noexcept { return m_paletteRow; }
+    glm::vec2 getCenter() const;
+    /**
+     * Метод возвращает точку, из которой вылетает снаряд: середину стороны танка, в которую
+     * он повернут.
+     * */
+    glm::vec2 getBarrelPosition() const;
+
+    State getState() const noexcept;
+    /**
+     * Метод восстанавливает состояние, полученное из getState(), вместе с кадром анимации.
+     * */
+    void setState(const State& state);
+
+private:
+    RenderEngine::AnimatedSprite& sprite() const { return *m_sprites.get(m_spriteHandle); }
+
 private:
     EOrientation m_eOrientation;
-    std::shared_ptr<RenderEngine::AnimatedSprite> m_pSprite;
+    SpritePool& m_sprites;
+    Utils::Handle<RenderEngine::AnimatedSprite> m_spriteHandle;
     bool m_move;
     float m_velocity;
     glm::vec2 m_position;
     glm::vec2 m_moveOffset;
+    uint8_t m_paletteRow;
 };
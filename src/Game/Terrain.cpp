@@ -0,0 +1,146 @@
+#include "Terrain.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+    constexpr float HALF_BLOCK = Level::BLOCK_SIZE / 2.f;
+    // Половина ширины полосы, которую снаряд выбивает в стене.
+    constexpr float BULLET_DAMAGE_HALF_WIDTH = Level::BLOCK_SIZE / 4.f;
+
+    uint8_t getQuarter(const bool right, const bool top) {
+        if (top) {
+            return right ? Level::TopRight : Level::TopLeft;
+        }
+        return right ? Level::BottomRight : Level::BottomLeft;
+    }
+}
+
+Terrain::Terrain(const Level& level) :
+                 m_width(level.width()),
+                 m_height(level.height()),
+                 m_eagleDestroyed(false) {
+    m_cells.reserve(static_cast<size_t>(m_width) * m_height);
+    m_wallMasks.reserve(static_cast<size_t>(m_width) * m_height);
+    for (unsigned int y = 0; y < m_height; ++y) {
+        for (unsigned int x = 0; x < m_width; ++x) {
+            m_cells.push_back(level.getCellType(x, y));
+            m_wallMasks.push_back(level.getWallMask(x, y));
+        }
+    }
+}
+
+bool Terrain::isSolidAt(const glm::vec2& position) const noexcept {
+    if (position.x < 0.f || position.y < 0.f) {
+        return false;
+    }
+    const auto x = static_cast<unsigned int>(position.x) / Level::BLOCK_SIZE;
+    const auto y = static_cast<unsigned int>(position.y) / Level::BLOCK_SIZE;
+    if (x >= m_width || y >= m_height) {
+        return false;
+    }
+    const glm::vec2 local = position - glm::vec2(x * Level::BLOCK_SIZE, y * Level::BLOCK_SIZE);
+    return (getWallMask(x, y) & getQuarter(local.x >= HALF_BLOCK, local.y >= HALF_BLOCK)) != 0;
+}
+
+bool Terrain::hit(const glm::vec2& position, const Tank::EOrientation eOrientation) {
+    if (! isSolidAt(position)) {
+        return false;
+    }
+    const auto x = static_cast<unsigned int>(position.x) / Level::BLOCK_SIZE;
+    const auto y = static_cast<unsigned int>(position.y) / Level::BLOCK_SIZE;
+    const glm::vec2 local = position - glm::vec2(x * Level::BLOCK_SIZE, y * Level::BLOCK_SIZE);
+
+    switch (getCellType(x, y)) {
+        case Level::ECellType::Brick: {
+            uint8_t damage = 0;
+            const bool vertical = eOrientation == Tank::EOrientation::Top ||
+                                  eOrientation == Tank::EOrientation::Bottom;
+            if (vertical) {
+                // Снаряд летит вертикально и выбивает четверти своего ряда, которые перекрывает.
+                const bool top = local.y >= HALF_BLOCK;
+                if (local.x - BULLET_DAMAGE_HALF_WIDTH < HALF_BLOCK) damage |= getQuarter(false, top);
+                if (local.x + BULLET_DAMAGE_HALF_WIDTH >= HALF_BLOCK) damage |= getQuarter(true, top);
+            } else {
+                const bool right = local.x >= HALF_BLOCK;
+                if (local.y - BULLET_DAMAGE_HALF_WIDTH < HALF_BLOCK) damage |= getQuarter(right, false);
+                if (local.y + BULLET_DAMAGE_HALF_WIDTH >= HALF_BLOCK) damage |= getQuarter(right, true);
+            }
+            setWallMask(x, y, getWallMask(x, y) & ~damage);
+            break;
+        }
+        case Level::ECellType::Eagle:
+            m_eagleDestroyed = true;
+            setWallMask(x, y, 0);
+            break;
+        default:
+            break;
+    }
+    return true;
+}
+
+void Terrain::setWallMask(const unsigned int x, const unsigned int y, const uint8_t wallMask) {
+    uint8_t& currentMask = m_wallMasks[y * m_width + x];
+    if (currentMask == wallMask) {
+        return;
+    }
+    currentMask = wallMask;
+    notify(x, y);
+}
+
+void Terrain::saveWallMasks(uint8_t* wallMasks) const noexcept {
+    std::copy(m_wallMasks.begin(), m_wallMasks.end(), wallMasks);
+}
+
+void Terrain::restoreWallMasks(const uint8_t* wallMasks, const bool eagleDestroyed) {
+    m_eagleDestroyed = eagleDestroyed;
+    // Между откатами обычно меняется несколько клеток: совпадающие блоки сравниваются memcmp
+    // и пропускаются целиком, поклеточно проверяются только отличающиеся.
+    constexpr size_t BLOCK = 64;
+    const size_t count = m_wallMasks.size();
+    for (size_t begin = 0; begin < count; begin += BLOCK) {
+        const size_t end = std::min(begin + BLOCK, count);
+        if (std::memcmp(&m_wallMasks[begin], wallMasks + begin, end - begin) == 0) {
+            continue;
+        }
+        for (size_t i = begin; i < end; ++i) {
+            if (m_wallMasks[i] != wallMasks[i]) {
+                m_wallMasks[i] = wallMasks[i];
+                notify(static_cast<unsigned int>(i % m_width), static_cast<unsigned int>(i / m_width));
+            }
+        }
+    }
+}
+
+void Terrain::addCellChangedListener(CellChangedListener listener) {
+    m_listeners.emplace_back(std::move(listener));
+}
+
+uint8_t Terrain::getNavigationCost(const unsigned int x, const unsigned int y) const noexcept {
+    switch (getCellType(x, y)) {
+        case Level::ECellType::Empty:
+        case Level::ECellType::Trees:
+        case Level::ECellType::Ice:
+            return 1;
+        case Level::ECellType::Brick:
+            return getWallMask(x, y) == 0 ? 1 : BRICK_NAVIGATION_COST;
+        default:
+            return NavigationGrid::IMPASSABLE;
+    }
+}
+
+NavigationGrid Terrain::buildNavigationGrid() const {
+    NavigationGrid grid(m_width, m_height);
+    for (unsigned int y = 0; y < m_height; ++y) {
+        for (unsigned int x = 0; x < m_width; ++x) {
+            grid.costs[grid.index(x, y)] = getNavigationCost(x, y);
+        }
+    }
+    return grid;
+}
+
+void Terrain::notify(const unsigned int x, const unsigned int y) const {
+    for (const auto& listener : m_listeners) {
+        listener(x, y);
+    }
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include <glm/vec2.hpp>
+
+#include "Level.h"
+#include "Tank.h"
+#include "FlowField.h"
+
+/**
+ * Разрушаемая местность уровня. Для каждой клетки хранит тип и маску уцелевших четвертей стены
+ * (Level::EBlockQuarter). Попадание снаряда меняет маску только одной клетки и сообщает об
+ * изменении подписчикам (отрисовке, поиску пути), поэтому стоимость попадания не зависит от
+ * размера карты.
+ * */
+class Terrain {
+public:
+    using CellChangedListener = std::function<void(unsigned int x, unsigned int y)>;
+
+    // Стоимость проезда через кирпичную стену для поиска пути: стену нужно сначала прострелить.
+    static constexpr uint8_t BRICK_NAVIGATION_COST = 4;
+
+    Terrain() = delete;
+    explicit Terrain(const Level& level);
+
+    unsigned int width() const noexcept { return m_width; }
+    unsigned int height() const noexcept { return m_height; }
+    Level::ECellType getCellType(unsigned int x, unsigned int y) const noexcept { return m_cells[y * m_width + x]; }
+    uint8_t getWallMask(unsigned int x, unsigned int y) const noexcept { return m_wallMasks[y * m_width + x]; }
+    bool isEagleDestroyed() const noexcept { return m_eagleDestroyed; }
+
+    /**
+     * Метод проверяет, занята ли точка position (в пикселях) стеной или орлом.
+     * */
+    bool isSolidAt(const glm::vec2& position) const noexcept;
+    /**
+     * Метод обрабатывает снаряд, находящийся в точке position. Если точка занята стеной,
+     * кирпичная стена теряет четверти ряда, в который попал снаряд, в пределах ширины снаряда.
+     * @return true, если снаряд остановлен.
+     * */
+    bool hit(const glm::vec2& position, Tank::EOrientation eOrientation);
+    /**
+     * Метод меняет маску стены клетки и оповещает подписчиков.
+     * */
+    void setWallMask(unsigned int x, unsigned int y, uint8_t wallMask);
+
+    /**
+     * Метод копирует маски width() * height() клеток в wallMasks (сохранение снимка).
+     * */
+    void saveWallMasks(uint8_t* wallMasks) const noexcept;
+    /**
+     * Метод восстанавливает разрушения из снимка: маски width() * height() клеток и состояние
+     * орла. Подписчики оповещаются только о клетках, маска которых отличается от текущей.
+     * */
+    void restoreWallMasks(const uint8_t* wallMasks, bool eagleDestroyed);
+
+    void addCellChangedListener(CellChangedListener listener);
+
+    uint8_t getNavigationCost(unsigned int x, unsigned int y) const noexcept;
+    NavigationGrid buildNavigationGrid() const;
+
+private:
+    void notify(unsigned int x, unsigned int y) const;
+
+private:
+    unsigned int m_width;
+    unsigned int m_height;
+    std::vector<Level::ECellType> m_cells;
+    std::vector<uint8_t> m_wallMasks;
+    bool m_eagleDestroyed;
+    std::vector<CellChangedListener> m_listeners;
+};
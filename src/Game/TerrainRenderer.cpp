@@ -0,0 +1,172 @@
+#include "TerrainRenderer.h"
+
+#include "Terrain.h"
+#include "../Renderer/StaticSpriteBatch.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+    constexpr unsigned int SLOTS_PER_CELL = 4;
+}
+
+TerrainRenderer::TerrainRenderer(const Terrain& terrain,
+                                 const RenderEngine::TextureHandle texture,
+                                 const RenderEngine::ShaderProgramHandle shaderProgram) :
+                                 m_width(terrain.width()),
+                                 m_cellTypes(terrain.width() * terrain.height()),
+                                 m_wallMasks(terrain.width() * terrain.height()),
+                                 m_eagleDestroyed(terrain.isEagleDestroyed()),
+                                 m_revision(0),
+                                 m_texture(texture),
+                                 m_shaderProgram(shaderProgram) {
+    for (unsigned int y = 0; y < terrain.height(); ++y) {
+        for (unsigned int x = 0; x < terrain.width(); ++x) {
+            m_cellTypes[y * m_width + x] = terrain.getCellType(x, y);
+        }
+    }
+    terrain.saveWallMasks(m_wallMasks.data());
+
+    m_pBatch = std::make_unique<RenderEngine::StaticSpriteBatch>(RenderEngine::getTexturePool().get(m_texture),
+                                                                 RenderEngine::getShaderProgramPool().get(m_shaderProgram),
+                                                                 terrain.width() * terrain.height() * SLOTS_PER_CELL);
+    resolveSubTextures();
+}
+
+TerrainRenderer::~TerrainRenderer() {}
+
+void TerrainRenderer::sync(const uint8_t* wallMasks, const bool eagleDestroyed, const uint64_t revision) noexcept {
+    const size_t count = m_wallMasks.size();
+    m_revision = revision;
+    setEagleDestroyed(eagleDestroyed);
+    // Обычно за кадр меняется не больше пары клеток, поэтому совпадающие блоки пропускаются
+    // целиком, как в Terrain::restoreWallMasks().
+    constexpr size_t BLOCK = 64;
+    for (size_t begin = 0; begin < count; begin += BLOCK) {
+        const size_t end = std::min(begin + BLOCK, count);
+        if (std::memcmp(&m_wallMasks[begin], wallMasks + begin, end - begin) == 0) {
+            continue;
+        }
+        for (size_t i = begin; i < end; ++i) {
+            if (m_wallMasks[i] != wallMasks[i]) {
+                m_wallMasks[i] = wallMasks[i];
+                updateCell(static_cast<unsigned int>(i % m_width), static_cast<unsigned int>(i / m_width));
+            }
+        }
+    }
+}
+
+bool TerrainRenderer::applyChanges(const RenderEngine::RenderPacket::WallMaskChange* changes, const size_t count,
+                                   const uint64_t firstRevision, const bool eagleDestroyed) noexcept {
+    if (firstRevision > m_revision) {
+        return false;
+    }
+    setEagleDestroyed(eagleDestroyed);
+    // Пакеты могут повторять изменения, которые отрисовка получила с прошлыми пакетами.
+    for (size_t i = m_revision - firstRevision; i < count; ++i) {
+        const uint32_t cell = changes[i].cell;
+        if (cell < m_wallMasks.size() && m_wallMasks[cell] != changes[i].wallMask) {
+            m_wallMasks[cell] = changes[i].wallMask;
+            updateCell(cell % m_width, cell / m_width);
+        }
+    }
+    m_revision = std::max<uint64_t>(m_revision, firstRevision + count);
+    return true;
+}
+
+void TerrainRenderer::setEagleDestroyed(const bool eagleDestroyed) noexcept {
+    if (eagleDestroyed == m_eagleDestroyed) {
+        return;
+    }
+    m_eagleDestroyed = eagleDestroyed;
+    // Штаб занимает несколько клеток, поэтому его смена - редкий просмотр всей карты.
+    for (size_t i = 0; i < m_cellTypes.size(); ++i) {
+        if (m_cellTypes[i] == Level::ECellType::Eagle) {
+            updateCell(static_cast<unsigned int>(i % m_width), static_cast<unsigned int>(i / m_width));
+        }
+    }
+}
+
+void TerrainRenderer::updateCell(const unsigned int x, const unsigned int y) noexcept {
+    const unsigned int cell = y * m_width + x;
+    const unsigned int firstSlot = cell * SLOTS_PER_CELL;
+    const glm::vec2 cellPosition(x * Level::BLOCK_SIZE, y * Level::BLOCK_SIZE);
+    const glm::vec2 cellSize(Level::BLOCK_SIZE);
+
+    const Level::ECellType cellType = m_cellTypes[cell];
+    if (cellType == Level::ECellType::Brick || cellType == Level::ECellType::Beton) {
+        // Каждая уцелевшая четверть рисуется своим куском той же текстуры стены.
+        const auto& wallSubTexture = m_subTextures[cellType == Level::ECellType::Brick ? Brick : Beton];
+        const glm::vec2 halfUV = 0.5f * (wallSubTexture.rightTopUV - wallSubTexture.leftBottomUV);
+        const glm::vec2 halfSize = 0.5f * cellSize;
+        const uint8_t wallMask = m_wallMasks[cell];
+        const uint8_t quarters[SLOTS_PER_CELL] {
+            Level::BottomLeft, Level::BottomRight, Level::TopLeft, Level::TopRight
+        };
+        for (unsigned int i = 0; i < SLOTS_PER_CELL; ++i) {
+            if ((wallMask & quarters[i]) == 0) {
+                m_pBatch->clearQuad(firstSlot + i);
+                continue;
+            }
+            const glm::vec2 offset(i % 2, i / 2);
+            const glm::vec2 leftBottomUV = wallSubTexture.leftBottomUV + offset * halfUV;
+            m_pBatch->setQuad(firstSlot + i,
+                              RenderEngine::Texture2D::SubTexture2D(leftBottomUV, leftBottomUV + halfUV),
+                              cellPosition + offset * halfSize, halfSize);
+        }
+        return;
+    }
+
+    ESubTexture subTexture = SubTexturesCount;
+    switch (cellType) {
+        case Level::ECellType::Water:
+            subTexture = Water;
+            break;
+        case Level::ECellType::Trees:
+            subTexture = Trees;
+            break;
+        case Level::ECellType::Ice:
+            subTexture = Ice;
+            break;
+        case Level::ECellType::Eagle:
+            subTexture = m_eagleDestroyed ? DeadEagle : Eagle;
+            break;
+        default:
+            break;
+    }
+    if (subTexture == SubTexturesCount) {
+        m_pBatch->clearQuad(firstSlot);
+    } else {
+        m_pBatch->setQuad(firstSlot, m_subTextures[subTexture], cellPosition, cellSize);
+    }
+    for (unsigned int i = 1; i < SLOTS_PER_CELL; ++i) {
+        m_pBatch->clearQuad(firstSlot + i);
+    }
+}
+
+void TerrainRenderer::resolveSubTextures() {
+    const RenderEngine::Texture2D* pTexture = RenderEngine::getTexturePool().get(m_texture);
+    if (! pTexture) {
+        return;
+    }
+    m_subTextures[Brick] = pTexture->getSubTexture("block");
+    m_subTextures[Beton] = pTexture->getSubTexture("beton");
+    m_subTextures[Water] = pTexture->getSubTexture("water1");
+    m_subTextures[Trees] = pTexture->getSubTexture("trees");
+    m_subTextures[Ice] = pTexture->getSubTexture("ice");
+    m_subTextures[Eagle] = pTexture->getSubTexture("eagle");
+    m_subTextures[DeadEagle] = pTexture->getSubTexture("deadEagle");
+
+    const size_t count = m_cellTypes.size();
+    for (size_t i = 0; i < count; ++i) {
+        updateCell(static_cast<unsigned int>(i % m_width), static_cast<unsigned int>(i / m_width));
+    }
+}
+
+void TerrainRenderer::render() const {
+    if (! RenderEngine::getTexturePool().get(m_texture) ||
+        ! RenderEngine::getShaderProgramPool().get(m_shaderProgram)) {
+        return;
+    }
+    m_pBatch->render();
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <array>
+#include <memory>
+#include <vector>
+
+#include "Level.h"
+#include "../Renderer/RenderPacket.h"
+#include "../Renderer/Texture2D.h"
+#include "../Renderer/ResourceHandles.h"
+
+namespace RenderEngine {
+    class ShaderProgram;
+    class StaticSpriteBatch;
+}
+
+class Terrain;
+
+/**
+ * Отрисовка местности. Каждая клетка занимает четыре постоянные ячейки пакета (по одной на
+ * четверть стены), поэтому изменение клетки перезаписывает только ее вершины. Объект хранит
+ * собственную копию масок стен и не обращается к Terrain после создания, так что симуляция и
+ * отрисовка могут работать в разных потоках: изменения карты приходят через applyChanges(), а
+ * полное состояние - через sync(). Объект помнит ревизию карты (см. RenderPacket), до которой
+ * доведена отрисовка; при создании она нулевая.
+ * */
+class TerrainRenderer {
+public:
+    TerrainRenderer() = delete;
+    TerrainRenderer(const TerrainRenderer&) = delete;
+    TerrainRenderer& operator=(const TerrainRenderer&) = delete;
+
+    /**
+     * @param terrain местность, из которой берутся типы клеток и начальные разрушения.
+     * @param texture атлас карты (mapTextureAtlas).
+     * @param shaderProgram шейдерная программа спрайтов.
+     * */
+    TerrainRenderer(const Terrain& terrain,
+                    RenderEngine::TextureHandle texture,
+                    RenderEngine::ShaderProgramHandle shaderProgram);
+    ~TerrainRenderer();
+
+    /**
+     * Метод приводит отрисовку к полному состоянию местности: перестраиваются вершины только тех
+     * клеток, маски которых отличаются от показанных. Просматривает всю карту, поэтому нужен
+     * только тогда, когда изменений уже нет (отрисовка сильно отстала от симуляции).
+     * @param wallMasks маски width * height клеток, как в Terrain::saveWallMasks().
+     * @param eagleDestroyed разрушен ли штаб.
+     * @param revision ревизия карты, которой соответствуют маски.
+     * */
+    void sync(const uint8_t* wallMasks, bool eagleDestroyed, uint64_t revision) noexcept;
+    /**
+     * Метод применяет изменения клеток, пропуская уже примененные. Стоимость зависит только от
+     * количества изменений.
+     * @param changes изменения ревизий firstRevision + 1 ... firstRevision + count.
+     * @param eagleDestroyed разрушен ли штаб.
+     * @return false, если изменения начинаются после ревизии отрисовки (часть пропущена) и
+     * нужен sync().
+     * */
+    bool applyChanges(const RenderEngine::RenderPacket::WallMaskChange* changes, size_t count,
+                      uint64_t firstRevision, bool eagleDestroyed) noexcept;
+    uint64_t getRevision() const noexcept { return m_revision; }
+    void render() const;
+    /**
+     * Метод заново находит области атласа по именам и перезаписывает вершины всех клеток.
+     * Вызывается после перезагрузки атласа, в которой области могли переместиться.
+     * */
+    void resolveSubTextures();
+    unsigned int cellsCount() const noexcept { return static_cast<unsigned int>(m_wallMasks.size()); }
+
+private:
+    enum ESubTexture {
+        Brick,
+        Beton,
+        Water,
+        Trees,
+        Ice,
+        Eagle,
+        DeadEagle,
+        SubTexturesCount
+    };
+
+    void updateCell(unsigned int x, unsigned int y) noexcept;
+    void setEagleDestroyed(bool eagleDestroyed) noexcept;
+
+private:
+    unsigned int m_width;
+    std::vector<Level::ECellType> m_cellTypes;
+    std::vector<uint8_t> m_wallMasks;
+    bool m_eagleDestroyed;
+    uint64_t m_revision;
+    // Пакет ссылается на объекты дескрипторов и рисуется только после их проверки.
+    RenderEngine::TextureHandle m_texture;
+    RenderEngine::ShaderProgramHandle m_shaderProgram;
+    std::array<RenderEngine::Texture2D::SubTexture2D, SubTexturesCount> m_subTextures;
+    std::unique_ptr<RenderEngine::StaticSpriteBatch> m_pBatch;
+};
@@ -0,0 +1,51 @@
+#include "LinkConditioner.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace Network {
+
+    LinkConditioner::LinkConditioner(const Settings& settings, const uint64_t seed) noexcept :
+                                     m_settings(settings),
+                                     m_random(seed),
+                                     m_count(0),
+                                     m_droppedCount(0) {}
+
+    bool LinkConditioner::push(const uint64_t now, const void* data, const size_t size) noexcept {
+        if (m_count == CAPACITY || size > MAX_PACKET_SIZE || m_random.nextInt(100) < m_settings.lossPercent) {
+            ++m_droppedCount;
+            return false;
+        }
+        int64_t delayMs = m_settings.latencyMs;
+        if (m_settings.jitterMs) {
+            delayMs += static_cast<int64_t>(m_random.nextInt(2 * m_settings.jitterMs + 1)) - m_settings.jitterMs;
+        }
+        Packet& packet = m_packets[m_count++];
+        packet.deliveryTime = now + static_cast<uint64_t>(std::max<int64_t>(delayMs, 0)) * 1000000;
+        packet.size = size;
+        std::memcpy(packet.data.data(), data, size);
+        return true;
+    }
+
+    bool LinkConditioner::pop(const uint64_t now, void* buffer, size_t& size) noexcept {
+        // Очередь короткая (десятки пакетов), линейный поиск проще кучи.
+        size_t earliest = m_count;
+        for (size_t i = 0; i < m_count; ++i) {
+            if (m_packets[i].deliveryTime <= now &&
+                (earliest == m_count || m_packets[i].deliveryTime < m_packets[earliest].deliveryTime)) {
+                earliest = i;
+            }
+        }
+        if (earliest == m_count) {
+            return false;
+        }
+        size = m_packets[earliest].size;
+        std::memcpy(buffer, m_packets[earliest].data.data(), size);
+        // Порядок в массиве не важен: последний пакет переносится на место извлеченного.
+        --m_count;
+        if (earliest != m_count) {
+            m_packets[earliest] = m_packets[m_count];
+        }
+        return true;
+    }
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "../Game/Random.h"
+
+namespace Network {
+
+    /**
+     * Имитация плохого канала для проверки сетевой игры на одной машине. Принятые пакеты
+     * задерживаются на latency +- jitter и с вероятностью lossPercent теряются. Из-за разброса
+     * задержки пакеты могут приходить не по порядку, как в настоящей сети. Память под очередь
+     * выделена заранее.
+     * */
+    class LinkConditioner {
+    public:
+        struct Settings {
+            // Задержка в одну сторону в миллисекундах.
+            uint32_t latencyMs = 0;
+            uint32_t jitterMs = 0;
+            uint32_t lossPercent = 0;
+        };
+
+        static constexpr size_t MAX_PACKET_SIZE = 512;
+        static constexpr size_t CAPACITY = 256;
+
+        LinkConditioner(const Settings& settings, uint64_t seed) noexcept;
+
+        bool isEnabled() const noexcept { return m_settings.latencyMs || m_settings.jitterMs || m_settings.lossPercent; }
+        /**
+         * Метод ставит пакет, принятый в момент now (нс), в очередь или теряет его.
+         * @return false, если пакет потерян (имитация или переполнение очереди).
+         * */
+        bool push(uint64_t now, const void* data, size_t size) noexcept;
+        /**
+         * Метод извлекает пакет, время доставки которого наступило к моменту now.
+         * @return false, если таких пакетов нет.
+         * */
+        bool pop(uint64_t now, void* buffer, size_t& size) noexcept;
+
+        uint64_t droppedCount() const noexcept { return m_droppedCount; }
+
+    private:
+        struct Packet {
+            uint64_t deliveryTime;
+            size_t size;
+            std::array<uint8_t, MAX_PACKET_SIZE> data;
+        };
+
+        Settings m_settings;
+        Random m_random;
+        std::array<Packet, CAPACITY> m_packets;
+        size_t m_count;
+        uint64_t m_droppedCount;
+    };
+}
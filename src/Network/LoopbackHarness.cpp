@@ -0,0 +1,91 @@
+#include "LoopbackHarness.h"
+
+#include "UdpSocket.h"
+#include "../Game/Game.h"
+#include "../Game/Random.h"
+
+#include <chrono>
+
+namespace Network {
+
+    namespace {
+        /**
+         * Бот держит случайное направление случайное количество шагов и иногда стреляет.
+         * */
+        class InputBot {
+        public:
+            explicit InputBot(const uint64_t seed) noexcept : m_random(seed), m_direction(0), m_ticksLeft(0) {}
+
+            uint8_t next() noexcept {
+                if (m_ticksLeft == 0) {
+                    static constexpr uint8_t DIRECTIONS[] = { 0, Game::Up, Game::Down, Game::Left, Game::Right };
+                    m_direction = DIRECTIONS[m_random.nextInt(5)];
+                    m_ticksLeft = 10 + m_random.nextInt(50);
+                }
+                --m_ticksLeft;
+                return m_direction | (m_random.nextInt(20) == 0 ? Game::Fire : 0);
+            }
+
+        private:
+            Random m_random;
+            uint8_t m_direction;
+            uint32_t m_ticksLeft;
+        };
+
+        constexpr uint32_t LOCALHOST = 0x7F000001;
+    }
+
+    LoopbackHarness::Result LoopbackHarness::run(Game& first, Game& second, const Settings& settings) {
+        UdpSocket firstSocket({ LOCALHOST, 0 });
+        UdpSocket secondSocket({ LOCALHOST, 0 });
+
+        InputBot firstBot(settings.seed * 2 + 1);
+        InputBot secondBot(settings.seed * 2 + 2);
+
+        RollbackSession::Settings sessionSettings;
+        sessionSettings.inputDelay = settings.inputDelay;
+        sessionSettings.link = settings.link;
+        sessionSettings.seed = settings.seed;
+
+        sessionSettings.localPlayer = 0;
+        RollbackSession firstSession(first, firstSocket, secondSocket.getLocalAddress(), sessionSettings,
+                                     [&firstBot] { return firstBot.next(); });
+        sessionSettings.localPlayer = 1;
+        RollbackSession secondSession(second, secondSocket, firstSocket.getLocalAddress(), sessionSettings,
+                                      [&secondBot] { return secondBot.next(); });
+
+        const auto start = std::chrono::steady_clock::now();
+        uint64_t now = 0;
+        for (uint64_t frame = 0; frame < settings.ticks; ++frame) {
+            firstSession.advanceTick(now);
+            secondSession.advanceTick(now);
+            now += Game::TICK_DURATION;
+        }
+        // Отстающая сторона догоняет, затем стороны только обмениваются пакетами, пока весь
+        // ввод не будет подтвержден и откачен при необходимости.
+        const uint64_t lastTick = std::max(firstSession.getCurrentTick(), secondSession.getCurrentTick());
+        for (uint64_t frame = 0; frame < 10 * 60; ++frame) {
+            if (firstSession.getConfirmedTick() == lastTick && secondSession.getConfirmedTick() == lastTick) {
+                break;
+            }
+            for (RollbackSession* pSession : { &firstSession, &secondSession }) {
+                if (pSession->getCurrentTick() < lastTick) {
+                    pSession->advanceTick(now);
+                } else {
+                    pSession->poll(now);
+                }
+            }
+            now += Game::TICK_DURATION;
+        }
+
+        Result result;
+        result.elapsedNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start).count();
+        result.stats[0] = firstSession.getStats();
+        result.stats[1] = secondSession.getStats();
+        result.confirmedTick = std::min(firstSession.getConfirmedTick(), secondSession.getConfirmedTick());
+        result.finalHashes[0] = first.getStateHash();
+        result.finalHashes[1] = second.getStateHash();
+        return result;
+    }
+}
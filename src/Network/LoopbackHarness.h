@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+
+#include "RollbackSession.h"
+#include "LinkConditioner.h"
+
+class Game;
+
+namespace Network {
+
+    /**
+     * Проверка сетевой игры на одной машине: две игры в одном процессе обмениваются вводом
+     * через UDP сокеты на 127.0.0.1, принятые пакеты проходят через LinkConditioner.
+     * Игроками управляют боты со случайным, но воспроизводимым вводом. Время виртуальное,
+     * поэтому проверка идет быстрее реального времени, а задержка канала соблюдается точно.
+     * */
+    class LoopbackHarness {
+    public:
+        struct Settings {
+            uint64_t ticks = 60 * 60;
+            unsigned int inputDelay = 2;
+            // По умолчанию RTT 150 мс с разбросом и потерей пакетов.
+            LinkConditioner::Settings link = { 75, 10, 5 };
+            uint64_t seed = 0;
+        };
+
+        struct Result {
+            RollbackSession::Stats stats[2];
+            // Шаг, до которого обе игры подтверждены, и хеши их состояния в конце проверки.
+            uint64_t confirmedTick = 0;
+            uint64_t finalHashes[2] = { 0, 0 };
+            uint64_t elapsedNs = 0;
+        };
+
+        LoopbackHarness() = delete;
+
+        /**
+         * Метод проводит сетевую игру между first и second. Обе игры должны быть
+         * инициализированы для двух игроков с одинаковым начальным числом.
+         * @throw Exception::Exception если не удалось открыть сокеты.
+         * */
+        static Result run(Game& first, Game& second, const Settings& settings);
+    };
+}
@@ -0,0 +1,324 @@
+#include "RollbackSession.h"
+
+#include "../Game/GameSnapshot.h"
+
+#include <chrono>
+
+namespace Network {
+
+    namespace {
+        // Формат пакета (little-endian):
+        // u16 сигнатура, u8 версия, u32 текущий шаг отправителя, i8 опережение отправителя,
+        // u32 подтвержденный ввод получателя, u32 шаг и u64 хеш подтвержденного состояния,
+        // u32 первый шаг ввода, u8 количество масок, маски.
+        constexpr uint16_t PACKET_MAGIC = 0x4342;
+        constexpr uint8_t PACKET_VERSION = 1;
+        constexpr size_t PACKET_HEADER_SIZE = 2 + 1 + 4 + 1 + 4 + 4 + 8 + 4 + 1;
+        constexpr unsigned int MAX_INPUTS_PER_PACKET = 64;
+        constexpr size_t MAX_PACKET_SIZE = PACKET_HEADER_SIZE + MAX_INPUTS_PER_PACKET;
+
+        uint64_t getTimeNs() {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+        class PacketWriter {
+        public:
+            explicit PacketWriter(uint8_t* pData) noexcept : m_pData(pData), m_size(0) {}
+
+            template<typename T>
+            void write(const T value) noexcept {
+                for (size_t i = 0; i < sizeof(T); ++i) {
+                    m_pData[m_size++] = static_cast<uint8_t>(static_cast<uint64_t>(value) >> (8 * i));
+                }
+            }
+            size_t size() const noexcept { return m_size; }
+
+        private:
+            uint8_t* m_pData;
+            size_t m_size;
+        };
+
+        class PacketReader {
+        public:
+            PacketReader(const uint8_t* pData, const size_t size) noexcept : m_pData(pData), m_size(size), m_offset(0) {}
+
+            template<typename T>
+            bool read(T& value) noexcept {
+                if (m_offset + sizeof(T) > m_size) {
+                    return false;
+                }
+                uint64_t result = 0;
+                for (size_t i = 0; i < sizeof(T); ++i) {
+                    result |= static_cast<uint64_t>(m_pData[m_offset++]) << (8 * i);
+                }
+                value = static_cast<T>(result);
+                return true;
+            }
+            const uint8_t* current() const noexcept { return m_pData + m_offset; }
+            size_t remaining() const noexcept { return m_size - m_offset; }
+
+        private:
+            const uint8_t* m_pData;
+            size_t m_size;
+            size_t m_offset;
+        };
+    }
+
+    RollbackSession::RollbackSession(Game& game, UdpSocket& socket, const Address& peer,
+                                     const Settings& settings, LocalInputSource localInputSource) :
+                                     m_game(game),
+                                     m_socket(socket),
+                                     m_peer(peer),
+                                     m_settings(settings),
+                                     m_localInputSource(std::move(localInputSource)),
+                                     m_linkConditioner(settings.link, settings.seed ^ (settings.localPlayer + 1)),
+                                     m_localInputEnd(settings.inputDelay),
+                                     m_snapshots(SNAPSHOTS_COUNT) {
+        if (! m_localInputSource) {
+            m_localInputSource = [this] { return m_game.pollLocalInput(); };
+        }
+        // В первых inputDelay шагах локальный игрок ничего не нажимает.
+        m_localInputs.fill(0);
+        m_remoteInputs.fill(0);
+        m_usedRemoteInputs.fill(0);
+        // Игра уже создала карту: снимки размечаются сейчас, а не посреди отката.
+        for (GameSnapshot& snapshot : m_snapshots) {
+            m_game.prepareSnapshot(snapshot);
+        }
+    }
+
+    RollbackSession::~RollbackSession() {}
+
+    void RollbackSession::update(const uint64_t delta, const uint64_t now) {
+        m_tickAccumulator = std::min(m_tickAccumulator + delta, 8 * Game::TICK_DURATION);
+        while (m_tickAccumulator >= Game::TICK_DURATION) {
+            m_tickAccumulator -= Game::TICK_DURATION;
+            advanceTick(now);
+        }
+    }
+
+    RollbackSession::FrameStats RollbackSession::advanceTick(const uint64_t now) {
+        const uint64_t frameStart = getTimeNs();
+        FrameStats frameStats;
+
+        synchronize(now, frameStats);
+        if (shouldStall()) {
+            frameStats.stalled = true;
+            ++m_stats.stalls;
+        } else {
+            m_localInputs[m_localInputEnd % INPUT_BUFFER_SIZE] = m_localInputSource();
+            ++m_localInputEnd;
+            simulate(m_currentTick);
+            ++m_currentTick;
+        }
+        sendInputs();
+
+        frameStats.frameNs = getTimeNs() - frameStart;
+        ++m_stats.frames;
+        m_stats.maxFrameNs = std::max(m_stats.maxFrameNs, frameStats.frameNs);
+        return frameStats;
+    }
+
+    RollbackSession::FrameStats RollbackSession::poll(const uint64_t now) {
+        const uint64_t frameStart = getTimeNs();
+        FrameStats frameStats;
+        synchronize(now, frameStats);
+        sendInputs();
+        frameStats.frameNs = getTimeNs() - frameStart;
+        return frameStats;
+    }
+
+    void RollbackSession::synchronize(const uint64_t now, FrameStats& frameStats) {
+        receivePackets(now);
+        if (m_rollbackTick < m_currentTick) {
+            rollback(m_rollbackTick, frameStats);
+        }
+        m_rollbackTick = UINT64_MAX;
+        checkRemoteStateHash();
+    }
+
+    bool RollbackSession::shouldStall() noexcept {
+        // Дальше предсказывать нельзя: снимка для отката уже не будет.
+        if (m_currentTick >= m_remoteInputEnd + MAX_PREDICTION_TICKS) {
+            return true;
+        }
+        // Неподтвержденный локальный ввод должен помещаться в кольцевой буфер.
+        if (m_localInputEnd + 1 - m_remoteAck >= INPUT_BUFFER_SIZE) {
+            return true;
+        }
+        // Выравнивание темпа: обе стороны видят друг друга с одинаковой задержкой, поэтому
+        // половина разности опережений - насколько эта сторона действительно впереди.
+        if (m_remoteTick > 0 && m_currentTick >= m_lastTimeSyncTick + TIME_SYNC_INTERVAL) {
+            const auto localAdvantage = static_cast<int64_t>(m_currentTick) - static_cast<int64_t>(m_remoteTick);
+            if (localAdvantage - m_remoteAdvantage >= 2) {
+                m_lastTimeSyncTick = m_currentTick;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void RollbackSession::receivePackets(const uint64_t now) {
+        uint8_t buffer[LinkConditioner::MAX_PACKET_SIZE];
+        Address source;
+        size_t size = 0;
+        while (m_socket.receiveFrom(source, buffer, sizeof(buffer), size)) {
+            if (source != m_peer) {
+                continue;
+            }
+            ++m_stats.packetsReceived;
+            if (m_linkConditioner.isEnabled()) {
+                m_linkConditioner.push(now, buffer, size);
+            } else {
+                handlePacket(buffer, size);
+            }
+        }
+        while (m_linkConditioner.pop(now, buffer, size)) {
+            handlePacket(buffer, size);
+        }
+        m_stats.packetsDropped = m_linkConditioner.droppedCount();
+    }
+
+    void RollbackSession::handlePacket(const uint8_t* data, const size_t size) {
+        PacketReader reader(data, size);
+        uint16_t magic = 0;
+        uint8_t version = 0;
+        uint32_t remoteTick = 0;
+        int8_t remoteAdvantage = 0;
+        uint32_t ack = 0;
+        uint32_t hashTick = 0;
+        uint64_t hash = 0;
+        uint32_t firstTick = 0;
+        uint8_t count = 0;
+        if (! reader.read(magic) || magic != PACKET_MAGIC || ! reader.read(version) || version != PACKET_VERSION ||
+            ! reader.read(remoteTick) || ! reader.read(remoteAdvantage) || ! reader.read(ack) ||
+            ! reader.read(hashTick) || ! reader.read(hash) || ! reader.read(firstTick) || ! reader.read(count) ||
+            reader.remaining() < count) {
+            return;
+        }
+
+        // Пакеты могут приходить не по порядку: учитываем только самые свежие сведения.
+        if (remoteTick >= m_remoteTick) {
+            m_remoteTick = remoteTick;
+            m_remoteAdvantage = remoteAdvantage;
+        }
+        m_remoteAck = std::max<uint64_t>(m_remoteAck, ack);
+        if (hashTick > m_pendingRemoteHash.tick && hashTick > m_lastCheckedHashTick) {
+            m_pendingRemoteHash = { hashTick, hash };
+        }
+
+        const uint8_t* inputs = reader.current();
+        for (uint64_t tick = std::max<uint64_t>(firstTick, m_remoteInputEnd); tick < firstTick + count; ++tick) {
+            if (tick != m_remoteInputEnd || tick >= m_currentTick + INPUT_BUFFER_SIZE - MAX_PREDICTION_TICKS) {
+                break;
+            }
+            const uint8_t input = inputs[tick - firstTick];
+            const size_t index = tick % INPUT_BUFFER_SIZE;
+            m_remoteInputs[index] = input;
+            if (tick < m_currentTick && m_usedRemoteInputs[index] != input) {
+                m_rollbackTick = std::min(m_rollbackTick, tick);
+            }
+            ++m_remoteInputEnd;
+        }
+    }
+
+    void RollbackSession::sendInputs() {
+        uint8_t buffer[MAX_PACKET_SIZE];
+        PacketWriter writer(buffer);
+        const uint64_t firstTick = m_remoteAck;
+        const auto count = static_cast<uint8_t>(std::min<uint64_t>(m_localInputEnd - firstTick, MAX_INPUTS_PER_PACKET));
+        const auto advantage = static_cast<int64_t>(m_currentTick) - static_cast<int64_t>(m_remoteTick);
+
+        StateHash confirmedHash;
+        for (const StateHash& stateHash : m_stateHashes) {
+            if (stateHash.tick > confirmedHash.tick && stateHash.tick <= m_remoteInputEnd) {
+                confirmedHash = stateHash;
+            }
+        }
+
+        writer.write(PACKET_MAGIC);
+        writer.write(PACKET_VERSION);
+        writer.write(static_cast<uint32_t>(m_currentTick));
+        writer.write(static_cast<int8_t>(std::max<int64_t>(std::min<int64_t>(advantage, INT8_MAX), INT8_MIN)));
+        writer.write(static_cast<uint32_t>(m_remoteInputEnd));
+        writer.write(static_cast<uint32_t>(confirmedHash.tick));
+        writer.write(confirmedHash.hash);
+        writer.write(static_cast<uint32_t>(firstTick));
+        writer.write(count);
+        for (uint64_t tick = firstTick; tick < firstTick + count; ++tick) {
+            writer.write(m_localInputs[tick % INPUT_BUFFER_SIZE]);
+        }
+        if (m_socket.sendTo(m_peer, buffer, writer.size())) {
+            ++m_stats.packetsSent;
+        }
+    }
+
+    uint8_t RollbackSession::predictRemoteInput() const noexcept {
+        if (m_remoteInputEnd == 0) {
+            return 0;
+        }
+        // Движение обычно продолжается, а выстрел - однократное нажатие.
+        return m_remoteInputs[(m_remoteInputEnd - 1) % INPUT_BUFFER_SIZE] & ~Game::Fire;
+    }
+
+    void RollbackSession::simulate(const uint64_t tick) {
+        m_game.saveSnapshot(m_snapshots[tick % SNAPSHOTS_COUNT]);
+
+        const size_t index = tick % INPUT_BUFFER_SIZE;
+        const uint8_t remoteInput = tick < m_remoteInputEnd ? m_remoteInputs[index] : predictRemoteInput();
+        m_usedRemoteInputs[index] = remoteInput;
+
+        Game::PlayerInputs inputs{};
+        inputs[m_settings.localPlayer] = m_localInputs[index];
+        inputs[1 - m_settings.localPlayer] = remoteInput;
+        m_game.simulateTick(inputs);
+
+        if ((tick + 1) % STATE_HASH_INTERVAL == 0) {
+            m_stateHashes[(tick + 1) / STATE_HASH_INTERVAL % STATE_HASHES_COUNT] = { tick + 1, m_game.getStateHash() };
+        }
+    }
+
+    void RollbackSession::rollback(const uint64_t fromTick, FrameStats& frameStats) {
+        const uint64_t start = getTimeNs();
+        m_game.restoreSnapshot(m_snapshots[fromTick % SNAPSHOTS_COUNT]);
+        for (uint64_t tick = fromTick; tick < m_currentTick; ++tick) {
+            simulate(tick);
+        }
+        frameStats.rollbackTicks = static_cast<uint32_t>(m_currentTick - fromTick);
+        frameStats.resimulationNs = getTimeNs() - start;
+
+        ++m_stats.rollbacks;
+        m_stats.rollbackTicks += frameStats.rollbackTicks;
+        m_stats.maxRollbackTicks = std::max(m_stats.maxRollbackTicks, frameStats.rollbackTicks);
+        m_stats.resimulationNs += frameStats.resimulationNs;
+        m_stats.maxResimulationNs = std::max(m_stats.maxResimulationNs, frameStats.resimulationNs);
+    }
+
+    const RollbackSession::StateHash* RollbackSession::findConfirmedStateHash(const uint64_t tick) const noexcept {
+        const StateHash& stateHash = m_stateHashes[tick / STATE_HASH_INTERVAL % STATE_HASHES_COUNT];
+        if (stateHash.tick != tick || tick > m_remoteInputEnd || tick > m_currentTick) {
+            return nullptr;
+        }
+        return &stateHash;
+    }
+
+    void RollbackSession::checkRemoteStateHash() {
+        if (m_pendingRemoteHash.tick == 0) {
+            return;
+        }
+        const StateHash* pLocalHash = findConfirmedStateHash(m_pendingRemoteHash.tick);
+        if (pLocalHash) {
+            m_lastCheckedHashTick = m_pendingRemoteHash.tick;
+            ++m_stats.checkedHashes;
+            if (pLocalHash->hash != m_pendingRemoteHash.hash) {
+                ++m_stats.desyncs;
+            }
+            m_pendingRemoteHash.tick = 0;
+        } else if (m_pendingRemoteHash.tick + STATE_HASH_INTERVAL * (STATE_HASHES_COUNT - 1) < m_currentTick) {
+            // Свой хеш для этого шага уже вытеснен из кольца, сверить не с чем.
+            m_lastCheckedHashTick = m_pendingRemoteHash.tick;
+            m_pendingRemoteHash.tick = 0;
+        }
+    }
+}
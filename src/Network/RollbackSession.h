@@ -0,0 +1,169 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "UdpSocket.h"
+#include "LinkConditioner.h"
+#include "../Game/Game.h"
+
+struct GameSnapshot;
+
+namespace Network {
+
+    /**
+     * Сетевая игра вдвоем с откатом. По сети передаются только маски кнопок игроков. Ввод
+     * удаленного игрока, который еще не пришел, предсказывается (повторяется последний
+     * известный без выстрела), и симуляция идет дальше без ожидания. Когда настоящий ввод
+     * отличается от предсказанного, игра восстанавливается из снимка шага расхождения и
+     * шаги до текущего выполняются заново. Снимки и буферы ввода выделяются один раз.
+     *
+     * Каждый пакет повторяет все локальные маски, которые удаленная сторона еще не
+     * подтвердила, поэтому потеря отдельных пакетов не требует повторной отправки.
+     * */
+    class RollbackSession {
+    public:
+        // Возвращает маску Game::EInputButton локального игрока для очередного шага.
+        using LocalInputSource = std::function<uint8_t()>;
+
+        struct Settings {
+            // Номер игрока этой стороны: 0 или 1.
+            unsigned int localPlayer = 0;
+            // Задержка локального ввода в шагах. Уменьшает глубину откатов ценой отклика.
+            unsigned int inputDelay = 2;
+            // Имитация плохого канала для принятых пакетов.
+            LinkConditioner::Settings link;
+            uint64_t seed = 0;
+        };
+
+        struct FrameStats {
+            // Сколько шагов выполнено заново из-за отката.
+            uint32_t rollbackTicks = 0;
+            uint64_t resimulationNs = 0;
+            // Полное время шага: прием пакетов, откат, новый шаг, отправка.
+            uint64_t frameNs = 0;
+            // Шаг пропущен, чтобы дождаться удаленной стороны.
+            bool stalled = false;
+        };
+
+        struct Stats {
+            uint64_t frames = 0;
+            uint64_t rollbacks = 0;
+            uint64_t rollbackTicks = 0;
+            uint32_t maxRollbackTicks = 0;
+            uint64_t resimulationNs = 0;
+            uint64_t maxResimulationNs = 0;
+            uint64_t maxFrameNs = 0;
+            uint64_t stalls = 0;
+            uint64_t packetsSent = 0;
+            uint64_t packetsReceived = 0;
+            uint64_t packetsDropped = 0;
+            // Сверка хешей подтвержденного состояния с удаленной стороной.
+            uint64_t checkedHashes = 0;
+            uint64_t desyncs = 0;
+        };
+
+        // Насколько шагов симуляция может уйти вперед от последнего подтвержденного ввода.
+        // 12 шагов (200 мс) покрывают задержку в одну сторону 75 мс (RTT 150 мс) с запасом на разброс.
+        static constexpr unsigned int MAX_PREDICTION_TICKS = 12;
+
+        RollbackSession() = delete;
+        RollbackSession(const RollbackSession&) = delete;
+        RollbackSession& operator=(const RollbackSession&) = delete;
+
+        /**
+         * @param game игра, инициализированная для двух игроков.
+         * @param socket сокет, через который идет обмен с peer.
+         * @param peer адрес удаленной стороны.
+         * @param localInputSource источник локального ввода, по умолчанию Game::pollLocalInput().
+         * */
+        RollbackSession(Game& game, UdpSocket& socket, const Address& peer,
+                        const Settings& settings, LocalInputSource localInputSource = nullptr);
+        ~RollbackSession();
+
+        /**
+         * Метод продвигает игру на delta наносекунд реального времени шагами Game::TICK_DURATION.
+         * @param now текущее время в наносекундах (для имитации канала).
+         * */
+        void update(uint64_t delta, uint64_t now);
+        /**
+         * Метод выполняет один шаг сетевой игры: принимает пакеты, при необходимости откатывает
+         * и заново симулирует игру, выполняет новый шаг и отправляет ввод.
+         * */
+        FrameStats advanceTick(uint64_t now);
+        /**
+         * Метод принимает пакеты, выполняет откат и отправляет ввод, не начиная новый шаг.
+         * */
+        FrameStats poll(uint64_t now);
+
+        uint64_t getCurrentTick() const noexcept { return m_currentTick; }
+        // Шаги меньше этого номера выполнены с настоящим вводом обоих игроков.
+        uint64_t getConfirmedTick() const noexcept { return std::min(m_remoteInputEnd, m_currentTick); }
+        const Stats& getStats() const noexcept { return m_stats; }
+
+    private:
+        static constexpr unsigned int INPUT_BUFFER_SIZE = 64;
+        static constexpr unsigned int SNAPSHOTS_COUNT = MAX_PREDICTION_TICKS + 1;
+        static constexpr unsigned int STATE_HASHES_COUNT = 8;
+        // Как часто сверяется хеш подтвержденного состояния.
+        static constexpr uint64_t STATE_HASH_INTERVAL = 30;
+        // Минимальный интервал между пропусками шагов для выравнивания темпа сторон.
+        static constexpr uint64_t TIME_SYNC_INTERVAL = 8;
+
+        struct StateHash {
+            uint64_t tick = 0;
+            uint64_t hash = 0;
+        };
+
+        void synchronize(uint64_t now, FrameStats& frameStats);
+        void receivePackets(uint64_t now);
+        void handlePacket(const uint8_t* data, size_t size);
+        void sendInputs();
+        void simulate(uint64_t tick);
+        void rollback(uint64_t fromTick, FrameStats& frameStats);
+        void checkRemoteStateHash();
+        bool shouldStall() noexcept;
+        uint8_t predictRemoteInput() const noexcept;
+        const StateHash* findConfirmedStateHash(uint64_t tick) const noexcept;
+
+    private:
+        Game& m_game;
+        UdpSocket& m_socket;
+        Address m_peer;
+        Settings m_settings;
+        LocalInputSource m_localInputSource;
+        LinkConditioner m_linkConditioner;
+
+        uint64_t m_tickAccumulator = 0;
+        uint64_t m_currentTick = 0;
+        // Локальный ввод известен для шагов меньше m_localInputEnd.
+        uint64_t m_localInputEnd;
+        // Ввод удаленного игрока подтвержден для шагов меньше m_remoteInputEnd.
+        uint64_t m_remoteInputEnd = 0;
+        // Удаленная сторона подтвердила наш ввод для шагов меньше m_remoteAck.
+        uint64_t m_remoteAck = 0;
+        // Самый ранний шаг, для которого пришел ввод, отличающийся от использованного.
+        uint64_t m_rollbackTick = UINT64_MAX;
+
+        // Последний шаг и опережение удаленной стороны по ее пакетам.
+        uint64_t m_remoteTick = 0;
+        int32_t m_remoteAdvantage = 0;
+        uint64_t m_lastTimeSyncTick = 0;
+
+        std::array<uint8_t, INPUT_BUFFER_SIZE> m_localInputs;
+        std::array<uint8_t, INPUT_BUFFER_SIZE> m_remoteInputs;
+        // Ввод удаленного игрока, с которым шаг был выполнен (подтвержденный или предсказанный).
+        std::array<uint8_t, INPUT_BUFFER_SIZE> m_usedRemoteInputs;
+        std::vector<GameSnapshot> m_snapshots;
+
+        std::array<StateHash, STATE_HASHES_COUNT> m_stateHashes;
+        StateHash m_pendingRemoteHash;
+        uint64_t m_lastCheckedHashTick = 0;
+
+        Stats m_stats;
+    };
+}
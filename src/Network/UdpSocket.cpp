@@ -0,0 +1,157 @@
+#include "UdpSocket.h"
+
+#include "../Exception/Exception.h"
+
+#ifdef _WIN32
+    #include <winsock2.h>
+    #include <ws2tcpip.h>
+#else
+    #include <arpa/inet.h>
+    #include <fcntl.h>
+    #include <netdb.h>
+    #include <netinet/in.h>
+    #include <sys/socket.h>
+    #include <unistd.h>
+#endif
+
+#include <cstring>
+
+namespace Network {
+
+    namespace {
+#ifdef _WIN32
+        using SocketHandle = SOCKET;
+        const intptr_t INVALID_HANDLE = static_cast<intptr_t>(INVALID_SOCKET);
+
+        /**
+         * Winsock инициализируется один раз при первом создании сокета.
+         * */
+        void initSockets() {
+            static const bool initialized = [] {
+                WSADATA data;
+                return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+            }();
+            if (! initialized) {
+                throw Exception::Exception("WSAStartup failed");
+            }
+        }
+
+        void closeSocket(const intptr_t handle) {
+            closesocket(static_cast<SocketHandle>(handle));
+        }
+
+        bool setNonBlocking(const intptr_t handle) {
+            u_long nonBlocking = 1;
+            return ioctlsocket(static_cast<SocketHandle>(handle), FIONBIO, &nonBlocking) == 0;
+        }
+#else
+        using SocketHandle = int;
+        const intptr_t INVALID_HANDLE = -1;
+
+        void initSockets() {}
+
+        void closeSocket(const intptr_t handle) {
+            close(static_cast<SocketHandle>(handle));
+        }
+
+        bool setNonBlocking(const intptr_t handle) {
+            const int flags = fcntl(static_cast<SocketHandle>(handle), F_GETFL, 0);
+            return flags != -1 && fcntl(static_cast<SocketHandle>(handle), F_SETFL, flags | O_NONBLOCK) == 0;
+        }
+#endif
+
+        sockaddr_in toSockaddr(const Address& address) {
+            sockaddr_in result;
+            std::memset(&result, 0, sizeof(result));
+            result.sin_family = AF_INET;
+            result.sin_addr.s_addr = htonl(address.ip);
+            result.sin_port = htons(address.port);
+            return result;
+        }
+
+        Address fromSockaddr(const sockaddr_in& address) {
+            return { ntohl(address.sin_addr.s_addr), ntohs(address.sin_port) };
+        }
+    }
+
+    std::string Address::toString() const {
+        return std::to_string(ip >> 24) + "." + std::to_string((ip >> 16) & 0xFF) + "." +
+               std::to_string((ip >> 8) & 0xFF) + "." + std::to_string(ip & 0xFF) + ":" + std::to_string(port);
+    }
+
+    Address Address::parse(const std::string& hostAndPort) {
+        const size_t colon = hostAndPort.rfind(':');
+        if (colon == std::string::npos || colon + 1 == hostAndPort.size()) {
+            throw Exception::Exception("Expected host:port, got: " + hostAndPort);
+        }
+        const std::string host = hostAndPort.substr(0, colon);
+        unsigned long port = 0;
+        try {
+            port = std::stoul(hostAndPort.substr(colon + 1));
+        } catch (const std::exception&) {
+            port = 65536;
+        }
+        if (port > 65535) {
+            throw Exception::Exception("Invalid port in address: " + hostAndPort);
+        }
+
+        initSockets();
+        addrinfo hints;
+        std::memset(&hints, 0, sizeof(hints));
+        hints.ai_family = AF_INET;
+        hints.ai_socktype = SOCK_DGRAM;
+        addrinfo* pResult = nullptr;
+        if (getaddrinfo(host.empty() ? "0.0.0.0" : host.c_str(), nullptr, &hints, &pResult) != 0 || ! pResult) {
+            throw Exception::Exception("Can't resolve host: " + host);
+        }
+        Address address = fromSockaddr(*reinterpret_cast<const sockaddr_in*>(pResult->ai_addr));
+        freeaddrinfo(pResult);
+        address.port = static_cast<uint16_t>(port);
+        return address;
+    }
+
+    UdpSocket::UdpSocket(const Address& bindAddress) {
+        initSockets();
+        m_socket = static_cast<intptr_t>(socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP));
+        if (m_socket == INVALID_HANDLE) {
+            throw Exception::Exception("Can't create UDP socket");
+        }
+        const sockaddr_in address = toSockaddr(bindAddress);
+        if (bind(static_cast<SocketHandle>(m_socket), reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+            closeSocket(m_socket);
+            throw Exception::Exception("Can't bind UDP socket to " + bindAddress.toString());
+        }
+        if (! setNonBlocking(m_socket)) {
+            closeSocket(m_socket);
+            throw Exception::Exception("Can't make UDP socket non-blocking");
+        }
+        sockaddr_in localAddress;
+        socklen_t localAddressSize = sizeof(localAddress);
+        getsockname(static_cast<SocketHandle>(m_socket), reinterpret_cast<sockaddr*>(&localAddress), &localAddressSize);
+        m_localAddress = fromSockaddr(localAddress);
+    }
+
+    UdpSocket::~UdpSocket() {
+        closeSocket(m_socket);
+    }
+
+    bool UdpSocket::sendTo(const Address& address, const void* data, const size_t size) noexcept {
+        const sockaddr_in target = toSockaddr(address);
+        const auto sent = sendto(static_cast<SocketHandle>(m_socket), static_cast<const char*>(data),
+                                 static_cast<int>(size), 0, reinterpret_cast<const sockaddr*>(&target), sizeof(target));
+        return sent >= 0 && static_cast<size_t>(sent) == size;
+    }
+
+    bool UdpSocket::receiveFrom(Address& address, void* buffer, const size_t capacity, size_t& size) noexcept {
+        sockaddr_in source;
+        socklen_t sourceSize = sizeof(source);
+        const auto received = recvfrom(static_cast<SocketHandle>(m_socket), static_cast<char*>(buffer),
+                                       static_cast<int>(capacity), 0, reinterpret_cast<sockaddr*>(&source), &sourceSize);
+        if (received < 0) {
+            return false;
+        }
+        address = fromSockaddr(source);
+        size = static_cast<size_t>(received);
+        return true;
+    }
+}
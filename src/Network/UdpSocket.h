@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace Network {
+
+    /**
+     * Адрес IPv4 и порт в порядке байтов хоста.
+     * */
+    struct Address {
+        uint32_t ip = 0;
+        uint16_t port = 0;
+
+        bool operator==(const Address& other) const noexcept { return ip == other.ip && port == other.port; }
+        bool operator!=(const Address& other) const noexcept { return ! (*this == other); }
+        std::string toString() const;
+
+        /**
+         * Метод разбирает строку вида "host:port".
+         * @throw Exception::Exception если строка некорректна или имя не удалось разрешить.
+         * */
+        static Address parse(const std::string& hostAndPort);
+    };
+
+    /**
+     * Неблокирующий UDP сокет.
+     * */
+    class UdpSocket {
+    public:
+        UdpSocket() = delete;
+        UdpSocket(const UdpSocket&) = delete;
+        UdpSocket& operator=(const UdpSocket&) = delete;
+
+        /**
+         * @param bindAddress локальный адрес. Порт 0 - выбрать свободный порт.
+         * @throw Exception::Exception если сокет не удалось создать или привязать.
+         * */
+        explicit UdpSocket(const Address& bindAddress);
+        ~UdpSocket();
+
+        /**
+         * @return false, если датаграмму не удалось отправить (буфер системы заполнен).
+         * */
+        bool sendTo(const Address& address, const void* data, size_t size) noexcept;
+        /**
+         * Метод читает одну датаграмму, не дожидаясь ее появления.
+         * @return false, если датаграмм нет.
+         * */
+        bool receiveFrom(Address& address, void* buffer, size_t capacity, size_t& size) noexcept;
+        /**
+         * Метод возвращает фактический локальный адрес (с выбранным системой портом).
+         * */
+        const Address& getLocalAddress() const noexcept { return m_localAddress; }
+
+    private:
+        intptr_t m_socket;
+        Address m_localAddress;
+    };
+}
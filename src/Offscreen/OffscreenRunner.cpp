@@ -0,0 +1,314 @@
+#include "OffscreenRunner.h"
+
+#include "PngImage.h"
+#include "../Game/Game.h"
+#include "../Game/Replay.h"
+#include "../Renderer/FrameBuffer.h"
+#include "../Renderer/FrameCapture.h"
+#include "../Renderer/Renderer.h"
+#include "../Exception/Exception.h"
+#include "../Profiler/AllocationCounter.h"
+#include "../Profiler/Profiler.h"
+
+#include <rapidjson/ostreamwrapper.h>
+#include <rapidjson/prettywriter.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <utility>
+
+namespace {
+    uint64_t nowNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    double toMs(const uint64_t ns) {
+        return static_cast<double>(ns) / 1e6;
+    }
+
+    /**
+     * Ввод первого игрока в сценарии: танк меняет направление каждые полторы секунды и
+     * стреляет два раза в секунду, так что в кадрах есть движение, снаряды и разрушения.
+     * */
+    uint8_t getScriptedInput(const uint64_t frame) {
+        static constexpr uint8_t DIRECTIONS[] = { Game::Up, Game::Right, Game::Down, Game::Left };
+        uint8_t input = DIRECTIONS[(frame / 90) % 4];
+        if (frame % 30 == 0) {
+            input |= Game::Fire;
+        }
+        return input;
+    }
+
+    std::array<uint64_t, AllocationCounter::TAGS_COUNT> getAllocationCounts() noexcept {
+        std::array<uint64_t, AllocationCounter::TAGS_COUNT> counts;
+        for (size_t i = 0; i < counts.size(); ++i) {
+            counts[i] = AllocationCounter::getCounters(static_cast<AllocationCounter::ETag>(i)).count;
+        }
+        return counts;
+    }
+
+    std::string getFrameName(const uint64_t frame, const char* suffix) {
+        char name[64];
+        std::snprintf(name, sizeof(name), "frame_%05llu%s.png", static_cast<unsigned long long>(frame), suffix);
+        return name;
+    }
+}
+
+namespace Offscreen {
+
+    OffscreenRunner::OffscreenRunner(const Settings& settings) :
+                                     m_settings(settings),
+                                     m_lastFrameEndNs(0),
+                                     m_lastFrameAllocations{} {
+        std::error_code error;
+        std::filesystem::create_directories(m_settings.outputDirectory, error);
+        if (error) {
+            throw Exception::Exception("Can't create directory " + m_settings.outputDirectory + ": " + error.message());
+        }
+        m_settings.captureEvery = std::max(1u, m_settings.captureEvery);
+        m_pFrameBuffer = std::make_unique<RenderEngine::FrameBuffer>(m_settings.width, m_settings.height);
+        m_pFrameCapture = std::make_unique<RenderEngine::FrameCapture>(
+                m_settings.width, m_settings.height, [this](const uint64_t frame, const uint8_t* pPixels) {
+                    onFrameCaptured(frame, pPixels);
+                });
+    }
+
+    OffscreenRunner::~OffscreenRunner() = default;
+
+    OffscreenRunner::Result OffscreenRunner::run(Game& game) {
+        m_frames.clear();
+        m_captures.clear();
+        // Записи кадров не должны выделять память посреди замера.
+        m_frames.reserve(m_settings.replayPath.empty() ? m_settings.frames : 0);
+        Result result;
+
+        if (! m_settings.replayPath.empty()) {
+            ReplayPlayer replayPlayer(m_settings.replayPath);
+            game.setSeed(replayPlayer.getHeader().seed);
+            game.init();
+            m_pFrameBuffer->bind();
+            m_lastFrameEndNs = nowNs();
+            m_lastFrameAllocations = getAllocationCounts();
+            // Кадр профилировщика начинается перед шагом симуляции, как в основном цикле игры.
+            PROFILE_FRAME();
+            replayPlayer.play(game, [this](Game& replayedGame) {
+                renderFrame(replayedGame);
+                PROFILE_FRAME();
+            });
+        } else {
+            game.setSeed(m_settings.seed);
+            game.init();
+            m_pFrameBuffer->bind();
+            m_lastFrameEndNs = nowNs();
+            m_lastFrameAllocations = getAllocationCounts();
+            for (uint64_t frame = 0; frame < m_settings.frames; ++frame) {
+                PROFILE_FRAME();
+                Game::PlayerInputs inputs {};
+                inputs[0] = getScriptedInput(frame);
+                game.simulateTick(inputs);
+                renderFrame(game);
+            }
+        }
+        m_pFrameCapture->flush();
+        RenderEngine::FrameBuffer::unbind();
+
+        result.frames = m_frames.size();
+        result.capturedFrames = m_captures.size();
+        result.captureStalls = m_pFrameCapture->stalls();
+        for (const CaptureRecord& capture : m_captures) {
+            if (capture.golden == "match") {
+                ++result.goldenMatches;
+            } else if (capture.golden == "mismatch") {
+                ++result.goldenMismatches;
+            } else if (capture.golden == "missing") {
+                ++result.goldenMissing;
+            }
+        }
+        if (! m_frames.empty()) {
+            std::vector<double> frameTimes;
+            frameTimes.reserve(m_frames.size());
+            double total = 0.0;
+            for (const FrameRecord& frame : m_frames) {
+                frameTimes.push_back(frame.frameMs);
+                total += frame.frameMs;
+            }
+            result.averageFrameMs = total / static_cast<double>(frameTimes.size());
+            const size_t p99Index = (frameTimes.size() - 1) * 99 / 100;
+            std::nth_element(frameTimes.begin(), frameTimes.begin() + static_cast<std::ptrdiff_t>(p99Index),
+                             frameTimes.end());
+            result.p99FrameMs = frameTimes[p99Index];
+        }
+        for (size_t frame = WARMUP_FRAMES; frame < m_frames.size(); ++frame) {
+            result.steadyAllocations += m_frames[frame].allocations;
+            for (size_t i = 0; i < AllocationCounter::TAGS_COUNT; ++i) {
+                result.steadyAllocationsByTag[i] += m_frames[frame].allocationsByTag[i];
+            }
+            result.maxFrameAllocations = std::max(result.maxFrameAllocations, m_frames[frame].allocations);
+        }
+        writeReport(result);
+        return result;
+    }
+
+    void OffscreenRunner::renderFrame(Game& game) {
+        const uint64_t frameStart = nowNs();
+        FrameRecord record;
+        record.tick = game.getTickCount();
+        record.updateMs = toMs(frameStart - m_lastFrameEndNs);
+
+        game.render();
+        const uint64_t frame = m_frames.size();
+        if (frame % m_settings.captureEvery == 0) {
+            m_pFrameCapture->request(frame);
+        }
+        // Без буфера обмена кадры копились бы в очереди драйвера; glFlush отправляет кадр сразу.
+        glFlush();
+        const uint64_t frameEnd = nowNs();
+        record.renderMs = toMs(frameEnd - frameStart);
+        record.frameMs = record.updateMs + record.renderMs;
+        const std::array<uint64_t, AllocationCounter::TAGS_COUNT> allocations = getAllocationCounts();
+        for (size_t i = 0; i < allocations.size(); ++i) {
+            record.allocationsByTag[i] = allocations[i] - m_lastFrameAllocations[i];
+            record.allocations += record.allocationsByTag[i];
+        }
+        m_frames.push_back(record);
+
+        // Готовые кадры сохраняются вне замера кадра.
+        m_pFrameCapture->collect();
+        m_lastFrameEndNs = nowNs();
+        m_lastFrameAllocations = getAllocationCounts();
+    }
+
+    void OffscreenRunner::onFrameCaptured(const uint64_t frame, const uint8_t* pPixels) {
+        Image image;
+        image.width = m_settings.width;
+        image.height = m_settings.height;
+        image.pixels.assign(pPixels, pPixels + static_cast<size_t>(image.width) * image.height * 4);
+
+        CaptureRecord record;
+        record.frame = frame;
+        record.image = getFrameName(frame, "");
+        const std::filesystem::path outputDirectory(m_settings.outputDirectory);
+        if (! writePng((outputDirectory / record.image).string(), image)) {
+            std::cerr << "Can't write frame " << (outputDirectory / record.image).string() << std::endl;
+        }
+
+        if (! m_settings.goldenDirectory.empty()) {
+            Image golden;
+            if (! loadPng((std::filesystem::path(m_settings.goldenDirectory) / record.image).string(), golden)) {
+                record.golden = "missing";
+            } else {
+                Image diff;
+                const ImageDifference difference = compareImages(golden, image, m_settings.goldenTolerance, &diff);
+                record.differentPixels = difference.differentPixels;
+                record.maxDifference = difference.maxDifference;
+                record.golden = difference.differentPixels == 0 ? "match" : "mismatch";
+                if (difference.differentPixels > 0 && ! difference.sizeMismatch) {
+                    writePng((outputDirectory / getFrameName(frame, "_diff")).string(), diff);
+                }
+            }
+        }
+        m_captures.push_back(std::move(record));
+    }
+
+    void OffscreenRunner::writeReport(const Result& result) const {
+        const std::string path = (std::filesystem::path(m_settings.outputDirectory) / "report.json").string();
+        std::ofstream file(path, std::ios::out | std::ios::trunc);
+        if (! file.is_open()) {
+            throw Exception::Exception("Can't write offscreen report: " + path);
+        }
+        rapidjson::OStreamWrapper stream(file);
+        rapidjson::PrettyWriter<rapidjson::OStreamWrapper> writer(stream);
+        writer.StartObject();
+        writer.Key("renderer");
+        writer.String(RenderEngine::Renderer::getRendererStr().c_str());
+        writer.Key("source");
+        writer.String(m_settings.replayPath.empty() ? "script" : m_settings.replayPath.c_str());
+        writer.Key("width");
+        writer.Uint(m_settings.width);
+        writer.Key("height");
+        writer.Uint(m_settings.height);
+
+        writer.Key("summary");
+        writer.StartObject();
+        writer.Key("frames");
+        writer.Uint64(result.frames);
+        writer.Key("averageFrameMs");
+        writer.Double(result.averageFrameMs);
+        writer.Key("p99FrameMs");
+        writer.Double(result.p99FrameMs);
+        writer.Key("capturedFrames");
+        writer.Uint64(result.capturedFrames);
+        writer.Key("captureStalls");
+        writer.Uint64(result.captureStalls);
+        writer.Key("goldenMatches");
+        writer.Uint64(result.goldenMatches);
+        writer.Key("goldenMismatches");
+        writer.Uint64(result.goldenMismatches);
+        writer.Key("goldenMissing");
+        writer.Uint64(result.goldenMissing);
+        if (AllocationCounter::isEnabled()) {
+            writer.Key("steadyAllocations");
+            writer.Uint64(result.steadyAllocations);
+            writer.Key("maxFrameAllocations");
+            writer.Uint64(result.maxFrameAllocations);
+            writer.Key("steadyAllocationsByTag");
+            writer.StartObject();
+            for (size_t i = 0; i < AllocationCounter::TAGS_COUNT; ++i) {
+                writer.Key(AllocationCounter::getTagName(static_cast<AllocationCounter::ETag>(i)));
+                writer.Uint64(result.steadyAllocationsByTag[i]);
+            }
+            writer.EndObject();
+        }
+        writer.EndObject();
+
+        writer.Key("frames");
+        writer.StartArray();
+        for (const FrameRecord& frame : m_frames) {
+            writer.StartObject();
+            writer.Key("tick");
+            writer.Uint64(frame.tick);
+            writer.Key("updateMs");
+            writer.Double(frame.updateMs);
+            writer.Key("renderMs");
+            writer.Double(frame.renderMs);
+            writer.Key("frameMs");
+            writer.Double(frame.frameMs);
+            if (AllocationCounter::isEnabled()) {
+                writer.Key("allocations");
+                writer.Uint64(frame.allocations);
+            }
+            writer.EndObject();
+        }
+        writer.EndArray();
+
+        writer.Key("captures");
+        writer.StartArray();
+        for (const CaptureRecord& capture : m_captures) {
+            writer.StartObject();
+            writer.Key("frame");
+            writer.Uint64(capture.frame);
+            writer.Key("image");
+            writer.String(capture.image.c_str());
+            if (! capture.golden.empty()) {
+                writer.Key("golden");
+                writer.String(capture.golden.c_str());
+                writer.Key("differentPixels");
+                writer.Uint64(capture.differentPixels);
+                writer.Key("maxDifference");
+                writer.Uint(capture.maxDifference);
+            }
+            writer.EndObject();
+        }
+        writer.EndArray();
+        writer.EndObject();
+        file << std::endl;
+        if (! file) {
+            throw Exception::Exception("Can't write offscreen report: " + path);
+        }
+    }
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+#include "../Profiler/AllocationCounter.h"
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+class Game;
+
+namespace RenderEngine {
+    class FrameBuffer;
+    class FrameCapture;
+}
+
+namespace Offscreen {
+
+    /**
+     * Отрисовка игры без окна: повтор или сценарий с заранее заданным вводом выполняется шаг за
+     * шагом, каждый шаг рисуется в буфер кадра. Каждый captureEvery-й кадр читается асинхронно
+     * (FrameCapture), сохраняется в PNG и сравнивается с эталоном из goldenDirectory, при
+     * отличии рядом сохраняется карта отличий. Время каждого кадра и итоги сравнения
+     * записываются в report.json в outputDirectory. Контекст OpenGL должен быть текущим.
+     * */
+    class OffscreenRunner {
+    public:
+        OffscreenRunner(const OffscreenRunner&) = delete;
+        OffscreenRunner& operator=(const OffscreenRunner&) = delete;
+
+    public:
+        struct Settings {
+            std::string outputDirectory;
+            // Размер кадра; должен совпадать с размером окна, переданным в Game.
+            unsigned int width = 640;
+            unsigned int height = 480;
+            // Повтор для воспроизведения; если пусто, играется сценарий.
+            std::string replayPath;
+            uint64_t seed = 0;
+            // Длительность сценария в шагах (кадрах).
+            uint64_t frames = 600;
+            unsigned int captureEvery = 60;
+            // Каталог эталонных кадров с теми же именами файлов; пусто - без сравнения.
+            std::string goldenDirectory;
+            // Допустимая разница канала пикселя (0-255).
+            unsigned int goldenTolerance = 0;
+        };
+
+        struct Result {
+            uint64_t frames = 0;
+            uint64_t capturedFrames = 0;
+            uint64_t goldenMatches = 0;
+            uint64_t goldenMismatches = 0;
+            uint64_t goldenMissing = 0;
+            // Сколько раз запрос чтения кадра ждал видеокарту.
+            uint64_t captureStalls = 0;
+            double averageFrameMs = 0.0;
+            double p99FrameMs = 0.0;
+            // Выделения из общей кучи за кадр без первых WARMUP_FRAMES кадров (сборка с
+            // BATTLECITY_COUNT_ALLOCATIONS, иначе 0).
+            uint64_t steadyAllocations = 0;
+            uint64_t maxFrameAllocations = 0;
+            // steadyAllocations по подсистемам (AllocationCounter::ETag).
+            std::array<uint64_t, AllocationCounter::TAGS_COUNT> steadyAllocationsByTag {};
+        };
+
+        // Кадры, за которые заполняются пулы, буферы и арены; выделения в них не считаются
+        // выделениями установившейся игры.
+        static constexpr uint64_t WARMUP_FRAMES = 60;
+
+        /**
+         * @throw Exception::Exception, если каталог результатов не удалось создать.
+         * */
+        explicit OffscreenRunner(const Settings& settings);
+        ~OffscreenRunner();
+
+        /**
+         * Метод инициализирует игру, проигрывает повтор или сценарий и записывает отчет.
+         * @throw Exception::Exception, если повтор поврежден или отчет не удалось записать.
+         * */
+        Result run(Game& game);
+
+    private:
+        struct FrameRecord {
+            uint64_t tick = 0;
+            double updateMs = 0.0;
+            double renderMs = 0.0;
+            double frameMs = 0.0;
+            uint64_t allocations = 0;
+            std::array<uint64_t, AllocationCounter::TAGS_COUNT> allocationsByTag {};
+        };
+
+        struct CaptureRecord {
+            uint64_t frame = 0;
+            std::string image;
+            // "match", "mismatch", "missing" или пусто без сравнения.
+            std::string golden;
+            uint64_t differentPixels = 0;
+            unsigned int maxDifference = 0;
+        };
+
+        void renderFrame(Game& game);
+        void onFrameCaptured(uint64_t frame, const uint8_t* pPixels);
+        void writeReport(const Result& result) const;
+
+    private:
+        Settings m_settings;
+        std::unique_ptr<RenderEngine::FrameBuffer> m_pFrameBuffer;
+        std::unique_ptr<RenderEngine::FrameCapture> m_pFrameCapture;
+        std::vector<FrameRecord> m_frames;
+        std::vector<CaptureRecord> m_captures;
+        // Конец предыдущего кадра: время до следующего кадра уходит на шаг симуляции.
+        uint64_t m_lastFrameEndNs;
+        // Счетчики выделений по подсистемам на конец предыдущего кадра.
+        std::array<uint64_t, AllocationCounter::TAGS_COUNT> m_lastFrameAllocations;
+    };
+}
@@ -0,0 +1,429 @@
+#include "PngImage.h"
+
+#include "../ResourceManager/stb_image.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <unordered_map>
+
+namespace {
+    // Наибольший размер блока deflate типа stored.
+    constexpr size_t MAX_STORED_BLOCK = 65535;
+
+    const std::array<uint32_t, 256>& getCrcTable() {
+        static const std::array<uint32_t, 256> table = [] {
+            std::array<uint32_t, 256> result {};
+            for (uint32_t n = 0; n < 256; ++n) {
+                uint32_t c = n;
+                for (int k = 0; k < 8; ++k) {
+                    c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                }
+                result[n] = c;
+            }
+            return result;
+        }();
+        return table;
+    }
+
+    void appendU32(std::vector<uint8_t>& data, const uint32_t value) {
+        data.push_back(static_cast<uint8_t>(value >> 24));
+        data.push_back(static_cast<uint8_t>(value >> 16));
+        data.push_back(static_cast<uint8_t>(value >> 8));
+        data.push_back(static_cast<uint8_t>(value));
+    }
+
+    void writeChunk(std::ofstream& file, const char* type, const std::vector<uint8_t>& data) {
+        std::vector<uint8_t> chunk;
+        chunk.reserve(data.size() + 12);
+        appendU32(chunk, static_cast<uint32_t>(data.size()));
+        chunk.insert(chunk.end(), type, type + 4);
+        chunk.insert(chunk.end(), data.begin(), data.end());
+        // CRC считается по типу и данным чанка.
+        const std::array<uint32_t, 256>& crcTable = getCrcTable();
+        uint32_t crc = 0xFFFFFFFFu;
+        for (size_t i = 4; i < chunk.size(); ++i) {
+            crc = crcTable[(crc ^ chunk[i]) & 0xFF] ^ (crc >> 8);
+        }
+        appendU32(chunk, crc ^ 0xFFFFFFFFu);
+        file.write(reinterpret_cast<const char*>(chunk.data()), static_cast<std::streamsize>(chunk.size()));
+    }
+
+    void deflateStored(const std::vector<uint8_t>& raw, std::vector<uint8_t>& out) {
+        out.reserve(out.size() + raw.size() + raw.size() / MAX_STORED_BLOCK * 5 + 16);
+        size_t offset = 0;
+        do {
+            const size_t blockSize = std::min(MAX_STORED_BLOCK, raw.size() - offset);
+            const bool lastBlock = offset + blockSize == raw.size();
+            out.push_back(lastBlock ? 1 : 0);
+            out.push_back(static_cast<uint8_t>(blockSize));
+            out.push_back(static_cast<uint8_t>(blockSize >> 8));
+            out.push_back(static_cast<uint8_t>(~blockSize));
+            out.push_back(static_cast<uint8_t>(~blockSize >> 8));
+            out.insert(out.end(), raw.begin() + static_cast<std::ptrdiff_t>(offset),
+                       raw.begin() + static_cast<std::ptrdiff_t>(offset + blockSize));
+            offset += blockSize;
+        } while (offset < raw.size());
+    }
+
+    /**
+     * Запись битов deflate: данные и дополнительные биты пишутся от младшего бита, коды
+     * Хаффмана - от старшего.
+     * */
+    class BitWriter {
+    public:
+        explicit BitWriter(std::vector<uint8_t>& out) : m_out(out) {}
+
+        void write(const uint32_t bits, const unsigned int count) {
+            m_buffer |= bits << m_count;
+            m_count += count;
+            while (m_count >= 8) {
+                m_out.push_back(static_cast<uint8_t>(m_buffer));
+                m_buffer >>= 8;
+                m_count -= 8;
+            }
+        }
+
+        void writeCode(const uint32_t code, const unsigned int length) {
+            uint32_t reversed = 0;
+            for (unsigned int i = 0; i < length; ++i) {
+                reversed = (reversed << 1) | ((code >> i) & 1);
+            }
+            write(reversed, length);
+        }
+
+        void flush() {
+            if (m_count > 0) {
+                m_out.push_back(static_cast<uint8_t>(m_buffer));
+                m_buffer = 0;
+                m_count = 0;
+            }
+        }
+
+    private:
+        std::vector<uint8_t>& m_out;
+        uint32_t m_buffer = 0;
+        unsigned int m_count = 0;
+    };
+
+    // Таблицы длин и расстояний deflate (RFC 1951, 3.2.5).
+    constexpr uint16_t LENGTH_BASE[] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                                         35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+    constexpr uint8_t LENGTH_EXTRA[] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                                         3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+    constexpr uint16_t DISTANCE_BASE[] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+                                           257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145,
+                                           8193, 12289, 16385, 24577 };
+    constexpr uint8_t DISTANCE_EXTRA[] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+                                           7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+    constexpr size_t WINDOW_SIZE = 32768;
+    constexpr size_t MIN_MATCH = 3;
+    constexpr size_t MAX_MATCH = 258;
+    constexpr unsigned int HASH_BITS = 15;
+    // Сколько предыдущих вхождений проверяется при поиске совпадения.
+    constexpr unsigned int MAX_CHAIN = 64;
+
+    void writeLiteral(BitWriter& writer, const unsigned int symbol) {
+        if (symbol < 144) {
+            writer.writeCode(0x30 + symbol, 8);
+        } else if (symbol < 256) {
+            writer.writeCode(0x190 + symbol - 144, 9);
+        } else if (symbol < 280) {
+            writer.writeCode(symbol - 256, 7);
+        } else {
+            writer.writeCode(0xC0 + symbol - 280, 8);
+        }
+    }
+
+    template<size_t N>
+    unsigned int findCode(const uint16_t (&bases)[N], const size_t value) {
+        unsigned int code = N - 1;
+        while (bases[code] > value) {
+            --code;
+        }
+        return code;
+    }
+
+    void writeMatch(BitWriter& writer, const size_t length, const size_t distance) {
+        const unsigned int lengthCode = findCode(LENGTH_BASE, length);
+        writeLiteral(writer, 257 + lengthCode);
+        writer.write(static_cast<uint32_t>(length - LENGTH_BASE[lengthCode]), LENGTH_EXTRA[lengthCode]);
+        const unsigned int distanceCode = findCode(DISTANCE_BASE, distance);
+        writer.writeCode(distanceCode, 5);
+        writer.write(static_cast<uint32_t>(distance - DISTANCE_BASE[distanceCode]), DISTANCE_EXTRA[distanceCode]);
+    }
+
+    /**
+     * Функция сжимает данные одним блоком deflate с фиксированными кодами Хаффмана. Совпадения
+     * ищутся жадно по цепочкам хеша трех байт.
+     * */
+    void deflateFixed(const std::vector<uint8_t>& data, std::vector<uint8_t>& out) {
+        BitWriter writer(out);
+        // Последний блок, тип 01 - фиксированные коды.
+        writer.write(1, 1);
+        writer.write(1, 2);
+
+        const size_t size = data.size();
+        std::vector<int64_t> head(size_t(1) << HASH_BITS, -1);
+        std::vector<int64_t> previous(size, -1);
+        auto hashAt = [&data](const size_t i) {
+            return ((static_cast<uint32_t>(data[i]) << 10) ^ (static_cast<uint32_t>(data[i + 1]) << 5) ^ data[i + 2]) &
+                   ((1u << HASH_BITS) - 1);
+        };
+        auto insert = [&](const size_t i) {
+            if (i + MIN_MATCH <= size) {
+                const uint32_t hash = hashAt(i);
+                previous[i] = head[hash];
+                head[hash] = static_cast<int64_t>(i);
+            }
+        };
+
+        size_t i = 0;
+        while (i < size) {
+            size_t bestLength = 0;
+            size_t bestDistance = 0;
+            if (i + MIN_MATCH <= size) {
+                const size_t maxLength = std::min(MAX_MATCH, size - i);
+                int64_t candidate = head[hashAt(i)];
+                for (unsigned int chain = 0; candidate >= 0 && chain < MAX_CHAIN; ++chain) {
+                    const size_t start = static_cast<size_t>(candidate);
+                    if (i - start > WINDOW_SIZE) {
+                        break;
+                    }
+                    size_t length = 0;
+                    while (length < maxLength && data[start + length] == data[i + length]) {
+                        ++length;
+                    }
+                    if (length > bestLength) {
+                        bestLength = length;
+                        bestDistance = i - start;
+                        if (length == maxLength) {
+                            break;
+                        }
+                    }
+                    candidate = previous[start];
+                }
+            }
+            if (bestLength >= MIN_MATCH) {
+                writeMatch(writer, bestLength, bestDistance);
+                for (size_t k = 0; k < bestLength; ++k) {
+                    insert(i + k);
+                }
+                i += bestLength;
+            } else {
+                writeLiteral(writer, data[i]);
+                insert(i);
+                ++i;
+            }
+        }
+        writeLiteral(writer, 256);
+        writer.flush();
+    }
+
+    uint8_t paeth(const int a, const int b, const int c) {
+        const int p = a + b - c;
+        const int pa = std::abs(p - a);
+        const int pb = std::abs(p - b);
+        const int pc = std::abs(p - c);
+        if (pa <= pb && pa <= pc) {
+            return static_cast<uint8_t>(a);
+        }
+        return static_cast<uint8_t>(pb <= pc ? b : c);
+    }
+
+    /**
+     * Функция дописывает строку с фильтром PNG, дающим наименьшую сумму модулей байт (обычная
+     * эвристика libpng).
+     * @param pPrevious предыдущая (верхняя) строка или nullptr для первой.
+     * */
+    void appendFilteredRow(std::vector<uint8_t>& raw, const uint8_t* pRow, const uint8_t* pPrevious,
+                           const size_t rowSize, const size_t bytesPerPixel) {
+        std::array<std::vector<uint8_t>, 5> filtered;
+        uint64_t bestSum = UINT64_MAX;
+        size_t bestFilter = 0;
+        for (size_t filter = 0; filter < filtered.size(); ++filter) {
+            std::vector<uint8_t>& out = filtered[filter];
+            out.resize(rowSize);
+            uint64_t sum = 0;
+            for (size_t x = 0; x < rowSize; ++x) {
+                const int left = x >= bytesPerPixel ? pRow[x - bytesPerPixel] : 0;
+                const int up = pPrevious ? pPrevious[x] : 0;
+                const int upLeft = pPrevious && x >= bytesPerPixel ? pPrevious[x - bytesPerPixel] : 0;
+                int predictor = 0;
+                switch (filter) {
+                    case 1: predictor = left; break;
+                    case 2: predictor = up; break;
+                    case 3: predictor = (left + up) / 2; break;
+                    case 4: predictor = paeth(left, up, upLeft); break;
+                    default: break;
+                }
+                out[x] = static_cast<uint8_t>(pRow[x] - predictor);
+                sum += static_cast<uint64_t>(std::abs(static_cast<int8_t>(out[x])));
+            }
+            if (sum < bestSum) {
+                bestSum = sum;
+                bestFilter = filter;
+            }
+        }
+        raw.push_back(static_cast<uint8_t>(bestFilter));
+        raw.insert(raw.end(), filtered[bestFilter].begin(), filtered[bestFilter].end());
+    }
+
+    /**
+     * Функция строит палитру PNG, если в изображении не больше 256 цветов.
+     * @param palette цвета RGBA, упакованные в 0xRRGGBBAA.
+     * @param indices индекс палитры для каждого пикселя.
+     * */
+    bool buildPalette(const Offscreen::Image& image, std::vector<uint32_t>& palette, std::vector<uint8_t>& indices) {
+        std::unordered_map<uint32_t, uint8_t> lookup;
+        const size_t pixelsCount = image.pixels.size() / 4;
+        indices.resize(pixelsCount);
+        for (size_t i = 0; i < pixelsCount; ++i) {
+            const uint8_t* pPixel = image.pixels.data() + i * 4;
+            const uint32_t colour = (static_cast<uint32_t>(pPixel[0]) << 24) | (static_cast<uint32_t>(pPixel[1]) << 16) |
+                                    (static_cast<uint32_t>(pPixel[2]) << 8) | pPixel[3];
+            auto it = lookup.find(colour);
+            if (it == lookup.end()) {
+                if (palette.size() == 256) {
+                    return false;
+                }
+                it = lookup.emplace(colour, static_cast<uint8_t>(palette.size())).first;
+                palette.push_back(colour);
+            }
+            indices[i] = it->second;
+        }
+        return true;
+    }
+}
+
+namespace Offscreen {
+
+    bool writePng(const std::string& path, const Image& image, const PngOptions& options) {
+        std::ofstream file(path, std::ios::binary);
+        if (! file.is_open()) {
+            return false;
+        }
+        static const uint8_t signature[] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+        file.write(reinterpret_cast<const char*>(signature), sizeof(signature));
+
+        std::vector<uint32_t> palette;
+        std::vector<uint8_t> indices;
+        const bool indexed = options.allowPalette && buildPalette(image, palette, indices);
+        const size_t bytesPerPixel = indexed ? 1 : 4;
+
+        std::vector<uint8_t> header;
+        appendU32(header, image.width);
+        appendU32(header, image.height);
+        // 8 бит на канал или индекс, RGBA (6) или палитра (3), сжатие deflate, без чересстрочности.
+        header.insert(header.end(), { 8, static_cast<uint8_t>(indexed ? 3 : 6), 0, 0, 0 });
+        writeChunk(file, "IHDR", header);
+        if (indexed) {
+            std::vector<uint8_t> colours;
+            std::vector<uint8_t> alphas;
+            for (const uint32_t colour : palette) {
+                colours.insert(colours.end(), { static_cast<uint8_t>(colour >> 24), static_cast<uint8_t>(colour >> 16),
+                                                static_cast<uint8_t>(colour >> 8) });
+                alphas.push_back(static_cast<uint8_t>(colour));
+            }
+            writeChunk(file, "PLTE", colours);
+            writeChunk(file, "tRNS", alphas);
+        }
+
+        // Строки PNG идут сверху вниз, каждая начинается с типа фильтра.
+        const size_t rowSize = static_cast<size_t>(image.width) * bytesPerPixel;
+        const uint8_t* pPixels = indexed ? indices.data() : image.pixels.data();
+        std::vector<uint8_t> raw;
+        raw.reserve((rowSize + 1) * image.height);
+        for (unsigned int row = image.height; row-- > 0;) {
+            const uint8_t* pRow = pPixels + row * rowSize;
+            const uint8_t* pPrevious = row + 1 < image.height ? pRow + rowSize : nullptr;
+            if (options.compress) {
+                appendFilteredRow(raw, pRow, pPrevious, rowSize, bytesPerPixel);
+            } else {
+                raw.push_back(0);
+                raw.insert(raw.end(), pRow, pRow + rowSize);
+            }
+        }
+
+        std::vector<uint8_t> compressed;
+        // Заголовок zlib: deflate с окном 32 КБ, без словаря.
+        compressed.push_back(0x78);
+        compressed.push_back(0x01);
+        if (options.compress) {
+            deflateFixed(raw, compressed);
+        } else {
+            deflateStored(raw, compressed);
+        }
+        uint32_t a = 1;
+        uint32_t b = 0;
+        for (const uint8_t byte : raw) {
+            a = (a + byte) % 65521;
+            b = (b + a) % 65521;
+        }
+        appendU32(compressed, (b << 16) | a);
+        writeChunk(file, "IDAT", compressed);
+        writeChunk(file, "IEND", {});
+        return file.good();
+    }
+
+    bool loadPng(const std::string& path, Image& image) {
+        int channels = 0;
+        int width = 0;
+        int height = 0;
+        // Как и ResourceManager, строки загружаются снизу вверх.
+        stbi_set_flip_vertically_on_load(true);
+        unsigned char* pPixels = stbi_load(path.c_str(), &width, &height, &channels, 4);
+        if (! pPixels) {
+            return false;
+        }
+        image.width = static_cast<unsigned int>(width);
+        image.height = static_cast<unsigned int>(height);
+        image.pixels.assign(pPixels, pPixels + static_cast<size_t>(width) * height * 4);
+        stbi_image_free(pPixels);
+        return true;
+    }
+
+    ImageDifference compareImages(const Image& expected, const Image& actual, const unsigned int tolerance,
+                                  Image* pDiff) {
+        ImageDifference difference;
+        if (expected.width != actual.width || expected.height != actual.height) {
+            difference.sizeMismatch = true;
+            difference.differentPixels = static_cast<uint64_t>(actual.width) * actual.height;
+            return difference;
+        }
+        if (pDiff) {
+            pDiff->width = actual.width;
+            pDiff->height = actual.height;
+            pDiff->pixels.resize(actual.pixels.size());
+        }
+        for (size_t pixel = 0; pixel < actual.pixels.size(); pixel += 4) {
+            unsigned int pixelDifference = 0;
+            for (size_t channel = 0; channel < 4; ++channel) {
+                const int channelDifference = std::abs(static_cast<int>(expected.pixels[pixel + channel]) -
+                                                       static_cast<int>(actual.pixels[pixel + channel]));
+                pixelDifference = std::max(pixelDifference, static_cast<unsigned int>(channelDifference));
+            }
+            difference.maxDifference = std::max(difference.maxDifference, pixelDifference);
+            const bool different = pixelDifference > tolerance;
+            if (different) {
+                ++difference.differentPixels;
+            }
+            if (pDiff) {
+                uint8_t* pOut = pDiff->pixels.data() + pixel;
+                if (different) {
+                    pOut[0] = 255;
+                    pOut[1] = 0;
+                    pOut[2] = 0;
+                } else {
+                    pOut[0] = static_cast<uint8_t>(actual.pixels[pixel] / 4);
+                    pOut[1] = static_cast<uint8_t>(actual.pixels[pixel + 1] / 4);
+                    pOut[2] = static_cast<uint8_t>(actual.pixels[pixel + 2] / 4);
+                }
+                pOut[3] = 255;
+            }
+        }
+        return difference;
+    }
+}
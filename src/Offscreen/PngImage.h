@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Offscreen {
+
+    /**
+     * Изображение RGBA8. Строки хранятся снизу вверх, как их читает glReadPixels и как
+     * ResourceManager загружает текстуры.
+     * */
+    struct Image {
+        unsigned int width = 0;
+        unsigned int height = 0;
+        std::vector<uint8_t> pixels;
+    };
+
+    /**
+     * Результат сравнения двух изображений.
+     * */
+    struct ImageDifference {
+        // Количество пикселей, у которых хотя бы один канал отличается больше допуска.
+        uint64_t differentPixels = 0;
+        // Наибольшая разница канала по всем пикселям.
+        unsigned int maxDifference = 0;
+        bool sizeMismatch = false;
+    };
+
+    /**
+     * Параметры записи PNG.
+     * */
+    struct PngOptions {
+        // Сжимать данные (фильтры строк PNG, LZ77 и фиксированные коды Хаффмана deflate). Без
+        // сжатия пишутся блоки deflate типа stored: так быстрее, а кадры нужны для сравнения, а
+        // не для хранения.
+        bool compress = false;
+        // Записывать изображение не больше чем с 256 цветами с палитрой PNG (байт на пиксель).
+        bool allowPalette = false;
+    };
+
+    /**
+     * Функция сохраняет изображение в PNG. Кодировщик не требует zlib.
+     * @return false, если файл не удалось записать.
+     * */
+    bool writePng(const std::string& path, const Image& image, const PngOptions& options = PngOptions());
+    /**
+     * Функция загружает PNG через stb_image.
+     * @return false, если файл не найден или поврежден.
+     * */
+    bool loadPng(const std::string& path, Image& image);
+    /**
+     * Функция сравнивает изображения поканально.
+     * @param tolerance допустимая разница канала, которая не считается отличием.
+     * @param pDiff если не nullptr и размеры совпадают, сюда записывается карта отличий:
+     * отличающиеся пиксели красные, остальные - затемненное изображение actual.
+     * */
+    ImageDifference compareImages(const Image& expected, const Image& actual, unsigned int tolerance,
+                                  Image* pDiff = nullptr);
+}
@@ -0,0 +1,189 @@
+#include "AllocationCounter.h"
+
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+    std::array<AllocationCounter::Counters, AllocationCounter::TAGS_COUNT> g_frameCounters;
+}
+
+const char* AllocationCounter::getTagName(const ETag tag) noexcept {
+    switch (tag) {
+        case ETag::Render:
+            return "Render";
+        case ETag::Game:
+            return "Game";
+        case ETag::ResourceManager:
+            return "ResourceManager";
+        case ETag::Animation:
+            return "Animation";
+        default:
+            return "Other";
+    }
+}
+
+AllocationCounter::Counters AllocationCounter::getFrameCounters(const ETag tag) noexcept {
+    return g_frameCounters[static_cast<size_t>(tag)];
+}
+
+#ifdef BATTLECITY_COUNT_ALLOCATIONS
+
+namespace {
+    struct TagCounters {
+        std::atomic<uint64_t> count { 0 };
+        std::atomic<uint64_t> bytes { 0 };
+    };
+
+    std::array<TagCounters, AllocationCounter::TAGS_COUNT> g_counters;
+    // Счетчики на момент прошлого endFrame().
+    std::array<AllocationCounter::Counters, AllocationCounter::TAGS_COUNT> g_lastFrameEnd;
+    thread_local AllocationCounter::ETag g_threadTag = AllocationCounter::ETag::Other;
+
+    void count(const std::size_t size) noexcept {
+        TagCounters& counters = g_counters[static_cast<size_t>(g_threadTag)];
+        counters.count.fetch_add(1, std::memory_order_relaxed);
+        counters.bytes.fetch_add(size, std::memory_order_relaxed);
+    }
+
+    void* allocate(std::size_t size) noexcept {
+        count(size);
+        return std::malloc(size ? size : 1);
+    }
+
+    void* allocateAligned(std::size_t size, const std::align_val_t alignment) noexcept {
+        count(size);
+        const auto alignmentBytes = static_cast<std::size_t>(alignment);
+        // Размер для aligned_alloc должен быть кратен выравниванию.
+        return std::aligned_alloc(alignmentBytes, (size + alignmentBytes - 1) / alignmentBytes * alignmentBytes);
+    }
+}
+
+void* operator new(const std::size_t size) {
+    if (void* pMemory = allocate(size)) {
+        return pMemory;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](const std::size_t size) {
+    return operator new(size);
+}
+
+void* operator new(const std::size_t size, const std::nothrow_t&) noexcept {
+    return allocate(size);
+}
+
+void* operator new[](const std::size_t size, const std::nothrow_t&) noexcept {
+    return allocate(size);
+}
+
+void* operator new(const std::size_t size, const std::align_val_t alignment) {
+    if (void* pMemory = allocateAligned(size, alignment)) {
+        return pMemory;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](const std::size_t size, const std::align_val_t alignment) {
+    return operator new(size, alignment);
+}
+
+void operator delete(void* pMemory) noexcept {
+    std::free(pMemory);
+}
+
+void operator delete[](void* pMemory) noexcept {
+    std::free(pMemory);
+}
+
+void operator delete(void* pMemory, std::size_t) noexcept {
+    std::free(pMemory);
+}
+
+void operator delete[](void* pMemory, std::size_t) noexcept {
+    std::free(pMemory);
+}
+
+void operator delete(void* pMemory, std::align_val_t) noexcept {
+    std::free(pMemory);
+}
+
+void operator delete[](void* pMemory, std::align_val_t) noexcept {
+    std::free(pMemory);
+}
+
+void operator delete(void* pMemory, std::size_t, std::align_val_t) noexcept {
+    std::free(pMemory);
+}
+
+void operator delete[](void* pMemory, std::size_t, std::align_val_t) noexcept {
+    std::free(pMemory);
+}
+
+bool AllocationCounter::isEnabled() noexcept {
+    return true;
+}
+
+uint64_t AllocationCounter::getCount() noexcept {
+    uint64_t result = 0;
+    for (const TagCounters& counters : g_counters) {
+        result += counters.count.load(std::memory_order_relaxed);
+    }
+    return result;
+}
+
+uint64_t AllocationCounter::getBytes() noexcept {
+    uint64_t result = 0;
+    for (const TagCounters& counters : g_counters) {
+        result += counters.bytes.load(std::memory_order_relaxed);
+    }
+    return result;
+}
+
+AllocationCounter::Counters AllocationCounter::getCounters(const ETag tag) noexcept {
+    const TagCounters& counters = g_counters[static_cast<size_t>(tag)];
+    return { counters.count.load(std::memory_order_relaxed), counters.bytes.load(std::memory_order_relaxed) };
+}
+
+void AllocationCounter::endFrame() noexcept {
+    for (size_t i = 0; i < TAGS_COUNT; ++i) {
+        const Counters current = getCounters(static_cast<ETag>(i));
+        g_frameCounters[i] = { current.count - g_lastFrameEnd[i].count, current.bytes - g_lastFrameEnd[i].bytes };
+        g_lastFrameEnd[i] = current;
+    }
+}
+
+AllocationCounter::ETag AllocationCounter::setThreadTag(const ETag tag) noexcept {
+    const ETag previous = g_threadTag;
+    g_threadTag = tag;
+    return previous;
+}
+
+#else
+
+bool AllocationCounter::isEnabled() noexcept {
+    return false;
+}
+
+uint64_t AllocationCounter::getCount() noexcept {
+    return 0;
+}
+
+uint64_t AllocationCounter::getBytes() noexcept {
+    return 0;
+}
+
+AllocationCounter::Counters AllocationCounter::getCounters(ETag) noexcept {
+    return {};
+}
+
+void AllocationCounter::endFrame() noexcept {
+}
+
+AllocationCounter::ETag AllocationCounter::setThreadTag(ETag) noexcept {
+    return ETag::Other;
+}
+
+#endif
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Счетчик выделений памяти из общей кучи. При сборке с BATTLECITY_COUNT_ALLOCATIONS (опция
+ * CMake) глобальные operator new и operator delete заменяются версиями, которые считают
+ * выделения и байты всех потоков; без опции счетчики всегда равны нулю.
+ *
+ * Каждое выделение относится к подсистеме, отмеченной в текущем потоке макросом
+ * ALLOCATION_TAG (вложенная отметка действует до конца своей области), или к Other.
+ * */
+class AllocationCounter {
+public:
+    AllocationCounter() = delete;
+
+public:
+    enum class ETag : uint8_t {
+        Other,
+        Render,
+        Game,
+        ResourceManager,
+        Animation
+    };
+    static constexpr size_t TAGS_COUNT = 5;
+
+    struct Counters {
+        uint64_t count = 0;
+        uint64_t bytes = 0;
+    };
+
+    static bool isEnabled() noexcept;
+    static const char* getTagName(ETag tag) noexcept;
+    /**
+     * Количество выделений и выделенных байт с начала работы программы: всех и одной подсистемы.
+     * */
+    static uint64_t getCount() noexcept;
+    static uint64_t getBytes() noexcept;
+    static Counters getCounters(ETag tag) noexcept;
+    /**
+     * Метод отмечает конец кадра: выделения каждой подсистемы с прошлого вызова становятся
+     * выделениями кадра. Вызывается из одного потока (потока отрисовки).
+     * */
+    static void endFrame() noexcept;
+    /**
+     * Выделения подсистемы за кадр, законченный последним вызовом endFrame().
+     * Вызывается из того же потока, что и endFrame().
+     * */
+    static Counters getFrameCounters(ETag tag) noexcept;
+    /**
+     * Метод задает подсистему выделений текущего потока.
+     * @return прежняя подсистема.
+     * */
+    static ETag setThreadTag(ETag tag) noexcept;
+};
+
+/**
+ * Отметка подсистемы выделений до конца области видимости.
+ * */
+class AllocationScope {
+public:
+    AllocationScope(const AllocationScope&) = delete;
+    AllocationScope& operator=(const AllocationScope&) = delete;
+
+public:
+    explicit AllocationScope(const AllocationCounter::ETag tag) noexcept :
+                             m_previousTag(AllocationCounter::setThreadTag(tag)) {
+    }
+    ~AllocationScope() {
+        AllocationCounter::setThreadTag(m_previousTag);
+    }
+
+private:
+    AllocationCounter::ETag m_previousTag;
+};
+
+#ifdef BATTLECITY_COUNT_ALLOCATIONS
+    #define ALLOCATION_CONCAT_IMPL(a, b) a##b
+    #define ALLOCATION_CONCAT(a, b) ALLOCATION_CONCAT_IMPL(a, b)
+    #define ALLOCATION_TAG(tag) AllocationScope ALLOCATION_CONCAT(allocationScope, __LINE__)(AllocationCounter::ETag::tag)
+#else
+    #define ALLOCATION_TAG(tag) ((void)0)
+#endif
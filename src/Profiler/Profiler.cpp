@@ -0,0 +1,282 @@
+#include "Profiler.h"
+
+#include "../Exception/Exception.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+    /**
+     * Буфер событий одного потока. Пишет только поток-владелец, количество публикуется с
+     * memory_order_release, поэтому события [0, count) можно читать из другого потока.
+     * */
+    struct ThreadBuffer {
+        uint32_t threadId = 0;
+        std::atomic<const char*> name{ nullptr };
+        std::unique_ptr<Profiler::Event[]> events;
+        std::atomic<uint32_t> count{ 0 };
+        std::atomic<uint32_t> dropped{ 0 };
+        // Дорожка замеров видеокарты, а не поток.
+        bool gpu = false;
+    };
+
+    // Состояние записи, меняется только в основном потоке.
+    struct Capture {
+        bool active = false;
+        uint64_t firstFrame = 0;
+        uint64_t lastFrame = 0;
+        std::string tracePath;
+        uint64_t frame = 0;
+        uint64_t framesRecorded = 0;
+        uint64_t startNs = 0;
+        uint64_t frameStartNs = 0;
+    };
+
+    std::atomic<bool> g_recording{ false };
+    std::mutex g_buffersMutex;
+    // Буферы живут до конца программы, даже если поток завершился.
+    std::vector<std::unique_ptr<ThreadBuffer>> g_buffers;
+    Capture g_capture;
+
+    ThreadBuffer* g_pGpuBuffer = nullptr;
+
+    thread_local ThreadBuffer* t_pBuffer = nullptr;
+    thread_local const char* t_threadName = nullptr;
+
+    ThreadBuffer* createBuffer(const char* name, const bool gpu) {
+        auto pBuffer = std::make_unique<ThreadBuffer>();
+        pBuffer->events = std::make_unique<Profiler::Event[]>(Profiler::EVENTS_PER_THREAD);
+        pBuffer->name.store(name, std::memory_order_relaxed);
+        pBuffer->gpu = gpu;
+        std::lock_guard<std::mutex> lock(g_buffersMutex);
+        pBuffer->threadId = static_cast<uint32_t>(g_buffers.size()) + 1;
+        g_buffers.push_back(std::move(pBuffer));
+        return g_buffers.back().get();
+    }
+
+    void append(ThreadBuffer& buffer, const Profiler::Event& event) noexcept {
+        const uint32_t index = buffer.count.load(std::memory_order_relaxed);
+        if (index == Profiler::EVENTS_PER_THREAD) {
+            buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        buffer.events[index] = event;
+        buffer.count.store(index + 1, std::memory_order_release);
+    }
+
+    /**
+     * Функция вызывает handler(buffer, event) для всех записанных событий всех потоков.
+     * */
+    template<typename Handler>
+    void forEachEvent(Handler&& handler) {
+        std::lock_guard<std::mutex> lock(g_buffersMutex);
+        for (const auto& pBuffer : g_buffers) {
+            const uint32_t count = pBuffer->count.load(std::memory_order_acquire);
+            for (uint32_t i = 0; i < count; ++i) {
+                handler(*pBuffer, pBuffer->events[i]);
+            }
+        }
+    }
+
+    void writeJSONString(std::ostream& stream, const char* string) {
+        stream << '"';
+        for (const char* p = string; *p; ++p) {
+            if (*p == '"' || *p == '\\') {
+                stream << '\\';
+            }
+            stream << *p;
+        }
+        stream << '"';
+    }
+}
+
+void Profiler::startCapture(const uint64_t firstFrame, const uint64_t lastFrame, const std::string& tracePath) {
+    if (lastFrame < firstFrame) {
+        throw Exception::Exception("Invalid profiling frame range: " + std::to_string(firstFrame) + "-" +
+                                   std::to_string(lastFrame));
+    }
+    g_capture = Capture();
+    g_capture.active = true;
+    g_capture.firstFrame = firstFrame;
+    g_capture.lastFrame = lastFrame;
+    g_capture.tracePath = tracePath;
+    // Запись с первого кадра включает и загрузку ресурсов перед ним.
+    if (firstFrame == 0) {
+        g_capture.startNs = now();
+        g_capture.frameStartNs = g_capture.startNs;
+        g_recording.store(true, std::memory_order_relaxed);
+    }
+}
+
+void Profiler::beginFrame() {
+    if (! g_capture.active) {
+        return;
+    }
+    const uint64_t frameStartNs = now();
+    const uint64_t frame = g_capture.frame++;
+    if (isRecording()) {
+        // До первого кадра идет загрузка, она показывается отдельной областью.
+        record(frame == 0 ? "Startup" : "Frame", g_capture.frameStartNs, frameStartNs - g_capture.frameStartNs);
+        if (frame != 0) {
+            ++g_capture.framesRecorded;
+        }
+    }
+    if (frame == g_capture.lastFrame + 1) {
+        finishCapture();
+        return;
+    }
+    if (frame == g_capture.firstFrame && ! isRecording()) {
+        g_capture.startNs = frameStartNs;
+        g_recording.store(true, std::memory_order_relaxed);
+    }
+    g_capture.frameStartNs = frameStartNs;
+}
+
+void Profiler::finishCapture() {
+    if (! g_capture.active) {
+        return;
+    }
+    g_capture.active = false;
+    g_recording.store(false, std::memory_order_relaxed);
+    printSummary(std::cout);
+    if (! g_capture.tracePath.empty()) {
+        writeTrace(g_capture.tracePath);
+    }
+}
+
+void Profiler::setThreadName(const char* name) noexcept {
+    t_threadName = name;
+    if (t_pBuffer) {
+        t_pBuffer->name.store(name, std::memory_order_relaxed);
+    }
+}
+
+bool Profiler::isRecording() noexcept {
+    return g_recording.load(std::memory_order_relaxed);
+}
+
+uint64_t Profiler::now() noexcept {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void Profiler::record(const char* name, const uint64_t startNs, const uint64_t durationNs) noexcept {
+    if (! isRecording()) {
+        return;
+    }
+    if (! t_pBuffer) {
+        // Первое событие потока выделяет его буфер.
+        try {
+            t_pBuffer = createBuffer(t_threadName, false);
+        } catch (...) {
+            return;
+        }
+    }
+    append(*t_pBuffer, { name, startNs, durationNs });
+}
+
+void Profiler::recordGpu(const char* name, const uint64_t startNs, const uint64_t durationNs) noexcept {
+    if (! isRecording()) {
+        return;
+    }
+    if (! g_pGpuBuffer) {
+        try {
+            g_pGpuBuffer = createBuffer("GPU", true);
+        } catch (...) {
+            return;
+        }
+    }
+    append(*g_pGpuBuffer, { name, startNs, durationNs });
+}
+
+void Profiler::printSummary(std::ostream& stream) {
+    struct ScopeStats {
+        uint64_t calls = 0;
+        uint64_t totalNs = 0;
+        uint64_t maxNs = 0;
+    };
+    // Одинаковые литералы из разных единиц трансляции могут иметь разные адреса.
+    std::map<std::string, ScopeStats> scopes;
+    uint64_t dropped = 0;
+    forEachEvent([&scopes](const ThreadBuffer& buffer, const Event& event) {
+        ScopeStats& stats = scopes[buffer.gpu ? std::string("GPU ") + event.name : std::string(event.name)];
+        ++stats.calls;
+        stats.totalNs += event.durationNs;
+        stats.maxNs = std::max(stats.maxNs, event.durationNs);
+    });
+    {
+        std::lock_guard<std::mutex> lock(g_buffersMutex);
+        for (const auto& pBuffer : g_buffers) {
+            dropped += pBuffer->dropped.load(std::memory_order_relaxed);
+        }
+    }
+
+    std::vector<std::pair<std::string, ScopeStats>> sorted(scopes.begin(), scopes.end());
+    std::sort(sorted.begin(), sorted.end(), [](const auto& left, const auto& right) {
+        return left.second.totalNs > right.second.totalNs;
+    });
+
+    const uint64_t frames = std::max<uint64_t>(g_capture.framesRecorded, 1);
+    const std::ios_base::fmtflags flags = stream.flags();
+    stream << "Profile: " << g_capture.framesRecorded << " frames" << std::endl;
+    stream << std::left << std::setw(36) << "  scope" << std::right << std::setw(10) << "calls"
+           << std::setw(14) << "total ms" << std::setw(14) << "ms/frame" << std::setw(12) << "max us" << std::endl;
+    stream << std::fixed;
+    for (const auto& scope : sorted) {
+        stream << "  " << std::left << std::setw(34) << scope.first << std::right
+               << std::setw(10) << scope.second.calls
+               << std::setw(14) << std::setprecision(3) << scope.second.totalNs / 1e6
+               << std::setw(14) << std::setprecision(3) << scope.second.totalNs / 1e6 / frames
+               << std::setw(12) << std::setprecision(1) << scope.second.maxNs / 1e3 << std::endl;
+    }
+    stream.flags(flags);
+    if (dropped > 0) {
+        stream << "Warning: " << dropped << " profiler events dropped, thread buffers are full" << std::endl;
+    }
+}
+
+void Profiler::writeTrace(const std::string& path) {
+    std::ofstream file(path, std::ios::out | std::ios::trunc);
+    if (! file.is_open()) {
+        std::cerr << "Can't write profiler trace: " << path << std::endl;
+        return;
+    }
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    {
+        std::lock_guard<std::mutex> lock(g_buffersMutex);
+        for (const auto& pBuffer : g_buffers) {
+            const char* name = pBuffer->name.load(std::memory_order_relaxed);
+            const std::string threadName = name ? name : "Thread " + std::to_string(pBuffer->threadId);
+            file << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+                 << pBuffer->threadId << ",\"args\":{\"name\":";
+            writeJSONString(file, threadName.c_str());
+            file << "}}";
+            first = false;
+        }
+    }
+    file << std::fixed << std::setprecision(3);
+    forEachEvent([&file, &first](const ThreadBuffer& buffer, const Event& event) {
+        // Время в микросекундах от начала записи.
+        const double timestamp = static_cast<double>(static_cast<int64_t>(event.startNs - g_capture.startNs)) / 1e3;
+        file << (first ? "" : ",") << "\n{\"name\":";
+        writeJSONString(file, event.name);
+        file << ",\"cat\":\"" << (buffer.gpu ? "gpu" : "cpu") << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer.threadId
+             << ",\"ts\":" << timestamp << ",\"dur\":" << event.durationNs / 1e3 << "}";
+        first = false;
+    });
+    file << "\n]}\n";
+    if (! file) {
+        std::cerr << "Can't write profiler trace: " << path << std::endl;
+        return;
+    }
+    std::cout << "Profiler trace written to " << path << std::endl;
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+/**
+ * Профилировщик процессорного времени. Области кода отмечаются макросами PROFILE_SCOPE, события
+ * пишутся в буфер своего потока без блокировок. Время проходов на видеокарте добавляет
+ * RenderEngine::GpuTimer (макрос PROFILE_GPU_PASS). Запись ведется только в заданном диапазоне
+ * кадров (startCapture), по его окончании выводится сводка по областям и, если задан путь,
+ * файл trace_event JSON для chrome://tracing и Perfetto.
+ *
+ * Макросы действуют только при сборке с BATTLECITY_PROFILING (опция CMake), иначе они пусты
+ * и не стоят ничего.
+ * */
+class Profiler {
+public:
+    Profiler() = delete;
+
+    /**
+     * Событие: область кода name выполнялась durationNs наносекунд начиная с startNs.
+     * name должна быть строковым литералом (хранится только указатель).
+     * */
+    struct Event {
+        const char* name;
+        uint64_t startNs;
+        uint64_t durationNs;
+    };
+
+    // Емкость буфера событий одного потока на весь диапазон записи.
+    static constexpr uint32_t EVENTS_PER_THREAD = 1 << 16;
+
+    /**
+     * Метод задает диапазон кадров [firstFrame, lastFrame] для записи. Поддерживается одна
+     * запись за запуск.
+     * @param tracePath путь к файлу trace_event JSON, пустая строка - только сводка.
+     * */
+    static void startCapture(uint64_t firstFrame, uint64_t lastFrame, const std::string& tracePath);
+    /**
+     * Метод отмечает начало кадра в основном потоке: включает и выключает запись на границах
+     * диапазона, по окончании диапазона сохраняет результаты.
+     * */
+    static void beginFrame();
+    /**
+     * Метод завершает запись досрочно (например, окно закрыли до конца диапазона) и сохраняет
+     * то, что успели записать. Вызывается, когда остальные потоки уже не пишут события.
+     * */
+    static void finishCapture();
+    /**
+     * Метод задает имя текущего потока в трассировке. name должна быть строковым литералом.
+     * */
+    static void setThreadName(const char* name) noexcept;
+
+    static bool isRecording() noexcept;
+    static uint64_t now() noexcept;
+    /**
+     * Метод записывает событие в буфер текущего потока, если идет запись.
+     * */
+    static void record(const char* name, uint64_t startNs, uint64_t durationNs) noexcept;
+    /**
+     * Метод записывает интервал, измеренный на видеокарте, в отдельную дорожку "GPU". Время
+     * переведено в часы now(). Вызывается только из потока, владеющего контекстом OpenGL.
+     * */
+    static void recordGpu(const char* name, uint64_t startNs, uint64_t durationNs) noexcept;
+    /**
+     * Метод выводит сводку записанных событий: для каждой области количество вызовов, общее,
+     * среднее на кадр и максимальное время.
+     * */
+    static void printSummary(std::ostream& stream);
+
+private:
+    static void writeTrace(const std::string& path);
+};
+
+/**
+ * Замер времени области видимости.
+ * */
+class ProfileScope {
+public:
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+    explicit ProfileScope(const char* name) noexcept :
+                          m_name(name),
+                          m_startNs(Profiler::isRecording() ? Profiler::now() : 0) {}
+    ~ProfileScope() {
+        if (m_startNs != 0) {
+            Profiler::record(m_name, m_startNs, Profiler::now() - m_startNs);
+        }
+    }
+
+private:
+    const char* m_name;
+    uint64_t m_startNs;
+};
+
+#ifdef BATTLECITY_PROFILING
+    #define PROFILE_CONCAT_IMPL(a, b) a##b
+    #define PROFILE_CONCAT(a, b) PROFILE_CONCAT_IMPL(a, b)
+    #define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(name)
+    #define PROFILE_FRAME() Profiler::beginFrame()
+    #define PROFILE_THREAD_NAME(name) Profiler::setThreadName(name)
+#else
+    #define PROFILE_SCOPE(name) ((void)0)
+    #define PROFILE_FRAME() ((void)0)
+    #define PROFILE_THREAD_NAME(name) ((void)0)
+#endif
@@ -1,30 +1,37 @@
 #include "AnimatedSprite.h"
 #include "../Exception/Exception.h"
 #include "Texture2D.h"
+#include "../Profiler/Profiler.h"
+#include "../Profiler/AllocationCounter.h"
 
+#include <iterator>
 #include <string>
 
 namespace RenderEngine {
-    AnimatedSprite::AnimatedSprite(std::shared_ptr<Texture2D> pTexture,
+    AnimatedSprite::AnimatedSprite(const TextureHandle texture,
                                    const std::string& initialSubTexture,
-                                   std::shared_ptr<ShaderProgram> pShaderProgram,
+                                   const ShaderProgramHandle shaderProgram,
                                    const glm::vec2& position,
                                    const glm::vec2& size,
                                    float rotation) :
-                                   Sprite(std::move(pTexture), initialSubTexture,
-                                          std::move(pShaderProgram), position, size, rotation) {
+                                   Sprite(texture, initialSubTexture, shaderProgram, position, size, rotation) {
         m_pCurrentAnimationDuration = m_statesMap.end();
     }
 
     void
     AnimatedSprite::insertState(std::string state, VectorState subTexturesDuration) {
-        m_statesMap.emplace(std::move(state), std::move(subTexturesDuration));
+        const auto [it, inserted] = m_statesMap.insert_or_assign(std::move(state), std::move(subTexturesDuration));
+        // В новых кадрах текущего состояния их может быть меньше, поэтому оно начинается заново.
+        if (! inserted && it == m_pCurrentAnimationDuration) {
+            m_currentFrame = 0;
+            m_currentAnimationTime = 0;
+            m_dirty = true;
+        }
     }
 
     void AnimatedSprite::render() const {
         if (m_dirty) {
-            auto subTexture = m_pTexture->getSubTexture(
-                    m_pCurrentAnimationDuration->second[m_currentFrame].first);
+            auto subTexture = findSubTexture(m_pCurrentAnimationDuration->second[m_currentFrame].first);
 
             const GLfloat textureCoords[]{
                     // u                                  v
@@ -41,7 +48,21 @@ namespace RenderEngine {
         Sprite::render();
     }
 
+    Texture2D::SubTexture2D AnimatedSprite::getSubTexture() const {
+        if (m_pCurrentAnimationDuration == m_statesMap.end()) {
+            return Sprite::getSubTexture();
+        }
+        return findSubTexture(m_pCurrentAnimationDuration->second[m_currentFrame].first);
+    }
+
+    void AnimatedSprite::resolveSubTexture() {
+        Sprite::resolveSubTexture();
+        m_dirty = m_pCurrentAnimationDuration != m_statesMap.end();
+    }
+
     void AnimatedSprite::update(const uint64_t delta) {
+        PROFILE_SCOPE("AnimatedSprite::update");
+        ALLOCATION_TAG(Animation);
         if (m_pCurrentAnimationDuration != m_statesMap.end()) {
             m_currentAnimationTime += delta;
             while (m_currentAnimationTime >= m_pCurrentAnimationDuration->second[m_currentFrame].second) {
@@ -67,4 +88,48 @@ namespace RenderEngine {
             m_dirty = true;
         }
     }
+
+    AnimatedSprite::AnimationState AnimatedSprite::getAnimationState() const noexcept {
+        AnimationState animationState;
+        animationState.stateIndex = m_pCurrentAnimationDuration == m_statesMap.end()
+                                    ? NO_STATE
+                                    : static_cast<uint32_t>(std::distance(m_statesMap.cbegin(), m_pCurrentAnimationDuration));
+        animationState.frame = static_cast<uint32_t>(m_currentFrame);
+        animationState.time = m_currentAnimationTime;
+        return animationState;
+    }
+
+    void AnimatedSprite::setAnimationState(const AnimationState& animationState) {
+        auto it = m_statesMap.cend();
+        if (animationState.stateIndex != NO_STATE) {
+            if (animationState.stateIndex >= m_statesMap.size()) {
+                throw Exception::Exception("Invalid animation state index: " + std::to_string(animationState.stateIndex));
+            }
+            it = std::next(m_statesMap.cbegin(), animationState.stateIndex);
+            if (animationState.frame >= it->second.size()) {
+                throw Exception::Exception("Invalid animation frame " + std::to_string(animationState.frame) +
+                                           " for state: " + it->first);
+            }
+        }
+        if (it != m_pCurrentAnimationDuration || m_currentFrame != animationState.frame) {
+            m_dirty = true;
+        }
+        m_pCurrentAnimationDuration = it;
+        m_currentFrame = animationState.frame;
+        m_currentAnimationTime = animationState.time;
+    }
+
+    std::unique_ptr<AnimatedSprite> AnimatedSprite::clone() const {
+        // Начальная область копии - первый кадр первого состояния, как до выбора состояния.
+        std::string initialSubTexture = "default";
+        if (! m_statesMap.empty() && ! m_statesMap.cbegin()->second.empty()) {
+            initialSubTexture = m_statesMap.cbegin()->second.front().first;
+        }
+        auto pClone = std::make_unique<AnimatedSprite>(m_texture, initialSubTexture, m_shaderProgram,
+                                                       m_position, m_size, m_rotation);
+        pClone->m_statesMap = m_statesMap;
+        pClone->setAnimationState(getAnimationState());
+        pClone->m_dirty = true;
+        return pClone;
+    }
 }
\ No newline at end of file
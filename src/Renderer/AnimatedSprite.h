@@ -2,6 +2,7 @@
 
 #include "Sprite.h"
 
+#include <cstdint>
 #include <map>
 #include <vector>
 
@@ -11,25 +12,60 @@ namespace RenderEngine {
 
     class AnimatedSprite : public Sprite {
     public:
+        /**
+         * Состояние анимации без строк и итераторов, пригодное для снимков состояния игры.
+         * */
+        struct AnimationState {
+            // Номер состояния в порядке имен, NO_STATE - состояние не задано.
+            uint32_t stateIndex;
+            uint32_t frame;
+            uint64_t time;
+        };
+        static constexpr uint32_t NO_STATE = UINT32_MAX;
 
         /**
-         * @param pTexture указатель на текстуру спрайта.
-         * @param pShaderProgram шейдерная программа для рендеринга текстуры.
+         * @param texture дескриптор текстуры спрайта.
+         * @param shaderProgram дескриптор шейдерной программы для рендеринга текстуры.
          * @param position позиция спрайта (по умолчанию 0)
          * @param size размер спрайта (по умолчанию 1)
          * @param rotation угол поворота (по умолчанию 0)
          * */
-        AnimatedSprite(std::shared_ptr<Texture2D> pTexture,
+        AnimatedSprite(TextureHandle texture,
                const std::string& initialSubTexture,
-               std::shared_ptr<ShaderProgram> pShaderProgram,
+               ShaderProgramHandle shaderProgram,
                const glm::vec2& position = glm::vec2(0.0f),
                const glm::vec2& size = glm::vec2(1.0f),
                float rotation = 0.0f);
 
+        /**
+         * Метод добавляет состояние или заменяет кадры состояния с тем же именем (горячая
+         * перезагрузка). Замененное текущее состояние начинается с первого кадра.
+         * */
         void insertState(std::string state, VectorState subTexturesDuration);
         void render() const override;
+        /**
+         * Метод возвращает область текстуры текущего кадра анимации.
+         * */
+        Texture2D::SubTexture2D getSubTexture() const override;
+        /**
+         * Кадры анимации и так ищутся по имени, поэтому после перезагрузки атласа достаточно
+         * перезаписать буфер текущего кадра.
+         * */
+        void resolveSubTexture() override;
         void update(uint64_t delta);
         void setState(const std::string& newState);
+        AnimationState getAnimationState() const noexcept;
+        /**
+         * Метод восстанавливает состояние, полученное из getAnimationState(). Не выделяет память.
+         * @throw Exception, если такого состояния или кадра нет.
+         * */
+        void setAnimationState(const AnimationState& animationState);
+        /**
+         * Метод создает независимую копию спрайта с теми же состояниями анимации, текущим
+         * кадром, позицией и размером. Нужен, когда несколько объектов используют один спрайт
+         * из ResourceManager, но анимируются по отдельности.
+         * */
+        std::unique_ptr<AnimatedSprite> clone() const;
 
     private:
         std::map<std::string, VectorState> m_statesMap;
@@ -0,0 +1,158 @@
+#include "BitmapFont.h"
+
+#include "SpriteBatch.h"
+
+#include <cctype>
+#include <cstdint>
+#include <vector>
+
+namespace {
+    struct GlyphBitmap {
+        char character;
+        // Строки сверху вниз, старший из 5 бит - левый столбец.
+        uint8_t rows[7];
+    };
+
+    constexpr GlyphBitmap GLYPHS[] {
+        { '0', { 0b01110, 0b10001, 0b10011, 0b10101, 0b11001, 0b10001, 0b01110 } },
+        { '1', { 0b00100, 0b01100, 0b00100, 0b00100, 0b00100, 0b00100, 0b01110 } },
+        { '2', { 0b01110, 0b10001, 0b00001, 0b00010, 0b00100, 0b01000, 0b11111 } },
+        { '3', { 0b11111, 0b00010, 0b00100, 0b00010, 0b00001, 0b10001, 0b01110 } },
+        { '4', { 0b00010, 0b00110, 0b01010, 0b10010, 0b11111, 0b00010, 0b00010 } },
+        { '5', { 0b11111, 0b10000, 0b11110, 0b00001, 0b00001, 0b10001, 0b01110 } },
+        { '6', { 0b00110, 0b01000, 0b10000, 0b11110, 0b10001, 0b10001, 0b01110 } },
+        { '7', { 0b11111, 0b00001, 0b00010, 0b00100, 0b01000, 0b01000, 0b01000 } },
+        { '8', { 0b01110, 0b10001, 0b10001, 0b01110, 0b10001, 0b10001, 0b01110 } },
+        { '9', { 0b01110, 0b10001, 0b10001, 0b01111, 0b00001, 0b00010, 0b01100 } },
+        { 'A', { 0b01110, 0b10001, 0b10001, 0b11111, 0b10001, 0b10001, 0b10001 } },
+        { 'B', { 0b11110, 0b10001, 0b10001, 0b11110, 0b10001, 0b10001, 0b11110 } },
+        { 'C', { 0b01110, 0b10001, 0b10000, 0b10000, 0b10000, 0b10001, 0b01110 } },
+        { 'D', { 0b11100, 0b10010, 0b10001, 0b10001, 0b10001, 0b10010, 0b11100 } },
+        { 'E', { 0b11111, 0b10000, 0b10000, 0b11110, 0b10000, 0b10000, 0b11111 } },
+        { 'F', { 0b11111, 0b10000, 0b10000, 0b11110, 0b10000, 0b10000, 0b10000 } },
+        { 'G', { 0b01110, 0b10001, 0b10000, 0b10111, 0b10001, 0b10001, 0b01111 } },
+        { 'H', { 0b10001, 0b10001, 0b10001, 0b11111, 0b10001, 0b10001, 0b10001 } },
+        { 'I', { 0b01110, 0b00100, 0b00100, 0b00100, 0b00100, 0b00100, 0b01110 } },
+        { 'J', { 0b00111, 0b00010, 0b00010, 0b00010, 0b00010, 0b10010, 0b01100 } },
+        { 'K', { 0b10001, 0b10010, 0b10100, 0b11000, 0b10100, 0b10010, 0b10001 } },
+        { 'L', { 0b10000, 0b10000, 0b10000, 0b10000, 0b10000, 0b10000, 0b11111 } },
+        { 'M', { 0b10001, 0b11011, 0b10101, 0b10101, 0b10001, 0b10001, 0b10001 } },
+        { 'N', { 0b10001, 0b10001, 0b11001, 0b10101, 0b10011, 0b10001, 0b10001 } },
+        { 'O', { 0b01110, 0b10001, 0b10001, 0b10001, 0b10001, 0b10001, 0b01110 } },
+        { 'P', { 0b11110, 0b10001, 0b10001, 0b11110, 0b10000, 0b10000, 0b10000 } },
+        { 'Q', { 0b01110, 0b10001, 0b10001, 0b10001, 0b10101, 0b10010, 0b01101 } },
+        { 'R', { 0b11110, 0b10001, 0b10001, 0b11110, 0b10100, 0b10010, 0b10001 } },
+        { 'S', { 0b01111, 0b10000, 0b10000, 0b01110, 0b00001, 0b00001, 0b11110 } },
+        { 'T', { 0b11111, 0b00100, 0b00100, 0b00100, 0b00100, 0b00100, 0b00100 } },
+        { 'U', { 0b10001, 0b10001, 0b10001, 0b10001, 0b10001, 0b10001, 0b01110 } },
+        { 'V', { 0b10001, 0b10001, 0b10001, 0b10001, 0b10001, 0b01010, 0b00100 } },
+        { 'W', { 0b10001, 0b10001, 0b10001, 0b10101, 0b10101, 0b10101, 0b01010 } },
+        { 'X', { 0b10001, 0b10001, 0b01010, 0b00100, 0b01010, 0b10001, 0b10001 } },
+        { 'Y', { 0b10001, 0b10001, 0b10001, 0b01010, 0b00100, 0b00100, 0b00100 } },
+        { 'Z', { 0b11111, 0b00001, 0b00010, 0b00100, 0b01000, 0b10000, 0b11111 } },
+        { '.', { 0b00000, 0b00000, 0b00000, 0b00000, 0b00000, 0b01100, 0b01100 } },
+        { ',', { 0b00000, 0b00000, 0b00000, 0b00000, 0b01100, 0b00100, 0b01000 } },
+        { ':', { 0b00000, 0b01100, 0b01100, 0b00000, 0b01100, 0b01100, 0b00000 } },
+        { '/', { 0b00000, 0b00001, 0b00010, 0b00100, 0b01000, 0b10000, 0b00000 } },
+        { '%', { 0b11000, 0b11001, 0b00010, 0b00100, 0b01000, 0b10011, 0b00011 } },
+        { '-', { 0b00000, 0b00000, 0b00000, 0b11111, 0b00000, 0b00000, 0b00000 } },
+        { '+', { 0b00000, 0b00100, 0b00100, 0b11111, 0b00100, 0b00100, 0b00000 } },
+        { '=', { 0b00000, 0b00000, 0b11111, 0b00000, 0b11111, 0b00000, 0b00000 } },
+        { '(', { 0b00010, 0b00100, 0b01000, 0b01000, 0b01000, 0b00100, 0b00010 } },
+        { ')', { 0b01000, 0b00100, 0b00010, 0b00010, 0b00010, 0b00100, 0b01000 } },
+        { '?', { 0b01110, 0b10001, 0b00001, 0b00010, 0b00100, 0b00000, 0b00100 } },
+    };
+
+    constexpr unsigned int ATLAS_COLUMNS = 16;
+    // 6 строк символов и строка заливок.
+    constexpr unsigned int ATLAS_ROWS = 7;
+
+    constexpr uint8_t FILL_COLOURS[][4] {
+        { 255, 255, 255, 255 },
+        { 0, 0, 0, 176 },
+        { 64, 208, 64, 255 },
+        { 232, 200, 40, 255 },
+        { 224, 56, 48, 255 },
+    };
+}
+
+namespace RenderEngine {
+
+    BitmapFont::BitmapFont() {
+        static_assert(sizeof(FILL_COLOURS) / sizeof(FILL_COLOURS[0]) == static_cast<size_t>(EFill::FillsCount),
+                      "Every BitmapFont::EFill needs a colour");
+
+        const unsigned int width = ATLAS_COLUMNS * CELL_WIDTH;
+        const unsigned int height = ATLAS_ROWS * CELL_HEIGHT;
+        // Строка 0 текстуры - нижняя, как у загруженных изображений.
+        std::vector<uint8_t> pixels(width * height * 4, 0);
+        auto setPixel = [&pixels, width](const unsigned int x, const unsigned int y, const uint8_t* colour) {
+            uint8_t* pPixel = &pixels[(y * width + x) * 4];
+            pPixel[0] = colour[0];
+            pPixel[1] = colour[1];
+            pPixel[2] = colour[2];
+            pPixel[3] = colour[3];
+        };
+        auto cellRect = [width, height](const unsigned int cell) {
+            const glm::vec2 leftBottom((cell % ATLAS_COLUMNS) * CELL_WIDTH, (cell / ATLAS_COLUMNS) * CELL_HEIGHT);
+            const glm::vec2 textureSize(width, height);
+            return Texture2D::SubTexture2D(leftBottom / textureSize,
+                                           (leftBottom + glm::vec2(CELL_WIDTH, CELL_HEIGHT)) / textureSize);
+        };
+
+        for (const GlyphBitmap& glyph : GLYPHS) {
+            const unsigned int cell = static_cast<unsigned char>(glyph.character) - FIRST_CHARACTER;
+            const unsigned int cellX = (cell % ATLAS_COLUMNS) * CELL_WIDTH;
+            const unsigned int cellY = (cell / ATLAS_COLUMNS) * CELL_HEIGHT;
+            for (unsigned int row = 0; row < 7; ++row) {
+                for (unsigned int column = 0; column < 5; ++column) {
+                    if (glyph.rows[row] & (1u << (4 - column))) {
+                        // Нижняя строка ячейки остается пустой, верхняя строка символа - седьмая.
+                        setPixel(cellX + column, cellY + 7 - row, FILL_COLOURS[0]);
+                    }
+                }
+            }
+        }
+        for (unsigned int i = 0; i < CHARACTERS_COUNT; ++i) {
+            m_glyphs[i] = cellRect(i);
+        }
+
+        const unsigned int firstFillCell = CHARACTERS_COUNT;
+        for (unsigned int fill = 0; fill < static_cast<unsigned int>(EFill::FillsCount); ++fill) {
+            const unsigned int cell = firstFillCell + fill;
+            for (unsigned int y = 0; y < CELL_HEIGHT; ++y) {
+                for (unsigned int x = 0; x < CELL_WIDTH; ++x) {
+                    setPixel((cell % ATLAS_COLUMNS) * CELL_WIDTH + x, (cell / ATLAS_COLUMNS) * CELL_HEIGHT + y,
+                             FILL_COLOURS[fill]);
+                }
+            }
+            // Берем середину ячейки, чтобы при растяжении не захватывать соседние тексели.
+            const Texture2D::SubTexture2D rect = cellRect(cell);
+            const glm::vec2 center = 0.5f * (rect.leftBottomUV + rect.rightTopUV);
+            m_fills[fill] = Texture2D::SubTexture2D(center, center);
+        }
+
+        m_pTexture = std::make_unique<Texture2D>(width, height, pixels.data(), 4, GL_NEAREST, GL_CLAMP_TO_EDGE);
+    }
+
+    const Texture2D::SubTexture2D& BitmapFont::getGlyph(const char character) const noexcept {
+        unsigned int code = static_cast<unsigned char>(std::toupper(static_cast<unsigned char>(character)));
+        if (code < FIRST_CHARACTER || code >= FIRST_CHARACTER + CHARACTERS_COUNT) {
+            code = '?';
+        }
+        return m_glyphs[code - FIRST_CHARACTER];
+    }
+
+    float BitmapFont::drawText(SpriteBatch& batch, const char* text, const glm::vec2& position,
+                               const float scale) const noexcept {
+        const glm::vec2 cellSize = scale * glm::vec2(CELL_WIDTH, CELL_HEIGHT);
+        glm::vec2 cursor = position;
+        for (const char* p = text; *p; ++p) {
+            if (*p != ' ') {
+                batch.draw(getGlyph(*p), cursor, cellSize);
+            }
+            cursor.x += cellSize.x;
+        }
+        return cursor.x - position.x;
+    }
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "Texture2D.h"
+
+#include <glm/vec2.hpp>
+
+#include <array>
+#include <memory>
+
+namespace RenderEngine {
+
+    class SpriteBatch;
+
+    /**
+     * Растровый шрифт 5x7 для отладочного вывода. Атлас шрифта строится в коде и не требует
+     * файлов ресурсов: ячейки 6x8 для символов ASCII 32-127 (строчные буквы рисуются
+     * заглавными) и несколько залитых ячеек для фона и графиков. Текст выводится через
+     * SpriteBatch, как остальные спрайты.
+     * */
+    class BitmapFont {
+    public:
+        BitmapFont(const BitmapFont&) = delete;
+        BitmapFont& operator=(const BitmapFont&) = delete;
+
+    public:
+        // Размер ячейки символа в текселях (с интервалом после символа).
+        static constexpr unsigned int CELL_WIDTH = 6;
+        static constexpr unsigned int CELL_HEIGHT = 8;
+
+        // Заливки для фона и столбцов графиков.
+        enum class EFill {
+            White,
+            Background,
+            Green,
+            Yellow,
+            Red,
+            FillsCount
+        };
+
+        /**
+         * Создает текстуру атласа, поэтому вызывается при текущем контексте OpenGL.
+         * */
+        BitmapFont();
+
+        Texture2D* getTexture() const noexcept { return m_pTexture.get(); }
+        const Texture2D::SubTexture2D& getGlyph(char character) const noexcept;
+        const Texture2D::SubTexture2D& getFill(EFill fill) const noexcept {
+            return m_fills[static_cast<size_t>(fill)];
+        }
+        /**
+         * Метод добавляет в пакет прямоугольники символов строки.
+         * @param position левый нижний угол первого символа.
+         * @param scale во сколько раз увеличить символы (целое значение сохраняет четкость).
+         * @return ширина выведенной строки.
+         * */
+        float drawText(SpriteBatch& batch, const char* text, const glm::vec2& position, float scale) const noexcept;
+
+    private:
+        static constexpr unsigned int FIRST_CHARACTER = 32;
+        static constexpr unsigned int CHARACTERS_COUNT = 96;
+
+        std::unique_ptr<Texture2D> m_pTexture;
+        std::array<Texture2D::SubTexture2D, CHARACTERS_COUNT> m_glyphs;
+        std::array<Texture2D::SubTexture2D, static_cast<size_t>(EFill::FillsCount)> m_fills;
+    };
+}
@@ -0,0 +1,161 @@
+#include "DebugOverlay.h"
+
+#include "ShaderProgram.h"
+#include "SpriteBatch.h"
+#include "Texture2D.h"
+#include "../Profiler/AllocationCounter.h"
+
+#include <glm/mat4x4.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+namespace {
+    // Символы шрифта увеличиваются вдвое, чтобы текст читался при любом размере окна.
+    constexpr float TEXT_SCALE = 2.f;
+    constexpr float MARGIN = 8.f;
+    constexpr float LINE_HEIGHT = (RenderEngine::BitmapFont::CELL_HEIGHT + 1) * TEXT_SCALE;
+    constexpr unsigned int LINES_COUNT = 7;
+    // Высота графика соответствует двум кадрам при 60 FPS, более долгие кадры обрезаются.
+    constexpr float GRAPH_HEIGHT = 64.f;
+    constexpr float GRAPH_MAX_MS = 1000.f / 30.f;
+    constexpr float TARGET_FRAME_MS = 1000.f / 60.f;
+    // Фон, строки текста, столбцы графика и линия 60 FPS.
+    constexpr unsigned int BATCH_CAPACITY = 512;
+
+    uint64_t nowNs() noexcept {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+}
+
+namespace RenderEngine {
+
+    DebugOverlay::DebugOverlay(const ShaderProgramHandle shaderProgram) :
+                               m_shaderProgram(shaderProgram),
+                               m_pBatch(std::make_unique<SpriteBatch>(m_font.getTexture(),
+                                                                      getShaderProgramPool().get(m_shaderProgram),
+                                                                      BATCH_CAPACITY)),
+                               m_historyIndex(0),
+                               m_historyCount(0),
+                               m_lastFrameNs(0) {
+        m_frameTimes.fill(0.f);
+        m_sortedFrameTimes.fill(0.f);
+    }
+
+    DebugOverlay::~DebugOverlay() = default;
+
+    void DebugOverlay::addFrame(const FrameStats& stats) noexcept {
+        m_stats = stats;
+        const uint64_t frameNs = nowNs();
+        if (m_lastFrameNs != 0) {
+            m_frameTimes[m_historyIndex] = static_cast<float>(frameNs - m_lastFrameNs) / 1e6f;
+            m_historyIndex = (m_historyIndex + 1) % HISTORY_SIZE;
+            m_historyCount = std::min(m_historyCount + 1, HISTORY_SIZE);
+        }
+        m_lastFrameNs = frameNs;
+    }
+
+    float DebugOverlay::percentile(const float fraction) noexcept {
+        if (m_historyCount == 0) {
+            return 0.f;
+        }
+        const unsigned int index = std::min(static_cast<unsigned int>(fraction * m_historyCount), m_historyCount - 1);
+        std::nth_element(m_sortedFrameTimes.begin(), m_sortedFrameTimes.begin() + index,
+                         m_sortedFrameTimes.begin() + m_historyCount);
+        return m_sortedFrameTimes[index];
+    }
+
+    void DebugOverlay::writeAllocationLines(char* pTotal, char* pByTag, const size_t size) noexcept {
+        if (! AllocationCounter::isEnabled()) {
+            std::snprintf(pTotal, size, "ALLOCS OFF");
+            pByTag[0] = '\0';
+            return;
+        }
+        // Выделения из кучи за прошлый кадр: всего и по подсистемам (Render, Game, ResourceManager,
+        // Animation); выделения без отметки подсистемы входят только в общее число.
+        using ETag = AllocationCounter::ETag;
+        AllocationCounter::Counters total;
+        for (size_t i = 0; i < AllocationCounter::TAGS_COUNT; ++i) {
+            const AllocationCounter::Counters counters = AllocationCounter::getFrameCounters(static_cast<ETag>(i));
+            total.count += counters.count;
+            total.bytes += counters.bytes;
+        }
+        std::snprintf(pTotal, size, "ALLOCS %llu %.1f KB", static_cast<unsigned long long>(total.count),
+                      static_cast<double>(total.bytes) / 1024.0);
+        std::snprintf(pByTag, size, "R%llu G%llu RM%llu A%llu",
+                      static_cast<unsigned long long>(AllocationCounter::getFrameCounters(ETag::Render).count),
+                      static_cast<unsigned long long>(AllocationCounter::getFrameCounters(ETag::Game).count),
+                      static_cast<unsigned long long>(AllocationCounter::getFrameCounters(ETag::ResourceManager).count),
+                      static_cast<unsigned long long>(AllocationCounter::getFrameCounters(ETag::Animation).count));
+    }
+
+    void DebugOverlay::render(const glm::vec2& screenSize) {
+        // Пакет ссылается на шейдерную программу дескриптора.
+        ShaderProgram* pShaderProgram = getShaderProgramPool().get(m_shaderProgram);
+        if (! pShaderProgram) {
+            return;
+        }
+        std::copy(m_frameTimes.begin(), m_frameTimes.begin() + m_historyCount, m_sortedFrameTimes.begin());
+        const float p50 = percentile(0.5f);
+        const float p99 = percentile(0.99f);
+        const unsigned int lastIndex = (m_historyIndex + HISTORY_SIZE - 1) % HISTORY_SIZE;
+        const float lastFrameMs = m_historyCount > 0 ? m_frameTimes[lastIndex] : 0.f;
+
+        const float panelWidth = HISTORY_SIZE + 2 * MARGIN;
+        const float panelHeight = LINES_COUNT * LINE_HEIGHT + GRAPH_HEIGHT + 3 * MARGIN;
+        const glm::vec2 panelPosition(0.f, screenSize.y - panelHeight);
+
+        m_pBatch->begin();
+        m_pBatch->draw(m_font.getFill(BitmapFont::EFill::Background), panelPosition,
+                       glm::vec2(panelWidth, panelHeight));
+
+        // Процентили FPS считаются по времени кадра: P99 - FPS, ниже которого только 1% кадров.
+        char lines[LINES_COUNT][32];
+        std::snprintf(lines[0], sizeof(lines[0]), "FRAME %.2f MS", lastFrameMs);
+        std::snprintf(lines[1], sizeof(lines[1]), "FPS P50 %.0f P99 %.0f",
+                      p50 > 0.f ? 1000.f / p50 : 0.f, p99 > 0.f ? 1000.f / p99 : 0.f);
+        std::snprintf(lines[2], sizeof(lines[2]), "DRAWS %u BINDS %u", m_stats.drawCalls, m_stats.textureBinds);
+        std::snprintf(lines[3], sizeof(lines[3]), "UPLOADS %u %.1f KB", m_stats.bufferUploads,
+                      static_cast<double>(m_stats.uploadedBytes) / 1024.0);
+        std::snprintf(lines[4], sizeof(lines[4]), "TEXTURES %u %.1f KB", Texture2D::getTexturesCount(),
+                      static_cast<double>(Texture2D::getTotalMemoryBytes()) / 1024.0);
+        writeAllocationLines(lines[5], lines[6], sizeof(lines[0]));
+        glm::vec2 textPosition(MARGIN, screenSize.y - MARGIN - LINE_HEIGHT);
+        for (const char* line : lines) {
+            m_font.drawText(*m_pBatch, line, textPosition, TEXT_SCALE);
+            textPosition.y -= LINE_HEIGHT;
+        }
+
+        // Столбец на кадр, самый новый кадр справа.
+        const glm::vec2 graphPosition(MARGIN, panelPosition.y + MARGIN);
+        const float pixelsPerMs = GRAPH_HEIGHT / GRAPH_MAX_MS;
+        const unsigned int firstColumn = HISTORY_SIZE - m_historyCount;
+        for (unsigned int i = 0; i < m_historyCount; ++i) {
+            const float frameMs = m_frameTimes[(m_historyIndex + HISTORY_SIZE - m_historyCount + i) % HISTORY_SIZE];
+            // Запас 10% на неравномерность вертикальной синхронизации.
+            BitmapFont::EFill fill = BitmapFont::EFill::Green;
+            if (frameMs > GRAPH_MAX_MS * 1.1f) {
+                fill = BitmapFont::EFill::Red;
+            } else if (frameMs > TARGET_FRAME_MS * 1.1f) {
+                fill = BitmapFont::EFill::Yellow;
+            }
+            const float height = std::max(1.f, std::min(frameMs, GRAPH_MAX_MS) * pixelsPerMs);
+            m_pBatch->draw(m_font.getFill(fill), graphPosition + glm::vec2(firstColumn + i, 0.f),
+                           glm::vec2(1.f, height));
+        }
+        m_pBatch->draw(m_font.getFill(BitmapFont::EFill::White),
+                       graphPosition + glm::vec2(0.f, TARGET_FRAME_MS * pixelsPerMs),
+                       glm::vec2(static_cast<float>(HISTORY_SIZE), 1.f));
+
+        pShaderProgram->use();
+        pShaderProgram->setUniform("projectionMat", glm::ortho(0.f, screenSize.x, 0.f, screenSize.y, -100.f, 100.f));
+        // Остальные спрайты рисуются без смешивания, фон оверлея полупрозрачный.
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        m_pBatch->end();
+        glDisable(GL_BLEND);
+    }
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "BitmapFont.h"
+#include "Renderer.h"
+#include "ResourceHandles.h"
+
+#include <glm/vec2.hpp>
+
+#include <array>
+#include <cstdint>
+#include <memory>
+
+namespace RenderEngine {
+
+    class ShaderProgram;
+    class SpriteBatch;
+
+    /**
+     * Отладочный оверлей производительности: время последнего кадра, график времени кадров за
+     * последние HISTORY_SIZE кадров, FPS по 50-му и 99-му процентилям времени кадра, счетчики
+     * OpenGL кадра (FrameStats) и выделения памяти кадра по подсистемам (AllocationCounter). Выводится растровым шрифтом одним пакетом SpriteBatch
+     * поверх кадра. Используется только в потоке, владеющем контекстом OpenGL.
+     * */
+    class DebugOverlay {
+    public:
+        DebugOverlay() = delete;
+        DebugOverlay(const DebugOverlay&) = delete;
+        DebugOverlay& operator=(const DebugOverlay&) = delete;
+
+    public:
+        // Сколько последних кадров показывает график и учитывают процентили.
+        static constexpr unsigned int HISTORY_SIZE = 240;
+
+        /**
+         * @param shaderProgram шейдерная программа спрайтов.
+         * */
+        explicit DebugOverlay(ShaderProgramHandle shaderProgram);
+        ~DebugOverlay();
+
+        /**
+         * Метод отмечает конец отрисовки кадра: время кадра считается между соседними вызовами.
+         * Вызывается каждый кадр, даже когда оверлей скрыт, чтобы при включении график был
+         * заполнен.
+         * @param stats счетчики OpenGL кадра без учета самого оверлея.
+         * */
+        void addFrame(const FrameStats& stats) noexcept;
+        /**
+         * Метод рисует оверлей в левом верхнем углу. Меняет матрицу проекции шейдера. С удаленной
+         * шейдерной программой ничего не рисует.
+         * @param screenSize размер области вывода в пикселях.
+         * */
+        void render(const glm::vec2& screenSize);
+
+    private:
+        /**
+         * Метод возвращает время кадра (мс), которое не превышают fraction кадров истории.
+         * */
+        float percentile(float fraction) noexcept;
+        /**
+         * Метод записывает строки оверлея с выделениями памяти прошлого кадра (AllocationCounter).
+         * */
+        static void writeAllocationLines(char* pTotal, char* pByTag, size_t size) noexcept;
+
+    private:
+        ShaderProgramHandle m_shaderProgram;
+        BitmapFont m_font;
+        std::unique_ptr<SpriteBatch> m_pBatch;
+
+        // Кольцевой буфер времени кадров в миллисекундах.
+        std::array<float, HISTORY_SIZE> m_frameTimes;
+        // Копия истории для поиска процентилей, чтобы не выделять память каждый кадр.
+        std::array<float, HISTORY_SIZE> m_sortedFrameTimes;
+        unsigned int m_historyIndex;
+        unsigned int m_historyCount;
+        uint64_t m_lastFrameNs;
+        FrameStats m_stats;
+    };
+}
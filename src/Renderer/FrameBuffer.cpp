@@ -0,0 +1,41 @@
+#include "FrameBuffer.h"
+
+#include "Renderer.h"
+#include "Texture2D.h"
+#include "../Exception/Exception.h"
+
+#include <string>
+
+namespace RenderEngine {
+
+    FrameBuffer::FrameBuffer(const unsigned int width, const unsigned int height) :
+                             m_width(width),
+                             m_height(height) {
+        m_pColourTexture = std::make_unique<Texture2D>(static_cast<GLint>(width), static_cast<GLint>(height),
+                                                       nullptr, 4, GL_NEAREST);
+
+        glGenFramebuffers(1, &m_ID);
+        glBindFramebuffer(GL_FRAMEBUFFER, m_ID);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_pColourTexture->getID(), 0);
+        const GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        if (status != GL_FRAMEBUFFER_COMPLETE) {
+            glDeleteFramebuffers(1, &m_ID);
+            throw Exception::Exception("Framebuffer " + std::to_string(width) + "x" + std::to_string(height) +
+                                       " is incomplete: " + std::to_string(status));
+        }
+    }
+
+    FrameBuffer::~FrameBuffer() {
+        glDeleteFramebuffers(1, &m_ID);
+    }
+
+    void FrameBuffer::bind() const noexcept {
+        glBindFramebuffer(GL_FRAMEBUFFER, m_ID);
+        Renderer::setViewport(m_width, m_height);
+    }
+
+    void FrameBuffer::unbind() noexcept {
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    }
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <memory>
+
+namespace RenderEngine {
+
+    class Texture2D;
+
+    /**
+     * Буфер кадра OpenGL с текстурой цвета RGBA (фильтрация GL_NEAREST). Используется для
+     * отрисовки без окна, чтения кадров (FrameCapture) и сцены в пониженном разрешении
+     * (ScaledRenderTarget).
+     * */
+    class FrameBuffer {
+    public:
+        FrameBuffer() = delete;
+        FrameBuffer(const FrameBuffer&) = delete;
+        FrameBuffer& operator=(const FrameBuffer&) = delete;
+
+    public:
+        /**
+         * @throw Exception::Exception, если буфер кадра не готов к отрисовке.
+         * */
+        FrameBuffer(unsigned int width, unsigned int height);
+        ~FrameBuffer();
+
+        /**
+         * Метод делает буфер целью отрисовки и чтения и устанавливает область вывода на весь буфер.
+         * */
+        void bind() const noexcept;
+        /**
+         * Метод возвращает отрисовку в буфер кадра окна.
+         * */
+        static void unbind() noexcept;
+        Texture2D* getColourTexture() const noexcept { return m_pColourTexture.get(); }
+        unsigned int width() const noexcept { return m_width; }
+        unsigned int height() const noexcept { return m_height; }
+
+    private:
+        GLuint m_ID = 0;
+        std::unique_ptr<Texture2D> m_pColourTexture;
+        unsigned int m_width;
+        unsigned int m_height;
+    };
+}
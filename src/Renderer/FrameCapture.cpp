@@ -0,0 +1,92 @@
+#include "FrameCapture.h"
+
+#include <utility>
+
+namespace {
+    // Чтение кадра ожидается по секунде за вызов glClientWaitSync.
+    constexpr GLuint64 WAIT_TIMEOUT_NS = 1000000000;
+}
+
+namespace RenderEngine {
+
+    FrameCapture::FrameCapture(const unsigned int width, const unsigned int height, FrameHandler handler) :
+                               m_next(0),
+                               m_oldest(0),
+                               m_pending(0),
+                               m_width(width),
+                               m_height(height),
+                               m_handler(std::move(handler)),
+                               m_stalls(0) {
+        const GLsizeiptr size = static_cast<GLsizeiptr>(width) * height * 4;
+        for (Slot& slot : m_slots) {
+            glGenBuffers(1, &slot.buffer);
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+            glBufferData(GL_PIXEL_PACK_BUFFER, size, nullptr, GL_STREAM_READ);
+        }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    }
+
+    FrameCapture::~FrameCapture() {
+        for (Slot& slot : m_slots) {
+            if (slot.fence) {
+                glDeleteSync(slot.fence);
+            }
+            glDeleteBuffers(1, &slot.buffer);
+        }
+    }
+
+    void FrameCapture::request(const uint64_t frameId) {
+        collect();
+        if (m_pending == FRAMES_IN_FLIGHT) {
+            ++m_stalls;
+            deliver(m_slots[m_oldest], true);
+        }
+
+        Slot& slot = m_slots[m_next];
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+        glPixelStorei(GL_PACK_ALIGNMENT, 4);
+        glReadPixels(0, 0, static_cast<GLsizei>(m_width), static_cast<GLsizei>(m_height),
+                     GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        slot.frameId = frameId;
+        m_next = (m_next + 1) % FRAMES_IN_FLIGHT;
+        ++m_pending;
+    }
+
+    void FrameCapture::collect() {
+        while (m_pending > 0 && deliver(m_slots[m_oldest], false)) {
+        }
+    }
+
+    void FrameCapture::flush() {
+        while (m_pending > 0) {
+            deliver(m_slots[m_oldest], true);
+        }
+    }
+
+    bool FrameCapture::deliver(Slot& slot, const bool wait) {
+        // Флаг отправляет команды видеокарте, иначе без ожидания fence может не сработать никогда.
+        GLenum status = glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+        while (wait && status == GL_TIMEOUT_EXPIRED) {
+            status = glClientWaitSync(slot.fence, 0, WAIT_TIMEOUT_NS);
+        }
+        if (status == GL_TIMEOUT_EXPIRED) {
+            return false;
+        }
+        glDeleteSync(slot.fence);
+        slot.fence = nullptr;
+
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+        const GLsizeiptr size = static_cast<GLsizeiptr>(m_width) * m_height * 4;
+        const void* pPixels = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, size, GL_MAP_READ_BIT);
+        if (pPixels) {
+            m_handler(slot.frameId, static_cast<const uint8_t*>(pPixels));
+            glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        m_oldest = (m_oldest + 1) % FRAMES_IN_FLIGHT;
+        --m_pending;
+        return true;
+    }
+}
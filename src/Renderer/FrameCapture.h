@@ -0,0 +1,75 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <array>
+#include <cstdint>
+#include <functional>
+
+namespace RenderEngine {
+
+    /**
+     * Асинхронное чтение кадров через буферы пикселей (GL_PIXEL_PACK_BUFFER). glReadPixels в
+     * буфер только ставит копирование в очередь видеокарты, а данные забираются, когда их
+     * синхронизационный объект сработал, то есть обычно через несколько кадров. Буферы образуют
+     * кольцо на FRAMES_IN_FLIGHT кадров; если свободных нет, ожидание самого старого считается
+     * простоем (stalls()). Используется только в потоке, владеющем контекстом OpenGL.
+     * */
+    class FrameCapture {
+    public:
+        FrameCapture() = delete;
+        FrameCapture(const FrameCapture&) = delete;
+        FrameCapture& operator=(const FrameCapture&) = delete;
+
+    public:
+        /**
+         * Принимает номер кадра и пиксели RGBA8 размером width x height. Строки идут снизу вверх,
+         * как их возвращает OpenGL. Пиксели действительны только во время вызова.
+         * */
+        using FrameHandler = std::function<void(uint64_t frameId, const uint8_t* pPixels)>;
+
+        static constexpr unsigned int FRAMES_IN_FLIGHT = 3;
+
+        FrameCapture(unsigned int width, unsigned int height, FrameHandler handler);
+        ~FrameCapture();
+
+        /**
+         * Метод ставит в очередь чтение текущего буфера кадра (GL_READ_FRAMEBUFFER) и передает
+         * обработчику готовые кадры.
+         * */
+        void request(uint64_t frameId);
+        /**
+         * Метод передает обработчику кадры, чтение которых уже завершилось, не дожидаясь остальных.
+         * */
+        void collect();
+        /**
+         * Метод дожидается и передает обработчику все запрошенные кадры.
+         * */
+        void flush();
+
+        uint64_t stalls() const noexcept { return m_stalls; }
+
+    private:
+        struct Slot {
+            GLuint buffer = 0;
+            GLsync fence = nullptr;
+            uint64_t frameId = 0;
+        };
+
+        /**
+         * @return true, если кадр ячейки передан обработчику.
+         * */
+        bool deliver(Slot& slot, bool wait);
+
+    private:
+        std::array<Slot, FRAMES_IN_FLIGHT> m_slots;
+        // Ячейка для следующего запроса; кадры отдаются в порядке запросов начиная с m_oldest.
+        unsigned int m_next;
+        unsigned int m_oldest;
+        unsigned int m_pending;
+        unsigned int m_width;
+        unsigned int m_height;
+        FrameHandler m_handler;
+        uint64_t m_stalls;
+    };
+}
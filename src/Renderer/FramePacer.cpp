@@ -0,0 +1,110 @@
+#include "FramePacer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+namespace {
+    // Пределы запаса на активное ожидание. Нижний покрывает задержку пробуждения на Linux,
+    // верхний не дает ожиданию превратиться в полный цикл опроса при грубом таймере.
+    constexpr uint64_t MIN_SPIN_MARGIN_NS = 200000;
+    constexpr uint64_t MAX_SPIN_MARGIN_NS = 4000000;
+    constexpr uint64_t INITIAL_SPIN_MARGIN_NS = 1000000;
+
+    uint64_t nowNs() noexcept {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+}
+
+namespace RenderEngine {
+
+    FramePacer::FramePacer(const double targetFps) noexcept :
+                           m_periodNs(0),
+                           m_nextFrameNs(0),
+                           m_lastFrameNs(0),
+                           m_spinMarginNs(INITIAL_SPIN_MARGIN_NS),
+                           m_intervals(0),
+                           m_intervalSumNs(0.0),
+                           m_intervalSquaresSumNs(0.0),
+                           m_maxLatenessNs(0),
+                           m_missedFrames(0) {
+        setTargetFps(targetFps);
+    }
+
+    void FramePacer::waitForNextFrame() noexcept {
+        if (m_periodNs == 0) {
+            addSample(nowNs());
+            return;
+        }
+        const uint64_t now = nowNs();
+        if (m_nextFrameNs == 0 || now > m_nextFrameNs + m_periodNs) {
+            if (m_nextFrameNs != 0) {
+                ++m_missedFrames;
+            }
+            m_nextFrameNs = now;
+        } else {
+            if (m_nextFrameNs > now + m_spinMarginNs) {
+                const uint64_t sleepNs = m_nextFrameNs - m_spinMarginNs - now;
+                std::this_thread::sleep_for(std::chrono::nanoseconds(sleepNs));
+                const uint64_t wakeUp = nowNs();
+                const uint64_t oversleep = wakeUp > now + sleepNs ? wakeUp - now - sleepNs : 0;
+                // Запас быстро растет до опоздания сна с четвертью сверху и медленно убывает.
+                const uint64_t wantedMargin = oversleep + oversleep / 4;
+                if (wantedMargin > m_spinMarginNs) {
+                    m_spinMarginNs = std::min(wantedMargin, MAX_SPIN_MARGIN_NS);
+                } else {
+                    m_spinMarginNs = std::max(m_spinMarginNs - (m_spinMarginNs - wantedMargin) / 64,
+                                              MIN_SPIN_MARGIN_NS);
+                }
+            }
+            while (nowNs() < m_nextFrameNs) {
+                std::this_thread::yield();
+            }
+        }
+        const uint64_t frameStart = nowNs();
+        m_maxLatenessNs = std::max(m_maxLatenessNs, frameStart - m_nextFrameNs);
+        addSample(frameStart);
+        m_nextFrameNs += m_periodNs;
+    }
+
+    void FramePacer::reset() noexcept {
+        m_nextFrameNs = 0;
+        m_lastFrameNs = 0;
+    }
+
+    void FramePacer::setTargetFps(const double targetFps) noexcept {
+        m_periodNs = targetFps > 0.0 ? static_cast<uint64_t>(1e9 / targetFps) : 0;
+        reset();
+    }
+
+    double FramePacer::getTargetFps() const noexcept {
+        return m_periodNs ? 1e9 / static_cast<double>(m_periodNs) : 0.0;
+    }
+
+    FramePacer::Stats FramePacer::getStats() const noexcept {
+        Stats stats;
+        stats.frames = m_intervals;
+        stats.missedFrames = m_missedFrames;
+        stats.maxLatenessMs = static_cast<double>(m_maxLatenessNs) / 1e6;
+        stats.spinMarginMs = static_cast<double>(m_spinMarginNs) / 1e6;
+        if (m_intervals > 0) {
+            const double mean = m_intervalSumNs / static_cast<double>(m_intervals);
+            const double variance = m_intervalSquaresSumNs / static_cast<double>(m_intervals) - mean * mean;
+            stats.averageIntervalMs = mean / 1e6;
+            stats.jitterMs = std::sqrt(std::max(variance, 0.0)) / 1e6;
+        }
+        return stats;
+    }
+
+    void FramePacer::addSample(const uint64_t frameStartNs) noexcept {
+        if (m_lastFrameNs != 0) {
+            const double interval = static_cast<double>(frameStartNs - m_lastFrameNs);
+            ++m_intervals;
+            m_intervalSumNs += interval;
+            m_intervalSquaresSumNs += interval * interval;
+        }
+        m_lastFrameNs = frameStartNs;
+    }
+}
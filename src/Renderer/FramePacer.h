@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdint>
+
+namespace RenderEngine {
+
+    /**
+     * Ограничитель частоты кадров. Начало каждого кадра назначается через равные интервалы;
+     * до назначенного момента поток спит (std::this_thread::sleep_for), а последний отрезок
+     * ожидает активно, уступая процессор (std::this_thread::yield), потому что сон
+     * просыпается с опозданием на величину кванта планировщика. Запас на активное ожидание
+     * подстраивается под наблюдаемое опоздание сна. Отклонения начала кадров от назначенных
+     * моментов собираются в статистику (джиттер).
+     * */
+    class FramePacer {
+    public:
+        FramePacer() = delete;
+        FramePacer(const FramePacer&) = delete;
+        FramePacer& operator=(const FramePacer&) = delete;
+
+    public:
+        struct Stats {
+            // Кадры, для которых измерен интервал от начала предыдущего кадра.
+            uint64_t frames = 0;
+            // Средний интервал между началами кадров.
+            double averageIntervalMs = 0.0;
+            // Среднеквадратичное отклонение интервала между кадрами.
+            double jitterMs = 0.0;
+            // Наибольшее опоздание начала кадра относительно назначенного момента.
+            double maxLatenessMs = 0.0;
+            // Сколько раз кадр не уложился в интервал и расписание было сдвинуто.
+            uint64_t missedFrames = 0;
+            // Текущий запас на активное ожидание.
+            double spinMarginMs = 0.0;
+        };
+
+        /**
+         * @param targetFps целевая частота кадров; 0 отключает ограничение.
+         * */
+        explicit FramePacer(double targetFps) noexcept;
+
+        /**
+         * Метод ждет назначенного начала следующего кадра. Если кадр уже опоздал больше чем на
+         * интервал, расписание начинается заново от текущего момента, без серии кадров вдогонку.
+         * */
+        void waitForNextFrame() noexcept;
+        /**
+         * Метод начинает расписание заново, например после ожидания событий в паузе. Время
+         * ожидания не попадает в статистику.
+         * */
+        void reset() noexcept;
+
+        void setTargetFps(double targetFps) noexcept;
+        double getTargetFps() const noexcept;
+        Stats getStats() const noexcept;
+
+    private:
+        void addSample(uint64_t frameStartNs) noexcept;
+
+    private:
+        // Интервал между кадрами; 0 - без ограничения.
+        uint64_t m_periodNs;
+        uint64_t m_nextFrameNs;
+        uint64_t m_lastFrameNs;
+        // Запас на активное ожидание, подстраивается под опоздание сна.
+        uint64_t m_spinMarginNs;
+
+        uint64_t m_intervals;
+        double m_intervalSumNs;
+        double m_intervalSquaresSumNs;
+        uint64_t m_maxLatenessNs;
+        uint64_t m_missedFrames;
+    };
+}
@@ -0,0 +1,100 @@
+#include "GpuTimer.h"
+
+#include "../Profiler/Profiler.h"
+
+namespace RenderEngine {
+
+    GpuTimer::GpuTimer() :
+                       m_queries(FRAMES_IN_FLIGHT * MAX_PASSES * 2),
+                       m_pCurrentFrame(nullptr),
+                       m_frameIndex(0),
+                       m_depth(0),
+                       m_droppedFrames(0) {
+        glGenQueries(static_cast<GLsizei>(m_queries.size()), m_queries.data());
+        for (unsigned int frame = 0; frame < FRAMES_IN_FLIGHT; ++frame) {
+            for (unsigned int pass = 0; pass < MAX_PASSES; ++pass) {
+                const size_t first = (static_cast<size_t>(frame) * MAX_PASSES + pass) * 2;
+                m_frames[frame].passes[pass] = { nullptr, m_queries[first], m_queries[first + 1] };
+            }
+        }
+    }
+
+    GpuTimer::~GpuTimer() {
+        glDeleteQueries(static_cast<GLsizei>(m_queries.size()), m_queries.data());
+    }
+
+    void GpuTimer::beginFrame() noexcept {
+        Frame& frame = m_frames[m_frameIndex % FRAMES_IN_FLIGHT];
+        if (frame.pending) {
+            collect(frame);
+        }
+        frame.passesCount = 0;
+        // Метки времени видеокарты переводятся в часы профилировщика, чтобы проходы легли в
+        // трассировку рядом с событиями процессора.
+        GLint64 gpuNow = 0;
+        glGetInteger64v(GL_TIMESTAMP, &gpuNow);
+        frame.clockOffsetNs = static_cast<int64_t>(Profiler::now()) - gpuNow;
+        m_pCurrentFrame = &frame;
+        m_depth = 0;
+        beginPass("frame");
+    }
+
+    void GpuTimer::endFrame() noexcept {
+        if (! m_pCurrentFrame) {
+            return;
+        }
+        while (m_depth > 0) {
+            endPass();
+        }
+        m_pCurrentFrame->pending = m_pCurrentFrame->passesCount > 0;
+        m_pCurrentFrame = nullptr;
+        ++m_frameIndex;
+    }
+
+    void GpuTimer::beginPass(const char* name) noexcept {
+        if (! m_pCurrentFrame) {
+            return;
+        }
+        unsigned int passIndex = NO_PASS;
+        if (m_pCurrentFrame->passesCount < MAX_PASSES) {
+            passIndex = m_pCurrentFrame->passesCount++;
+            Pass& pass = m_pCurrentFrame->passes[passIndex];
+            pass.name = name;
+            glQueryCounter(pass.beginQuery, GL_TIMESTAMP);
+        }
+        if (m_depth < MAX_DEPTH) {
+            m_openPasses[m_depth] = passIndex;
+        }
+        ++m_depth;
+    }
+
+    void GpuTimer::endPass() noexcept {
+        if (! m_pCurrentFrame || m_depth == 0) {
+            return;
+        }
+        --m_depth;
+        if (m_depth < MAX_DEPTH && m_openPasses[m_depth] != NO_PASS) {
+            glQueryCounter(m_pCurrentFrame->passes[m_openPasses[m_depth]].endQuery, GL_TIMESTAMP);
+        }
+    }
+
+    void GpuTimer::collect(Frame& frame) noexcept {
+        frame.pending = false;
+        // Проход "frame" заканчивается последним: если готов он, готовы и остальные.
+        GLint available = GL_FALSE;
+        glGetQueryObjectiv(frame.passes[0].endQuery, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (available == GL_FALSE) {
+            ++m_droppedFrames;
+            return;
+        }
+        for (unsigned int i = 0; i < frame.passesCount; ++i) {
+            const Pass& pass = frame.passes[i];
+            GLuint64 beginNs = 0;
+            GLuint64 endNs = 0;
+            glGetQueryObjectui64v(pass.beginQuery, GL_QUERY_RESULT, &beginNs);
+            glGetQueryObjectui64v(pass.endQuery, GL_QUERY_RESULT, &endNs);
+            Profiler::recordGpu(pass.name, static_cast<uint64_t>(static_cast<int64_t>(beginNs) + frame.clockOffsetNs),
+                                endNs > beginNs ? endNs - beginNs : 0);
+        }
+    }
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace RenderEngine {
+
+    /**
+     * Замер времени проходов отрисовки на видеокарте запросами glQueryCounter(GL_TIMESTAMP).
+     * Запросы образуют кольцо на FRAMES_IN_FLIGHT кадров: результаты кадра читаются, когда
+     * его ячейка понадобится снова, то есть через несколько кадров, и чтение не ждет
+     * видеокарту. Если результаты к этому времени не готовы, кадр отбрасывается.
+     * Готовые интервалы передаются профилировщику (Profiler::recordGpu) и попадают в его сводку
+     * и трассировку. Используется только в потоке, владеющем контекстом OpenGL.
+     * */
+    class GpuTimer {
+    public:
+        GpuTimer(const GpuTimer&) = delete;
+        GpuTimer& operator=(const GpuTimer&) = delete;
+
+    public:
+        // Сколько кадров может ждать результатов, прежде чем ячейка понадобится снова.
+        static constexpr unsigned int FRAMES_IN_FLIGHT = 4;
+        // Проходов в кадре, включая сам кадр. Лишние проходы не замеряются.
+        static constexpr unsigned int MAX_PASSES = 16;
+        static constexpr unsigned int MAX_DEPTH = 8;
+
+        GpuTimer();
+        ~GpuTimer();
+
+        /**
+         * Метод забирает результаты кадра, ранее использовавшего ту же ячейку кольца, и
+         * начинает новый кадр (проход "frame").
+         * */
+        void beginFrame() noexcept;
+        void endFrame() noexcept;
+        /**
+         * Методы отмечают начало и конец прохода. Проходы могут быть вложенными.
+         * name должна быть строковым литералом.
+         * */
+        void beginPass(const char* name) noexcept;
+        void endPass() noexcept;
+
+        uint64_t droppedFrames() const noexcept { return m_droppedFrames; }
+
+    private:
+        struct Pass {
+            const char* name;
+            GLuint beginQuery;
+            GLuint endQuery;
+        };
+
+        struct Frame {
+            std::array<Pass, MAX_PASSES> passes;
+            unsigned int passesCount = 0;
+            // Разница между часами профилировщика и часами видеокарты в начале кадра.
+            int64_t clockOffsetNs = 0;
+            bool pending = false;
+        };
+
+        void collect(Frame& frame) noexcept;
+
+    private:
+        static constexpr unsigned int NO_PASS = MAX_PASSES;
+
+        std::vector<GLuint> m_queries;
+        std::array<Frame, FRAMES_IN_FLIGHT> m_frames;
+        Frame* m_pCurrentFrame;
+        unsigned int m_frameIndex;
+        // Стек открытых проходов текущего кадра.
+        std::array<unsigned int, MAX_DEPTH> m_openPasses;
+        unsigned int m_depth;
+        uint64_t m_droppedFrames;
+    };
+}
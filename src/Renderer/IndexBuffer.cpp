@@ -1,5 +1,7 @@
 #include "IndexBuffer.h"
 
+#include "Renderer.h"
+
 namespace RenderEngine {
     IndexBuffer::IndexBuffer() noexcept : m_id(0), m_count(0) {}
 
@@ -27,6 +29,7 @@ namespace RenderEngine {
         glGenBuffers(1, &m_id);
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_id);
         glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_count * sizeof(GLuint), data, GL_STATIC_DRAW);
+        Renderer::countBufferUpload(m_count * sizeof(GLuint));
     }
 
     void IndexBuffer::bind() const noexcept {
@@ -0,0 +1,102 @@
+#include "OffscreenContext.h"
+
+#include "../Exception/Exception.h"
+
+#include <glad/glad.h>
+#ifdef BATTLECITY_EGL
+    #include <EGL/egl.h>
+    #include <EGL/eglext.h>
+#else
+    #include <GLFW/glfw3.h>
+#endif
+
+#include <cstring>
+
+namespace RenderEngine {
+
+    OffscreenContext::OffscreenContext() {
+#ifdef BATTLECITY_EGL
+        // Платформу surfaceless выбираем явно, иначе EGL ищет дисплей X11 или Wayland.
+        const char* clientExtensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+        auto getPlatformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(
+                eglGetProcAddress("eglGetPlatformDisplayEXT"));
+        EGLDisplay display = EGL_NO_DISPLAY;
+        if (clientExtensions && std::strstr(clientExtensions, "EGL_MESA_platform_surfaceless") && getPlatformDisplay) {
+            display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+        } else {
+            display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+        }
+        if (display == EGL_NO_DISPLAY || ! eglInitialize(display, nullptr, nullptr)) {
+            throw Exception::Exception("Can't initialize EGL display");
+        }
+        m_display = display;
+
+        const EGLint configAttributes[] = { EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT, EGL_NONE };
+        EGLConfig config = nullptr;
+        EGLint configsCount = 0;
+        eglChooseConfig(display, configAttributes, &config, 1, &configsCount);
+        const EGLint contextAttributes[] = {
+            EGL_CONTEXT_MAJOR_VERSION, 4,
+            EGL_CONTEXT_MINOR_VERSION, 1,
+            EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+            EGL_NONE
+        };
+        eglBindAPI(EGL_OPENGL_API);
+        EGLContext context = eglCreateContext(display, configsCount > 0 ? config : EGL_NO_CONFIG_KHR,
+                                              EGL_NO_CONTEXT, contextAttributes);
+        if (context == EGL_NO_CONTEXT) {
+            release();
+            throw Exception::Exception("Can't create surfaceless OpenGL 4.1 context");
+        }
+        m_context = context;
+        if (! eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context) ||
+            ! gladLoadGLLoader(reinterpret_cast<GLADloadproc>(eglGetProcAddress))) {
+            release();
+            throw Exception::Exception("Can't make surfaceless OpenGL context current");
+        }
+#else
+        if (! glfwInit()) {
+            throw Exception::Exception("glfwInit failed!");
+        }
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 1);
+        glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+        glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+        m_pWindow = glfwCreateWindow(64, 64, "Offscreen", nullptr, nullptr);
+        if (! m_pWindow) {
+            release();
+            throw Exception::Exception("glfwCreateWindow failed!");
+        }
+        glfwMakeContextCurrent(m_pWindow);
+        if (! gladLoadGL()) {
+            release();
+            throw Exception::Exception("Can't load GLAD!");
+        }
+#endif
+    }
+
+    OffscreenContext::~OffscreenContext() {
+        release();
+    }
+
+    void OffscreenContext::release() noexcept {
+#ifdef BATTLECITY_EGL
+        if (m_display) {
+            eglMakeCurrent(m_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+            if (m_context) {
+                eglDestroyContext(m_display, m_context);
+            }
+            eglTerminate(m_display);
+        }
+        m_context = nullptr;
+        m_display = nullptr;
+#else
+        if (m_pWindow) {
+            glfwDestroyWindow(m_pWindow);
+            m_pWindow = nullptr;
+        }
+        glfwTerminate();
+#endif
+    }
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+struct GLFWwindow;
+
+namespace RenderEngine {
+
+    /**
+     * Контекст OpenGL 4.1 без видимого окна для замеров и проверок на сервере сборки. При сборке
+     * с EGL (BATTLECITY_EGL) используется платформа surfaceless Mesa, которой не нужен дисплей
+     * (llvmpipe на Linux), иначе скрытое окно GLFW. Своего буфера кадра у контекста нет, рисовать
+     * нужно в FrameBuffer. Контекст становится текущим в создавшем его потоке.
+     * */
+    class OffscreenContext {
+    public:
+        OffscreenContext(const OffscreenContext&) = delete;
+        OffscreenContext& operator=(const OffscreenContext&) = delete;
+
+    public:
+        /**
+         * @throw Exception::Exception, если не удалось создать контекст или загрузить функции OpenGL.
+         * */
+        OffscreenContext();
+        /**
+         * Ресурсы OpenGL (ResourceManager::unloadAllResources()) нужно освободить до уничтожения
+         * контекста.
+         * */
+        ~OffscreenContext();
+
+    private:
+        void release() noexcept;
+
+    private:
+        // EGLDisplay и EGLContext, чтобы заголовок не зависел от EGL.
+        void* m_display = nullptr;
+        void* m_context = nullptr;
+        GLFWwindow* m_pWindow = nullptr;
+    };
+}
@@ -0,0 +1,116 @@
+#include "PacketRenderer.h"
+
+#include "ShaderProgram.h"
+#include "SpriteBatch.h"
+#include "Renderer.h"
+
+#include <glm/mat4x4.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+
+namespace RenderEngine {
+
+    PacketRenderer::PacketRenderer(const ShaderProgramHandle shaderProgram,
+                                   const unsigned int batchCapacity) :
+                                   m_shaderProgram(shaderProgram),
+                                   m_shaderPrograms{ m_shaderProgram },
+                                   m_batchCapacity(batchCapacity) {}
+
+    PacketRenderer::~PacketRenderer() {}
+
+    void PacketRenderer::addTexture(const TextureHandle texture, ShaderProgramHandle shaderProgram) {
+        if (findBatch(texture)) {
+            return;
+        }
+        if (! shaderProgram) {
+            shaderProgram = m_shaderProgram;
+        }
+        Texture2D* pTexture = getTexturePool().get(texture);
+        ShaderProgram* pShaderProgram = getShaderProgramPool().get(shaderProgram);
+        if (! pTexture || ! pShaderProgram) {
+            return;
+        }
+        if (std::find(m_shaderPrograms.begin(), m_shaderPrograms.end(), shaderProgram) == m_shaderPrograms.end()) {
+            m_shaderPrograms.push_back(shaderProgram);
+        }
+        m_batches.push_back({ texture, shaderProgram,
+                              std::make_unique<SpriteBatch>(pTexture, pShaderProgram, m_batchCapacity) });
+    }
+
+    void PacketRenderer::setCamera(const RenderPacket& packet) const {
+        const glm::vec2 rightTop = packet.cameraPosition + packet.cameraSize;
+        const glm::mat4 projectionMatrix = glm::ortho(packet.cameraPosition.x, rightTop.x,
+                                                      packet.cameraPosition.y, rightTop.y,
+                                                      -100.f, 100.f);
+        // Шейдер спрайтов первый и остается активным для слоев карты.
+        for (auto it = m_shaderPrograms.rbegin(); it != m_shaderPrograms.rend(); ++it) {
+            if (ShaderProgram* pShaderProgram = getShaderProgramPool().get(*it)) {
+                pShaderProgram->use();
+                pShaderProgram->setUniform("projectionMat", projectionMatrix);
+            }
+        }
+    }
+
+    void PacketRenderer::drawSprites(const RenderPacket& packet) const {
+        // Спрайты до первого прохода рисуются без замера.
+        drawSprites(packet, 0, packet.passes.empty() ? packet.sprites.size() : packet.passes.front().firstSprite);
+        for (size_t i = 0; i < packet.passes.size(); ++i) {
+            const size_t last = i + 1 < packet.passes.size() ? packet.passes[i + 1].firstSprite : packet.sprites.size();
+            PROFILE_GPU_PASS(packet.passes[i].name);
+            drawSprites(packet, packet.passes[i].firstSprite, last);
+        }
+    }
+
+    void PacketRenderer::drawSprites(const RenderPacket& packet, const size_t first, const size_t last) const {
+        SpriteBatch* pCurrentBatch = nullptr;
+        TextureHandle currentTexture;
+        // Разрешается вместе с пакетом, nullptr - команды текущей текстуры пропускаются.
+        const Texture2D* pCurrentTexture = nullptr;
+        uint8_t currentPaletteRow = 0;
+        for (size_t i = first; i < last; ++i) {
+            const RenderPacket::SpriteCommand& command = packet.sprites[i];
+            // Строка палитры задается на весь вызов отрисовки; у обычных текстур она не учитывается.
+            if (command.texture != currentTexture ||
+                (pCurrentTexture && command.paletteRow != currentPaletteRow && pCurrentTexture->isIndexed())) {
+                if (pCurrentBatch) {
+                    pCurrentBatch->end();
+                }
+                currentTexture = command.texture;
+                currentPaletteRow = command.paletteRow;
+                pCurrentBatch = findBatch(currentTexture);
+                pCurrentTexture = pCurrentBatch ? getTexturePool().get(currentTexture) : nullptr;
+                if (pCurrentBatch) {
+                    pCurrentBatch->setPaletteRow(currentPaletteRow);
+                    pCurrentBatch->begin();
+                }
+            }
+            if (! pCurrentBatch) {
+                continue;
+            }
+            if (! pCurrentBatch->draw(command.subTexture, command.position, command.size)) {
+                // Пакет заполнен: выводим накопленное и продолжаем с пустым.
+                pCurrentBatch->end();
+                pCurrentBatch->begin();
+                pCurrentBatch->draw(command.subTexture, command.position, command.size);
+            }
+        }
+        if (pCurrentBatch) {
+            pCurrentBatch->end();
+        }
+    }
+
+    SpriteBatch* PacketRenderer::findBatch(const TextureHandle texture) const noexcept {
+        for (const Batch& batch : m_batches) {
+            if (batch.texture != texture) {
+                continue;
+            }
+            // Пакет ссылается на объекты дескрипторов: удаленная текстура или программа не рисуется.
+            if (! getTexturePool().get(batch.texture) || ! getShaderProgramPool().get(batch.shaderProgram)) {
+                return nullptr;
+            }
+            return batch.pSpriteBatch.get();
+        }
+        return nullptr;
+    }
+}
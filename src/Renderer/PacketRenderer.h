@@ -0,0 +1,76 @@
+#pragma once
+
+#include "RenderPacket.h"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace RenderEngine {
+
+    class ShaderProgram;
+    class SpriteBatch;
+
+    /**
+     * Класс отрисовки спрайтов из RenderPacket. Для каждой зарегистрированной текстуры
+     * создается свой пакет SpriteBatch, подряд идущие команды с одной текстурой выводятся
+     * одним вызовом отрисовки; пакет индексированной текстуры прерывается и при смене строки
+     * палитры. Текстуры и шейдерные программы хранятся дескрипторами и разрешаются при каждой
+     * смене пакета, так что устаревший дескриптор в отладочной сборке останавливает программу.
+     * Используется только в потоке, владеющем контекстом OpenGL.
+     * */
+    class PacketRenderer {
+    public:
+        PacketRenderer() = delete;
+        PacketRenderer(const PacketRenderer&) = delete;
+        PacketRenderer& operator=(const PacketRenderer&) = delete;
+
+    public:
+        /**
+         * @param shaderProgram шейдерная программа спрайтов.
+         * @param batchCapacity сколько прямоугольников выводится за один вызов отрисовки.
+         * */
+        PacketRenderer(ShaderProgramHandle shaderProgram, unsigned int batchCapacity);
+        ~PacketRenderer();
+
+    public:
+        /**
+         * Метод регистрирует текстуру, на которую могут ссылаться команды пакетов.
+         * @param shaderProgram шейдерная программа для этой текстуры (например, спрайтов с
+         * палитрой для индексированной); пустой дескриптор - шейдерная программа спрайтов.
+         * */
+        void addTexture(TextureHandle texture, ShaderProgramHandle shaderProgram = {});
+        /**
+         * Метод устанавливает матрицу проекции по камере пакета во всех шейдерных программах
+         * текстур. Вызывается перед отрисовкой остальных слоев кадра (карты) шейдером спрайтов.
+         * */
+        void setCamera(const RenderPacket& packet) const;
+        /**
+         * Метод рисует спрайты пакета в порядке команд, замеряя время каждого прохода на
+         * видеокарте. Команды с незарегистрированной или удаленной текстурой пропускаются.
+         * */
+        void drawSprites(const RenderPacket& packet) const;
+
+    private:
+        void drawSprites(const RenderPacket& packet, size_t first, size_t last) const;
+        /**
+         * Метод возвращает пакет текстуры, если она зарегистрирована и еще существует.
+         * */
+        SpriteBatch* findBatch(TextureHandle texture) const noexcept;
+
+    private:
+        struct Batch {
+            TextureHandle texture;
+            ShaderProgramHandle shaderProgram;
+            // Ссылается на объекты дескрипторов выше и используется только после их проверки.
+            std::unique_ptr<SpriteBatch> pSpriteBatch;
+        };
+
+        ShaderProgramHandle m_shaderProgram;
+        // Шейдерные программы текстур без повторов, шейдер спрайтов первый.
+        std::vector<ShaderProgramHandle> m_shaderPrograms;
+        unsigned int m_batchCapacity;
+        // Текстур единицы, линейный поиск быстрее словаря.
+        std::vector<Batch> m_batches;
+    };
+}
@@ -0,0 +1,93 @@
+#include "Palette.h"
+
+#include "Texture2D.h"
+#include "../Exception/Exception.h"
+
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+
+namespace RenderEngine {
+    namespace {
+        uint32_t packColour(const uint8_t r, const uint8_t g, const uint8_t b, const uint8_t a) noexcept {
+            return (static_cast<uint32_t>(r) << 24) | (static_cast<uint32_t>(g) << 16) |
+                   (static_cast<uint32_t>(b) << 8) | a;
+        }
+    }
+
+    Palette::Palette(std::vector<Row> rows) :
+                     m_rows(std::move(rows)),
+                     m_coloursCount(0) {
+        if (m_rows.empty()) {
+            throw Exception::Exception("Palette has no rows");
+        }
+        m_coloursCount = static_cast<unsigned int>(m_rows.front().colours.size());
+        if (m_coloursCount == 0 || m_coloursCount > MAX_COLOURS) {
+            throw Exception::Exception("Palette must have from 1 to " + std::to_string(MAX_COLOURS) +
+                                       " colours, got " + std::to_string(m_coloursCount));
+        }
+
+        std::vector<unsigned char> texels;
+        texels.reserve(static_cast<size_t>(m_coloursCount) * m_rows.size() * 4);
+        for (const Row& row : m_rows) {
+            if (row.colours.size() != m_coloursCount) {
+                throw Exception::Exception("Palette row " + row.name + " has " + std::to_string(row.colours.size()) +
+                                           " colours instead of " + std::to_string(m_coloursCount));
+            }
+            for (const glm::u8vec4& colour : row.colours) {
+                texels.insert(texels.end(), { colour.r, colour.g, colour.b, colour.a });
+            }
+        }
+        // Палитра читается только texelFetch, фильтр не важен.
+        m_pTexture = std::make_unique<Texture2D>(static_cast<GLint>(m_coloursCount),
+                                                 static_cast<GLint>(m_rows.size()),
+                                                 texels.data(), 4, GL_NEAREST);
+    }
+
+    Palette::Palette(Palette&&) noexcept = default;
+    Palette::~Palette() = default;
+    Palette& Palette::operator=(Palette&&) noexcept = default;
+
+    std::vector<uint8_t> Palette::indexImage(const unsigned char* pPixels, const size_t pixelsCount,
+                                             const unsigned int channels) const {
+        std::unordered_map<uint32_t, uint8_t> indices;
+        int transparentIndex = -1;
+        for (const Row& row : m_rows) {
+            for (unsigned int i = 0; i < m_coloursCount; ++i) {
+                const glm::u8vec4& colour = row.colours[i];
+                indices.emplace(packColour(colour.r, colour.g, colour.b, colour.a), static_cast<uint8_t>(i));
+                if (colour.a == 0 && transparentIndex < 0) {
+                    transparentIndex = static_cast<int>(i);
+                }
+            }
+        }
+
+        std::vector<uint8_t> result(pixelsCount);
+        for (size_t i = 0; i < pixelsCount; ++i) {
+            const unsigned char* pPixel = pPixels + i * channels;
+            const uint8_t alpha = channels == 4 ? pPixel[3] : 255;
+            if (alpha == 0 && transparentIndex >= 0) {
+                result[i] = static_cast<uint8_t>(transparentIndex);
+                continue;
+            }
+            const auto it = indices.find(packColour(pPixel[0], pPixel[1], pPixel[2], alpha));
+            if (it == indices.end()) {
+                char colour[16];
+                std::snprintf(colour, sizeof(colour), "#%02x%02x%02x%02x", pPixel[0], pPixel[1], pPixel[2], alpha);
+                throw Exception::Exception("Colour " + std::string(colour) + " of pixel " + std::to_string(i) +
+                                           " is not in the palette");
+            }
+            result[i] = it->second;
+        }
+        return result;
+    }
+
+    int Palette::findRow(const std::string& name) const noexcept {
+        for (size_t i = 0; i < m_rows.size(); ++i) {
+            if (m_rows[i].name == name) {
+                return static_cast<int>(i);
+            }
+        }
+        return -1;
+    }
+}
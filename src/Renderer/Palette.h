@@ -0,0 +1,74 @@
+#pragma once
+
+#include <glm/vec4.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace RenderEngine {
+
+    class Texture2D;
+
+    /**
+     * Палитра индексированных текстур: таблица цветов RGBA, строки которой - варианты окраски
+     * одной картинки (желтый, зеленый, серебристый танк). Индексированная текстура (GL_R8)
+     * хранит номер столбца палитры, цвет выбирает шейдер спрайтов с палитрой по номеру строки,
+     * поэтому смена окраски - это смена строки, а не отдельная область атласа. Палитра
+     * загружается в текстуру GL_RGBA8 шириной в количество цветов и высотой в количество строк.
+     * */
+    class Palette {
+    public:
+        Palette() = delete;
+        Palette(const Palette&) = delete;
+        Palette& operator=(const Palette&) = delete;
+
+    public:
+        struct Row {
+            std::string name;
+            std::vector<glm::u8vec4> colours;
+        };
+
+        // Текстурный блок, к которому подключается текстура палитры вместе с индексированной
+        // текстурой (см. Texture2D::bind()).
+        static constexpr unsigned int TEXTURE_UNIT = 1;
+        static constexpr size_t MAX_COLOURS = 256;
+
+        /**
+         * @throw Exception::Exception, если строк нет, строки разной длины или цветов больше
+         * MAX_COLOURS.
+         * */
+        explicit Palette(std::vector<Row> rows);
+        Palette(Palette&&) noexcept;
+        ~Palette();
+
+        Palette& operator=(Palette&&) noexcept;
+
+        /**
+         * Метод переводит картинку в индексы палитры. Цвет ищется по всем строкам, при совпадении
+         * в нескольких строках берется первая; все полностью прозрачные пиксели получают индекс
+         * первого прозрачного цвета.
+         * @param pPixels пиксели картинки.
+         * @param pixelsCount количество пикселей.
+         * @param channels канальность картинки: 3 (RGB) или 4 (RGBA).
+         * @return по одному байту индекса на пиксель.
+         * @throw Exception::Exception, если цвета пикселя нет в палитре.
+         * */
+        std::vector<uint8_t> indexImage(const unsigned char* pPixels, size_t pixelsCount, unsigned int channels) const;
+        /**
+         * Метод возвращает номер строки с заданным именем или -1, если ее нет.
+         * */
+        int findRow(const std::string& name) const noexcept;
+
+        unsigned int getColoursCount() const noexcept { return m_coloursCount; }
+        unsigned int getRowsCount() const noexcept { return static_cast<unsigned int>(m_rows.size()); }
+        Texture2D* getTexture() const noexcept { return m_pTexture.get(); }
+
+    private:
+        std::vector<Row> m_rows;
+        unsigned int m_coloursCount;
+        std::unique_ptr<Texture2D> m_pTexture;
+    };
+}
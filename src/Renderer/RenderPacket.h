@@ -0,0 +1,109 @@
+#pragma once
+
+#include "Texture2D.h"
+#include "ResourceHandles.h"
+#include "../Utils/FrameArena.h"
+
+#include <glm/vec2.hpp>
+
+#include <cstdint>
+
+namespace RenderEngine {
+
+    /**
+     * Неизменяемое описание кадра, которое симуляция передает отрисовке: камера, список
+     * прямоугольников спрайтов в порядке отрисовки и изменения разрушаемой карты. Пакет не
+     * содержит объектов OpenGL, поэтому его можно заполнять в потоке симуляции и рисовать в
+     * потоке рендера. Векторы пакета живут в его собственной FrameArena, которая сбрасывается
+     * при очистке, так что повторно используемый пакет после первых кадров не обращается к куче,
+     * даже если спрайтов стало больше, чем в прошлых кадрах.
+     * */
+    struct RenderPacket {
+        RenderPacket(const RenderPacket&) = delete;
+        RenderPacket& operator=(const RenderPacket&) = delete;
+
+        struct SpriteCommand {
+            // Текстура должна быть зарегистрирована в PacketRenderer.
+            TextureHandle texture;
+            Texture2D::SubTexture2D subTexture;
+            glm::vec2 position;
+            glm::vec2 size;
+            // Строка палитры для индексированной текстуры (см. Palette).
+            uint8_t paletteRow;
+        };
+
+        /**
+         * Новая маска стен одной клетки карты (см. Terrain).
+         * */
+        struct WallMaskChange {
+            uint32_t cell;
+            uint8_t wallMask;
+        };
+
+        /**
+         * Именованная часть списка спрайтов, время которой замеряется отдельно (GpuTimer).
+         * Проход продолжается до начала следующего.
+         * */
+        struct Pass {
+            // Строковый литерал.
+            const char* name;
+            uint32_t firstSprite;
+        };
+
+        RenderPacket() :
+                     sprites(Utils::ArenaAllocator<SpriteCommand>(arena)),
+                     passes(Utils::ArenaAllocator<Pass>(arena)),
+                     wallMaskChanges(Utils::ArenaAllocator<WallMaskChange>(arena)),
+                     wallMasks(Utils::ArenaAllocator<uint8_t>(arena)) {
+        }
+
+        void clear() {
+            // Векторы отпускают память до сброса арены и сразу резервируют размер прошлого кадра,
+            // чтобы при заполнении не копироваться при росте.
+            const size_t spritesCount = sprites.size();
+            const size_t passesCount = passes.size();
+            const size_t wallMaskChangesCount = wallMaskChanges.size();
+            sprites = Utils::FrameVector<SpriteCommand>(sprites.get_allocator());
+            passes = Utils::FrameVector<Pass>(passes.get_allocator());
+            wallMaskChanges = Utils::FrameVector<WallMaskChange>(wallMaskChanges.get_allocator());
+            wallMasks = Utils::FrameVector<uint8_t>(wallMasks.get_allocator());
+            arena.reset();
+            sprites.reserve(spritesCount);
+            passes.reserve(passesCount);
+            wallMaskChanges.reserve(wallMaskChangesCount);
+            firstTerrainRevision = 0;
+            terrainRevision = 0;
+        }
+
+        void beginPass(const char* name) {
+            passes.push_back({ name, static_cast<uint32_t>(sprites.size()) });
+        }
+
+        void addSprite(const TextureHandle texture, const Texture2D::SubTexture2D& subTexture,
+                       const glm::vec2& position, const glm::vec2& size, const uint8_t paletteRow = 0) {
+            sprites.push_back({ texture, subTexture, position, size, paletteRow });
+        }
+
+        // Номер шага симуляции, по состоянию которого построен кадр.
+        uint64_t tick = 0;
+        // Видимая область мира: левый нижний угол и размер.
+        glm::vec2 cameraPosition = glm::vec2(0.f);
+        glm::vec2 cameraSize = glm::vec2(1.f);
+        // Объявлена до векторов, которые из нее выделяются.
+        Utils::FrameArena arena;
+        Utils::FrameVector<SpriteCommand> sprites;
+        Utils::FrameVector<Pass> passes;
+        // Изменения карты нумеруются ревизиями по порядку. Пакет доводит карту до terrainRevision:
+        // изменение wallMaskChanges[i] дает ревизию firstTerrainRevision + i + 1, отрисовка
+        // пропускает уже примененные.
+        uint64_t firstTerrainRevision = 0;
+        uint64_t terrainRevision = 0;
+        Utils::FrameVector<WallMaskChange> wallMaskChanges;
+        // Маски четвертей стен всех клеток карты (см. Terrain) вместо изменений. Заполняются,
+        // только если отрисовка отстала от карты сильнее, чем хранит журнал изменений.
+        Utils::FrameVector<uint8_t> wallMasks;
+        bool eagleDestroyed = false;
+        // Рисовать ли отладочный оверлей (DebugOverlay) поверх кадра.
+        bool showDebugOverlay = false;
+    };
+}
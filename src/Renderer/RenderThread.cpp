@@ -0,0 +1,155 @@
+#include "RenderThread.h"
+
+#include "Renderer.h"
+#include "../Profiler/Profiler.h"
+
+#include <GLFW/glfw3.h>
+
+#include <chrono>
+#include <utility>
+
+namespace {
+    uint64_t nowNs() noexcept {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void updateMax(std::atomic<uint64_t>& maximum, const uint64_t value) noexcept {
+        // Пишет только поток рендера, поэтому сравнение и запись не обязаны быть одной операцией.
+        if (value > maximum.load(std::memory_order_relaxed)) {
+            maximum.store(value, std::memory_order_relaxed);
+        }
+    }
+}
+
+namespace RenderEngine {
+
+    RenderThread::RenderThread(GLFWwindow* pWindow, RenderCallback render) :
+                               m_pWindow(pWindow),
+                               m_render(std::move(render)) {
+        m_thread = std::thread(&RenderThread::run, this);
+    }
+
+    RenderThread::~RenderThread() {
+        try {
+            stop();
+        } catch (...) {
+        }
+    }
+
+    void RenderThread::publish() {
+        m_packets.publish();
+        m_packetsPublished.fetch_add(1, std::memory_order_relaxed);
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_packetPending = true;
+        }
+        m_condition.notify_one();
+    }
+
+    void RenderThread::setViewport(const unsigned int width, const unsigned int height) noexcept {
+        // Свернутое окно имеет размер 0x0: такой размер не применяем.
+        if (width == 0 || height == 0) {
+            return;
+        }
+        m_pendingViewport.store((static_cast<uint64_t>(width) << 32) | height, std::memory_order_relaxed);
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_packetPending = true;
+        m_condition.notify_one();
+    }
+
+    void RenderThread::runTask(const std::function<void()>& task) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (isFinished()) {
+            return;
+        }
+        m_pTask = &task;
+        m_condition.notify_one();
+        m_taskCondition.wait(lock, [this]() { return m_pTask == nullptr; });
+        if (m_taskError) {
+            std::rethrow_exception(std::exchange(m_taskError, nullptr));
+        }
+    }
+
+    void RenderThread::stop() {
+        if (m_thread.joinable()) {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_stopRequested = true;
+            }
+            m_condition.notify_one();
+            m_thread.join();
+        }
+        if (m_error) {
+            std::rethrow_exception(std::exchange(m_error, nullptr));
+        }
+    }
+
+    RenderThread::Stats RenderThread::getStats() const noexcept {
+        Stats stats;
+        stats.packetsPublished = m_packetsPublished.load(std::memory_order_relaxed);
+        stats.framesRendered = m_framesRendered.load(std::memory_order_relaxed);
+        stats.maxSwapNs = m_maxSwapNs.load(std::memory_order_relaxed);
+        stats.maxRenderNs = m_maxRenderNs.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+    void RenderThread::run() noexcept {
+        PROFILE_THREAD_NAME("Render");
+        glfwMakeContextCurrent(m_pWindow);
+        try {
+            while (true) {
+                {
+                    std::unique_lock<std::mutex> lock(m_mutex);
+                    m_condition.wait(lock, [this]() { return m_packetPending || m_stopRequested || m_pTask; });
+                    if (m_pTask) {
+                        // Вызывающий поток ждет, поэтому задача выполняется под блокировкой.
+                        try {
+                            (*m_pTask)();
+                        } catch (...) {
+                            m_taskError = std::current_exception();
+                        }
+                        m_pTask = nullptr;
+                        m_taskCondition.notify_one();
+                        continue;
+                    }
+                    if (m_stopRequested) {
+                        break;
+                    }
+                    m_packetPending = false;
+                }
+                applyViewport();
+                // Без нового пакета (например, изменился только размер окна) кадр не перерисовываем.
+                if (! m_packets.acquire()) {
+                    continue;
+                }
+                const uint64_t renderStart = nowNs();
+                m_render(m_packets.readBuffer());
+                const uint64_t swapStart = nowNs();
+                {
+                    PROFILE_SCOPE("glfwSwapBuffers");
+                    glfwSwapBuffers(m_pWindow);
+                }
+                const uint64_t swapEnd = nowNs();
+                updateMax(m_maxRenderNs, swapStart - renderStart);
+                updateMax(m_maxSwapNs, swapEnd - swapStart);
+                m_framesRendered.fetch_add(1, std::memory_order_relaxed);
+            }
+        } catch (...) {
+            m_error = std::current_exception();
+        }
+        glfwMakeContextCurrent(nullptr);
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_finished.store(true, std::memory_order_release);
+        // Задача, поставленная после завершения цикла, не выполнится: отпускаем ждущий поток.
+        m_pTask = nullptr;
+        m_taskCondition.notify_one();
+    }
+
+    void RenderThread::applyViewport() noexcept {
+        const uint64_t viewport = m_pendingViewport.exchange(0, std::memory_order_relaxed);
+        if (viewport != 0) {
+            Renderer::setViewport(static_cast<GLuint>(viewport >> 32), static_cast<GLuint>(viewport & 0xFFFFFFFF));
+        }
+    }
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include "RenderPacket.h"
+#include "../Utils/TripleBuffer.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+struct GLFWwindow;
+
+namespace RenderEngine {
+
+    /**
+     * Поток отрисовки. Владеет контекстом OpenGL окна: забирает из тройного буфера самый свежий
+     * пакет кадра, рисует его и вызывает glfwSwapBuffers. Поток симуляции заполняет пакеты и
+     * никогда не ждет отрисовку, поэтому блокирующий обмен буферов (вертикальная синхронизация)
+     * не задерживает ввод и шаги симуляции. Если симуляция опережает отрисовку, лишние пакеты
+     * пропускаются.
+     * */
+    class RenderThread {
+    public:
+        RenderThread() = delete;
+        RenderThread(const RenderThread&) = delete;
+        RenderThread& operator=(const RenderThread&) = delete;
+
+    public:
+        using RenderCallback = std::function<void(const RenderPacket&)>;
+
+        struct Stats {
+            // Опубликованные и нарисованные пакеты.
+            uint64_t packetsPublished = 0;
+            uint64_t framesRendered = 0;
+            uint64_t maxSwapNs = 0;
+            uint64_t maxRenderNs = 0;
+        };
+
+        /**
+         * Создает поток и делает в нем текущим контекст окна. Перед вызовом контекст должен
+         * быть освобожден в вызывающем потоке (glfwMakeContextCurrent(nullptr)).
+         * @param pWindow окно, в которое выполняется отрисовка.
+         * @param render функция отрисовки кадра по пакету, вызывается в потоке рендера.
+         * */
+        RenderThread(GLFWwindow* pWindow, RenderCallback render);
+        /**
+         * Останавливает поток, не пробрасывая его ошибку.
+         * */
+        ~RenderThread();
+
+    public:
+        /**
+         * Пакет, который заполняет поток симуляции. Принадлежит ему до вызова publish().
+         * */
+        RenderPacket& getWritePacket() noexcept { return m_packets.writeBuffer(); }
+        /**
+         * Метод передает заполненный пакет потоку рендера и будит его. Не ждет отрисовку.
+         * */
+        void publish();
+        /**
+         * Метод запоминает новый размер области вывода, он применяется в потоке рендера перед
+         * следующим кадром. Может вызываться из обработчика изменения размера окна.
+         * */
+        void setViewport(unsigned int width, unsigned int height) noexcept;
+        /**
+         * Метод выполняет task в потоке рендера между кадрами и ждет завершения. Пока вызывающий
+         * поток ждет, task может менять и объекты OpenGL, и состояние, которым владеет
+         * вызывающий поток (например, горячая перезагрузка ресурсов между шагами симуляции).
+         * @throw исключение, выброшенное task. Если поток рендера уже завершился, task не
+         * выполняется.
+         * */
+        void runTask(const std::function<void()>& task);
+        /**
+         * Метод дожидается завершения потока и освобождает в нем контекст OpenGL.
+         * @throw исключение, с которым завершилась отрисовка.
+         * */
+        void stop();
+
+        /**
+         * Поток завершился: остановлен или отрисовка выбросила исключение (его пробросит stop()).
+         * */
+        bool isFinished() const noexcept { return m_finished.load(std::memory_order_acquire); }
+        Stats getStats() const noexcept;
+
+    private:
+        void run() noexcept;
+        void applyViewport() noexcept;
+
+    private:
+        GLFWwindow* m_pWindow;
+        RenderCallback m_render;
+        Utils::TripleBuffer<RenderPacket> m_packets;
+
+        std::mutex m_mutex;
+        std::condition_variable m_condition;
+        bool m_packetPending = false;
+        bool m_stopRequested = false;
+        // Задача runTask() и ее результат, защищены m_mutex.
+        const std::function<void()>* m_pTask = nullptr;
+        std::exception_ptr m_taskError;
+        std::condition_variable m_taskCondition;
+
+        // Ширина в старших 32 битах, высота в младших; 0 - размер не менялся.
+        std::atomic<uint64_t> m_pendingViewport{ 0 };
+        std::atomic<uint64_t> m_packetsPublished{ 0 };
+        std::atomic<uint64_t> m_framesRendered{ 0 };
+        std::atomic<uint64_t> m_maxSwapNs{ 0 };
+        std::atomic<uint64_t> m_maxRenderNs{ 0 };
+        std::atomic<bool> m_finished{ false };
+        std::exception_ptr m_error;
+        std::thread m_thread;
+    };
+}
@@ -1,6 +1,13 @@
 #include "Renderer.h"
 
+#include "GpuTimer.h"
+#include "../Profiler/Profiler.h"
+
+#include <iostream>
+
 namespace RenderEngine {
+    std::unique_ptr<GpuTimer> Renderer::m_pGpuTimer;
+
     void Renderer::draw(const RenderEngine::VertexArray& vertexArray,
                         const RenderEngine::IndexBuffer& indexBuffer,
                         const RenderEngine::ShaderProgram& shaderProgram) noexcept {
@@ -9,6 +16,19 @@ namespace RenderEngine {
         indexBuffer.bind();
 
         glDrawElements(GL_TRIANGLES, indexBuffer.getCount(), GL_UNSIGNED_INT, nullptr);
+        ++m_frameStats.drawCalls;
+    }
+
+    void Renderer::draw(const RenderEngine::VertexArray& vertexArray,
+                        const RenderEngine::IndexBuffer& indexBuffer,
+                        const RenderEngine::ShaderProgram& shaderProgram,
+                        const GLuint indicesCount) noexcept {
+        shaderProgram.use();
+        vertexArray.bind();
+        indexBuffer.bind();
+
+        glDrawElements(GL_TRIANGLES, indicesCount, GL_UNSIGNED_INT, nullptr);
+        ++m_frameStats.drawCalls;
     }
 
     void Renderer::setClearColour(const GLfloat r, const GLfloat g, const GLfloat b,
@@ -32,4 +52,41 @@ namespace RenderEngine {
     std::string Renderer::getVersionStr() noexcept {
         return { reinterpret_cast<const char*>(glGetString(GL_VERSION)) };
     }
+
+    void Renderer::beginGpuFrame() {
+        if (! Profiler::isRecording()) {
+            return;
+        }
+        // Запросы создаются при первой записи, обычная игра их не использует.
+        if (! m_pGpuTimer) {
+            m_pGpuTimer = std::make_unique<GpuTimer>();
+        }
+        m_pGpuTimer->beginFrame();
+    }
+
+    void Renderer::endGpuFrame() noexcept {
+        if (m_pGpuTimer) {
+            m_pGpuTimer->endFrame();
+        }
+    }
+
+    void Renderer::beginGpuPass(const char* name) noexcept {
+        if (m_pGpuTimer) {
+            m_pGpuTimer->beginPass(name);
+        }
+    }
+
+    void Renderer::endGpuPass() noexcept {
+        if (m_pGpuTimer) {
+            m_pGpuTimer->endPass();
+        }
+    }
+
+    void Renderer::releaseGpuTimer() noexcept {
+        if (m_pGpuTimer && m_pGpuTimer->droppedFrames() > 0) {
+            std::cerr << "GPU timer: " << m_pGpuTimer->droppedFrames()
+                      << " frames dropped, results were not ready in time" << std::endl;
+        }
+        m_pGpuTimer.reset();
+    }
 }
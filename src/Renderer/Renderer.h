@@ -3,13 +3,37 @@
 #include "VertexArray.h"
 #include "IndexBuffer.h"
 #include "ShaderProgram.h"
+#include "../Profiler/Profiler.h"
+
+#include <cstdint>
+#include <memory>
 
 namespace RenderEngine {
+    class GpuTimer;
+
+    /**
+     * Счетчики работы с OpenGL за кадр для отладочного оверлея (DebugOverlay).
+     * */
+    struct FrameStats {
+        uint32_t drawCalls = 0;
+        uint32_t textureBinds = 0;
+        uint32_t bufferUploads = 0;
+        uint64_t uploadedBytes = 0;
+    };
+
     class Renderer {
     public:
         static void draw(const VertexArray& vertexArray,
                          const IndexBuffer& indexBuffer,
                          const ShaderProgram& shaderProgram) noexcept;
+        /**
+         * Метод рисует только первые indicesCount индексов из indexBuffer. Используется
+         * пакетной отрисовкой, у которой буфер индексов выделен с запасом.
+         * */
+        static void draw(const VertexArray& vertexArray,
+                         const IndexBuffer& indexBuffer,
+                         const ShaderProgram& shaderProgram,
+                         GLuint indicesCount) noexcept;
         static void setClearColour(GLfloat r, GLfloat g, GLfloat b, GLfloat a) noexcept;
         static void clear() noexcept;
         static void setViewport(GLuint width, GLuint height,
@@ -17,5 +41,60 @@ namespace RenderEngine {
 
         static std::string getRendererStr() noexcept;
         static std::string getVersionStr() noexcept;
+
+        /**
+         * Методы замеряют время кадра и его проходов на видеокарте (см. GpuTimer), пока идет
+         * запись профилировщика. Вне записи ничего не делают. Вызываются в потоке, владеющем
+         * контекстом OpenGL; name должна быть строковым литералом.
+         * */
+        static void beginGpuFrame();
+        static void endGpuFrame() noexcept;
+        static void beginGpuPass(const char* name) noexcept;
+        static void endGpuPass() noexcept;
+        /**
+         * Метод удаляет запросы замера времени. Вызывается до уничтожения контекста OpenGL.
+         * */
+        static void releaseGpuTimer() noexcept;
+
+        /**
+         * Счетчики накапливаются с последнего resetFrameStats(). Меняются только в потоке,
+         * владеющем контекстом OpenGL. resetFrameStats() вызывается в начале кадра и
+         * увеличивает номер кадра.
+         * */
+        static const FrameStats& getFrameStats() noexcept { return m_frameStats; }
+        static void resetFrameStats() noexcept {
+            m_frameStats = FrameStats();
+            ++m_frameIndex;
+        }
+        static uint64_t getFrameIndex() noexcept { return m_frameIndex; }
+        static void countTextureBind() noexcept { ++m_frameStats.textureBinds; }
+        static void countBufferUpload(const uint64_t bytes) noexcept {
+            ++m_frameStats.bufferUploads;
+            m_frameStats.uploadedBytes += bytes;
+        }
+
+    private:
+        static std::unique_ptr<GpuTimer> m_pGpuTimer;
+        // Определен в заголовке: Texture2D и VertexBuffer собираются и без Renderer.cpp.
+        inline static FrameStats m_frameStats;
+        inline static uint64_t m_frameIndex = 0;
+    };
+
+    /**
+     * Замер времени прохода на видеокарте в пределах области видимости.
+     * */
+    class GpuPassScope {
+    public:
+        GpuPassScope(const GpuPassScope&) = delete;
+        GpuPassScope& operator=(const GpuPassScope&) = delete;
+
+        explicit GpuPassScope(const char* name) noexcept { Renderer::beginGpuPass(name); }
+        ~GpuPassScope() { Renderer::endGpuPass(); }
     };
 }
+
+#ifdef BATTLECITY_PROFILING
+    #define PROFILE_GPU_PASS(name) RenderEngine::GpuPassScope PROFILE_CONCAT(gpuPassScope, __LINE__)(name)
+#else
+    #define PROFILE_GPU_PASS(name) ((void)0)
+#endif
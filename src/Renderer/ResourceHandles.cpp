@@ -0,0 +1,19 @@
+#include "ResourceHandles.h"
+
+#include "ShaderProgram.h"
+#include "Texture2D.h"
+
+namespace RenderEngine {
+
+    // Локальные статические переменные создаются при первом обращении, поэтому пулы доступны
+    // из статических объектов других единиц трансляции.
+    Utils::HandlePool<Texture2D>& getTexturePool() noexcept {
+        static Utils::HandlePool<Texture2D> texturePool;
+        return texturePool;
+    }
+
+    Utils::HandlePool<ShaderProgram>& getShaderProgramPool() noexcept {
+        static Utils::HandlePool<ShaderProgram> shaderProgramPool;
+        return shaderProgramPool;
+    }
+}
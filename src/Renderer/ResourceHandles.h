@@ -0,0 +1,21 @@
+#pragma once
+
+#include "../Utils/HandlePool.h"
+
+namespace RenderEngine {
+
+    class ShaderProgram;
+    class Texture2D;
+
+    /**
+     * Дескрипторы текстур и шейдерных программ. Объекты создает и удаляет ResourceManager, но
+     * пулы принадлежат движку, чтобы спрайты и отрисовка пакетов хранили дескрипторы и разрешали
+     * их в момент использования: устаревший дескриптор в отладочной сборке останавливает
+     * программу (assert), в остальных объект просто не рисуется.
+     * */
+    using TextureHandle = Utils::Handle<Texture2D>;
+    using ShaderProgramHandle = Utils::Handle<ShaderProgram>;
+
+    Utils::HandlePool<Texture2D>& getTexturePool() noexcept;
+    Utils::HandlePool<ShaderProgram>& getShaderProgramPool() noexcept;
+}
@@ -0,0 +1,69 @@
+#include "ScaledRenderTarget.h"
+
+#include "FrameBuffer.h"
+#include "Renderer.h"
+#include "ShaderProgram.h"
+#include "SpriteBatch.h"
+
+#include <glm/mat4x4.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace RenderEngine {
+
+    ScaledRenderTarget::ScaledRenderTarget(const unsigned int width, const unsigned int height,
+                                           const ShaderProgramHandle shaderProgram) :
+                                           m_pFrameBuffer(std::make_unique<FrameBuffer>(width, height)),
+                                           m_shaderProgram(shaderProgram),
+                                           m_pBatch(std::make_unique<SpriteBatch>(m_pFrameBuffer->getColourTexture(),
+                                                                                  getShaderProgramPool().get(m_shaderProgram),
+                                                                                  1)),
+                                           m_target(0),
+                                           m_targetViewport{} {
+    }
+
+    ScaledRenderTarget::~ScaledRenderTarget() = default;
+
+    void ScaledRenderTarget::begin() noexcept {
+        // Целью может быть окно или буфер отрисовки без окна, поэтому она не задается снаружи.
+        glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &m_target);
+        glGetIntegerv(GL_VIEWPORT, m_targetViewport.data());
+        m_pFrameBuffer->bind();
+    }
+
+    void ScaledRenderTarget::present() {
+        glBindFramebuffer(GL_FRAMEBUFFER, static_cast<GLuint>(m_target));
+        const GLint width = m_targetViewport[2];
+        const GLint height = m_targetViewport[3];
+        Renderer::setViewport(static_cast<GLuint>(width), static_cast<GLuint>(height),
+                              static_cast<GLuint>(m_targetViewport[0]), static_cast<GLuint>(m_targetViewport[1]));
+        Renderer::clear();
+        // Пакет ссылается на шейдерную программу дескриптора.
+        ShaderProgram* pShaderProgram = getShaderProgramPool().get(m_shaderProgram);
+        if (! pShaderProgram) {
+            return;
+        }
+
+        const glm::vec2 resolution(getResolution());
+        const float fitScale = std::min(static_cast<float>(width) / resolution.x,
+                                        static_cast<float>(height) / resolution.y);
+        // Целый масштаб сохраняет все пиксели одинакового размера; дробный только при уменьшении.
+        const float scale = fitScale >= 1.f ? std::floor(fitScale) : fitScale;
+        const glm::vec2 size = resolution * scale;
+        const glm::vec2 position(std::floor((static_cast<float>(width) - size.x) / 2.f),
+                                 std::floor((static_cast<float>(height) - size.y) / 2.f));
+
+        pShaderProgram->use();
+        pShaderProgram->setUniform("projectionMat", glm::ortho(0.f, static_cast<float>(width),
+                                                               0.f, static_cast<float>(height), -100.f, 100.f));
+        m_pBatch->begin();
+        m_pBatch->draw(Texture2D::SubTexture2D(), position, size);
+        m_pBatch->end();
+    }
+
+    glm::uvec2 ScaledRenderTarget::getResolution() const noexcept {
+        return glm::uvec2(m_pFrameBuffer->width(), m_pFrameBuffer->height());
+    }
+}
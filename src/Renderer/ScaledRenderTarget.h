@@ -0,0 +1,62 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <glm/vec2.hpp>
+
+#include <array>
+#include <memory>
+
+#include "ResourceHandles.h"
+
+namespace RenderEngine {
+
+    class FrameBuffer;
+    class ShaderProgram;
+    class SpriteBatch;
+
+    /**
+     * Отрисовка сцены в фиксированном внутреннем разрешении (например, 256x240 как у NES) с
+     * последующим выводом в буфер кадра окна. Изображение увеличивается в целое число раз с
+     * фильтрацией GL_NEAREST и выводится по центру, поля закрашиваются цветом очистки; если окно
+     * меньше внутреннего разрешения, изображение уменьшается с сохранением пропорций. Стоимость
+     * отрисовки сцены не зависит от размера окна. Вывод рисуется прямоугольником шейдером
+     * спрайтов, а не glBlitFramebuffer: программные растеризаторы выполняют масштабирующее
+     * копирование медленно.
+     * */
+    class ScaledRenderTarget {
+    public:
+        ScaledRenderTarget() = delete;
+        ScaledRenderTarget(const ScaledRenderTarget&) = delete;
+        ScaledRenderTarget& operator=(const ScaledRenderTarget&) = delete;
+
+    public:
+        /**
+         * @param shaderProgram шейдерная программа спрайтов.
+         * @throw Exception::Exception, если буфер кадра не удалось создать.
+         * */
+        ScaledRenderTarget(unsigned int width, unsigned int height, ShaderProgramHandle shaderProgram);
+        ~ScaledRenderTarget();
+
+        /**
+         * Метод запоминает текущий буфер кадра и область вывода и делает целью отрисовки
+         * внутренний буфер.
+         * */
+        void begin() noexcept;
+        /**
+         * Метод выводит внутренний буфер в запомненный буфер кадра и восстанавливает его область
+         * вывода. Меняет матрицу проекции шейдера спрайтов. С удаленной шейдерной программой
+         * только очищает цель.
+         * */
+        void present();
+
+        glm::uvec2 getResolution() const noexcept;
+
+    private:
+        std::unique_ptr<FrameBuffer> m_pFrameBuffer;
+        ShaderProgramHandle m_shaderProgram;
+        std::unique_ptr<SpriteBatch> m_pBatch;
+        GLint m_target;
+        // X, Y, ширина и высота области вывода цели.
+        std::array<GLint, 4> m_targetViewport;
+    };
+}
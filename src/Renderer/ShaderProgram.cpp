@@ -2,9 +2,65 @@
 
 #include <glm/gtc/type_ptr.hpp>
 
+#include <utility>
+
 #include "../Exception/Exception.h"
 
 namespace RenderEngine {
+    namespace {
+        /**
+         * Функция копирует значения активных uniform программы from в одноименные uniform
+         * программы to. Массивы копируются только первым элементом.
+         * */
+        void copyUniforms(const GLuint from, const GLuint to) noexcept {
+            GLint count = 0;
+            glGetProgramiv(from, GL_ACTIVE_UNIFORMS, &count);
+            for (GLint i = 0; i < count; ++i) {
+                GLchar name[256];
+                GLint size = 0;
+                GLenum type = 0;
+                glGetActiveUniform(from, static_cast<GLuint>(i), sizeof(name), nullptr, &size, &type, name);
+                const GLint fromLocation = glGetUniformLocation(from, name);
+                const GLint toLocation = glGetUniformLocation(to, name);
+                if (fromLocation == -1 || toLocation == -1) {
+                    continue;
+                }
+                GLint intValue = 0;
+                GLfloat floatValues[16];
+                switch (type) {
+                    case GL_INT:
+                    case GL_BOOL:
+                    case GL_SAMPLER_2D:
+                        glGetUniformiv(from, fromLocation, &intValue);
+                        glProgramUniform1i(to, toLocation, intValue);
+                        break;
+                    case GL_FLOAT:
+                        glGetUniformfv(from, fromLocation, floatValues);
+                        glProgramUniform1fv(to, toLocation, 1, floatValues);
+                        break;
+                    case GL_FLOAT_VEC2:
+                        glGetUniformfv(from, fromLocation, floatValues);
+                        glProgramUniform2fv(to, toLocation, 1, floatValues);
+                        break;
+                    case GL_FLOAT_VEC3:
+                        glGetUniformfv(from, fromLocation, floatValues);
+                        glProgramUniform3fv(to, toLocation, 1, floatValues);
+                        break;
+                    case GL_FLOAT_VEC4:
+                        glGetUniformfv(from, fromLocation, floatValues);
+                        glProgramUniform4fv(to, toLocation, 1, floatValues);
+                        break;
+                    case GL_FLOAT_MAT4:
+                        glGetUniformfv(from, fromLocation, floatValues);
+                        glProgramUniformMatrix4fv(to, toLocation, 1, GL_FALSE, floatValues);
+                        break;
+                    default:
+                        break;
+                }
+            }
+        }
+    }
+
     ShaderProgram::ShaderProgram(const std::string& vertexShader,
                                  const std::string& fragmentShader) {
         GLuint vertexShaderID;
@@ -38,6 +94,9 @@ namespace RenderEngine {
         if (! success) {
             GLchar infoLog[1024];
             glGetProgramInfoLog(m_ID, 1024, nullptr, infoLog);
+            // Деструктор не вызывается, если конструктор бросил исключение.
+            glDeleteProgram(m_ID);
+            m_ID = 0;
             std::string msg("ERROR::SHADER: Linking-time error\n");
             msg += infoLog;
             throw Exception::Exception(msg);
@@ -58,6 +117,19 @@ namespace RenderEngine {
         glDeleteProgram(m_ID);
     }
 
+    void ShaderProgram::reload(const std::string& vertexShader, const std::string& fragmentShader) {
+        ShaderProgram newProgram(vertexShader, fragmentShader);
+        copyUniforms(m_ID, newProgram.m_ID);
+        GLint currentProgram = 0;
+        glGetIntegerv(GL_CURRENT_PROGRAM, &currentProgram);
+        // Старая программа удаляется деструктором newProgram.
+        std::swap(m_ID, newProgram.m_ID);
+        m_isCompiled = true;
+        if (static_cast<GLuint>(currentProgram) == newProgram.m_ID) {
+            glUseProgram(m_ID);
+        }
+    }
+
     void ShaderProgram::use() const noexcept {
         glUseProgram(m_ID);
 
@@ -42,6 +42,14 @@ namespace RenderEngine {
         ShaderProgram& operator=(ShaderProgram&& shaderProgram) noexcept;
 
     public:
+        /**
+         * Метод пересобирает программу из нового исходного кода на месте, так что все владельцы
+         * указателя на нее используют новую программу. Значения uniform переносятся из старой
+         * программы по именам.
+         * @throw Exception::Exception если новые шейдеры не собрались; старая программа
+         * остается без изменений.
+         * */
+        void reload(const std::string& vertexShader, const std::string& fragmentShader);
         bool isCompiled() const { return m_isCompiled; }
         /**
          * Метод запускает шейдерную программу.
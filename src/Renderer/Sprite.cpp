@@ -3,24 +3,26 @@
 #include "ShaderProgram.h"
 #include "Renderer.h"
 #include "Texture2D.h"
+#include "../Profiler/Profiler.h"
 
 #include <glm/mat4x4.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
 namespace RenderEngine {
 
-    Sprite::Sprite(std::shared_ptr<Texture2D> pTexture,
+    Sprite::Sprite(const TextureHandle texture,
                    const std::string& initialSubTexture,
-                   std::shared_ptr<ShaderProgram> pShaderProgram,
+                   const ShaderProgramHandle shaderProgram,
                    const glm::vec2& position,
                    const glm::vec2& size,
                    const float rotation) :
 
-                   m_pTexture(std::move(pTexture)),
-                   m_pShaderProgram(std::move(pShaderProgram)),
+                   m_texture(texture),
+                   m_shaderProgram(shaderProgram),
                    m_position(position),
                    m_size(size),
-                   m_rotation(rotation) {
+                   m_rotation(rotation),
+                   m_subTextureName(initialSubTexture) {
         const GLfloat vertexCoords[] {
             // 1---2
             // | / |
@@ -33,14 +35,14 @@ namespace RenderEngine {
             1.f, 0.f
         };
 
-        auto subTexture = m_pTexture->getSubTexture(initialSubTexture);
+        m_subTexture = findSubTexture(m_subTextureName);
 
         const GLfloat textureCoords[] {
             // U  V
-            subTexture.leftBottomUV.x, subTexture.leftBottomUV.y,
-            subTexture.leftBottomUV.x, subTexture.rightTopUV.y,
-            subTexture.rightTopUV.x,   subTexture.rightTopUV.y,
-            subTexture.rightTopUV.x,   subTexture.leftBottomUV.y,
+            m_subTexture.leftBottomUV.x, m_subTexture.leftBottomUV.y,
+            m_subTexture.leftBottomUV.x, m_subTexture.rightTopUV.y,
+            m_subTexture.rightTopUV.x,   m_subTexture.rightTopUV.y,
+            m_subTexture.rightTopUV.x,   m_subTexture.leftBottomUV.y,
         };
 
         const GLuint indices[] {
@@ -65,7 +67,13 @@ namespace RenderEngine {
     }
 
     void Sprite::render() const {
-        m_pShaderProgram->use();
+        PROFILE_SCOPE("Sprite::render");
+        const Texture2D* pTexture = getTexturePool().get(m_texture);
+        ShaderProgram* pShaderProgram = getShaderProgramPool().get(m_shaderProgram);
+        if (! pTexture || ! pShaderProgram) {
+            return;
+        }
+        pShaderProgram->use();
 
         glm::mat4 model(1.f);
 
@@ -75,14 +83,35 @@ namespace RenderEngine {
         model = glm::translate(model, glm::vec3(-0.5f * m_size.x, -0.5f * m_size.y, 0.f));
         model = glm::scale(model, glm::vec3(m_size, 1.f));
 
-        m_pShaderProgram->setUniform("modelMat", model);
+        pShaderProgram->setUniform("modelMat", model);
 
         glActiveTexture(GL_TEXTURE0);
-        m_pTexture->bind();
+        pTexture->bind();
 
         glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, nullptr);
 
-        Renderer::draw(m_vertexArray, m_indexBuffer, *m_pShaderProgram);
+        Renderer::draw(m_vertexArray, m_indexBuffer, *pShaderProgram);
+    }
+
+    void Sprite::resolveSubTexture() {
+        m_subTexture = findSubTexture(m_subTextureName);
+
+        const GLfloat textureCoords[] {
+            // U  V
+            m_subTexture.leftBottomUV.x, m_subTexture.leftBottomUV.y,
+            m_subTexture.leftBottomUV.x, m_subTexture.rightTopUV.y,
+            m_subTexture.rightTopUV.x,   m_subTexture.rightTopUV.y,
+            m_subTexture.rightTopUV.x,   m_subTexture.leftBottomUV.y,
+        };
+        m_textureCoordsBuffer.update(textureCoords, 2 * 4 * sizeof(GLfloat));
+        m_textureCoordsBuffer.unbind();
+    }
+
+    Texture2D::SubTexture2D Sprite::findSubTexture(const std::string& name) const {
+        if (const Texture2D* pTexture = getTexturePool().get(m_texture)) {
+            return pTexture->getSubTexture(name);
+        }
+        return Texture2D::SubTexture2D();
     }
 
     void Sprite::setPosition(const glm::vec2& position) {
@@ -3,6 +3,8 @@
 #include "VertexBuffer.h"
 #include "IndexBuffer.h"
 #include "VertexArray.h"
+#include "Texture2D.h"
+#include "ResourceHandles.h"
 
 #include <glad/glad.h>
 #include <glm/vec2.hpp>
@@ -12,14 +14,17 @@
 
 namespace RenderEngine {
 
-    class Texture2D;
     class ShaderProgram;
 
     class Sprite {
 	public:
-        Sprite(std::shared_ptr<Texture2D> pTexture,
+        /**
+         * @param texture дескриптор текстуры спрайта.
+         * @param shaderProgram дескриптор шейдерной программы для рендеринга текстуры.
+         * */
+        Sprite(TextureHandle texture,
                const std::string& initialSubTexture,
-               std::shared_ptr<ShaderProgram> pShaderProgram,
+               ShaderProgramHandle shaderProgram,
                const glm::vec2& position = glm::vec2(0.f),
                const glm::vec2& size = glm::vec2(1.f),
                float rotation = 0.f);
@@ -33,13 +38,35 @@ namespace RenderEngine {
         void setPosition(const glm::vec2& position);
         void setSize(const glm::vec2& size);
         void setRotation(float rotation);
+        const glm::vec2& getSize() const { return m_size; }
+        const glm::vec2& getPosition() const { return m_position; }
+        TextureHandle getTexture() const { return m_texture; }
+        /**
+         * Метод возвращает область текстуры, которую спрайт рисует сейчас. Используется
+         * пакетной отрисовкой вместо собственных буферов спрайта.
+         * */
+        virtual Texture2D::SubTexture2D getSubTexture() const { return m_subTexture; }
+        /**
+         * Метод заново находит область текстуры по имени. Вызывается после перезагрузки атласа,
+         * в которой области могли переместиться.
+         * */
+        virtual void resolveSubTexture();
 
     protected:
-        std::shared_ptr<Texture2D> m_pTexture;
-        std::shared_ptr<ShaderProgram> m_pShaderProgram;
+        /**
+         * Метод ищет область текстуры по имени.
+         * @return область по умолчанию, если дескриптор текстуры устарел.
+         * */
+        Texture2D::SubTexture2D findSubTexture(const std::string& name) const;
+
+    protected:
+        TextureHandle m_texture;
+        ShaderProgramHandle m_shaderProgram;
         glm::vec2 m_position;
         glm::vec2 m_size;
         float m_rotation;
+        std::string m_subTextureName;
+        Texture2D::SubTexture2D m_subTexture;
 
         VertexArray m_vertexArray;
         VertexBuffer m_vertexCoordsBuffer;
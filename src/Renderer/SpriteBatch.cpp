@@ -0,0 +1,89 @@
+#include "SpriteBatch.h"
+
+#include "ShaderProgram.h"
+#include "Renderer.h"
+
+#include <glm/mat4x4.hpp>
+
+namespace RenderEngine {
+
+    SpriteBatch::SpriteBatch(Texture2D* pTexture,
+                             ShaderProgram* pShaderProgram,
+                             const unsigned int capacity) :
+                             m_pTexture(pTexture),
+                             m_pShaderProgram(pShaderProgram),
+                             m_capacity(capacity),
+                             m_count(0),
+                             m_paletteRow(0),
+                             m_vertices(capacity * FLOATS_PER_QUAD, 0.f) {
+        m_vertexBuffer.init(nullptr, m_capacity * FLOATS_PER_QUAD * sizeof(GLfloat), GL_DYNAMIC_DRAW);
+        VertexBufferLayout vertexLayout;
+        vertexLayout.reserveElements(2);
+        vertexLayout.addElementLayout(2, false);
+        vertexLayout.addElementLayout(2, false);
+        m_vertexArray.addBuffer(m_vertexBuffer, vertexLayout);
+
+        initQuadIndices(m_indexBuffer, m_capacity);
+
+        m_vertexArray.unbind();
+        m_indexBuffer.unbind();
+    }
+
+    void SpriteBatch::begin() noexcept {
+        m_count = 0;
+    }
+
+    bool SpriteBatch::draw(const Texture2D::SubTexture2D& subTexture,
+                           const glm::vec2& position, const glm::vec2& size) noexcept {
+        if (m_count == m_capacity) {
+            return false;
+        }
+        writeQuad(m_vertices.data() + m_count * FLOATS_PER_QUAD, subTexture, position, size);
+        ++m_count;
+        return true;
+    }
+
+    void SpriteBatch::writeQuad(GLfloat* quad, const Texture2D::SubTexture2D& subTexture,
+                                const glm::vec2& position, const glm::vec2& size) noexcept {
+        const glm::vec2 rightTop = position + size;
+        // X                    Y                      U                                    V
+        quad[0]  = position.x; quad[1]  = position.y; quad[2]  = subTexture.leftBottomUV.x; quad[3]  = subTexture.leftBottomUV.y;
+        quad[4]  = position.x; quad[5]  = rightTop.y; quad[6]  = subTexture.leftBottomUV.x; quad[7]  = subTexture.rightTopUV.y;
+        quad[8]  = rightTop.x; quad[9]  = rightTop.y; quad[10] = subTexture.rightTopUV.x;   quad[11] = subTexture.rightTopUV.y;
+        quad[12] = rightTop.x; quad[13] = position.y; quad[14] = subTexture.rightTopUV.x;   quad[15] = subTexture.leftBottomUV.y;
+    }
+
+    void SpriteBatch::initQuadIndices(IndexBuffer& indexBuffer, const unsigned int capacity) {
+        // 1---2
+        // | / |
+        // 0---3
+        std::vector<GLuint> indices;
+        indices.reserve(static_cast<size_t>(capacity) * 6);
+        for (GLuint i = 0; i < capacity; ++i) {
+            const GLuint first = i * 4;
+            indices.insert(indices.end(), { first, first + 1, first + 2,
+                                            first + 2, first + 3, first });
+        }
+        indexBuffer.init(indices.data(), static_cast<unsigned int>(indices.size()));
+    }
+
+    void SpriteBatch::end() const {
+        if (m_count == 0) {
+            return;
+        }
+        m_vertexBuffer.update(m_vertices.data(), m_count * FLOATS_PER_QUAD * sizeof(GLfloat));
+        m_vertexBuffer.unbind();
+
+        m_pShaderProgram->use();
+        // Вершины пакета уже находятся в мировых координатах.
+        m_pShaderProgram->setUniform("modelMat", glm::mat4(1.f));
+        if (m_pTexture->isIndexed()) {
+            m_pShaderProgram->setUniform("paletteRow", static_cast<GLint>(m_paletteRow));
+        }
+
+        glActiveTexture(GL_TEXTURE0);
+        m_pTexture->bind();
+
+        Renderer::draw(m_vertexArray, m_indexBuffer, *m_pShaderProgram, m_count * 6);
+    }
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "VertexBuffer.h"
+#include "IndexBuffer.h"
+#include "VertexArray.h"
+#include "Texture2D.h"
+
+#include <glad/glad.h>
+#include <glm/vec2.hpp>
+
+#include <vector>
+
+namespace RenderEngine {
+
+    class ShaderProgram;
+
+    /**
+     * Класс пакетной отрисовки спрайтов одной текстуры. Все прямоугольники, добавленные между
+     * begin() и end(), выводятся одним вызовом glDrawElements. Буферы выделяются один раз в
+     * конструкторе, поэтому во время игры пакет не выделяет память и не создает объектов OpenGL.
+     * */
+    class SpriteBatch {
+    public:
+        SpriteBatch() = delete;
+        SpriteBatch(const SpriteBatch&) = delete;
+        SpriteBatch& operator=(const SpriteBatch&) = delete;
+
+    public:
+        /**
+         * @param pTexture текстура (атлас), из которой берутся все спрайты пакета.
+         * @param pShaderProgram шейдерная программа спрайтов.
+         * @param capacity максимальное количество прямоугольников в одном пакете.
+         * */
+        SpriteBatch(Texture2D* pTexture,
+                    ShaderProgram* pShaderProgram,
+                    unsigned int capacity);
+
+    public:
+        /**
+         * Метод начинает новый пакет, отбрасывая накопленные прямоугольники.
+         * */
+        void begin() noexcept;
+        /**
+         * Метод добавляет прямоугольник в пакет.
+         * @param subTexture область текстуры.
+         * @param position позиция левого нижнего угла.
+         * @param size размер прямоугольника.
+         * @return false, если пакет заполнен и прямоугольник был отброшен.
+         * */
+        bool draw(const Texture2D::SubTexture2D& subTexture,
+                  const glm::vec2& position, const glm::vec2& size) noexcept;
+        /**
+         * Метод загружает накопленные вершины в буфер и рисует их одним вызовом.
+         * */
+        void end() const;
+        /**
+         * Метод задает строку палитры, с которой рисуется следующий пакет индексированной
+         * текстуры. Для обычных текстур не используется.
+         * */
+        void setPaletteRow(unsigned int paletteRow) noexcept { m_paletteRow = paletteRow; }
+
+        unsigned int capacity() const noexcept { return m_capacity; }
+        unsigned int size() const noexcept { return m_count; }
+
+    public:
+        // На каждый прямоугольник приходится 4 вершины по 4 числа: X, Y, U, V.
+        static constexpr unsigned int FLOATS_PER_QUAD = 16;
+
+        /**
+         * Метод записывает вершины прямоугольника в формате пакета в массив quad из
+         * FLOATS_PER_QUAD элементов.
+         * */
+        static void writeQuad(GLfloat* quad, const Texture2D::SubTexture2D& subTexture,
+                              const glm::vec2& position, const glm::vec2& size) noexcept;
+        /**
+         * Метод создает буфер индексов для capacity прямоугольников из 4 вершин.
+         * */
+        static void initQuadIndices(IndexBuffer& indexBuffer, unsigned int capacity);
+
+    private:
+        Texture2D* m_pTexture;
+        ShaderProgram* m_pShaderProgram;
+        unsigned int m_capacity;
+        unsigned int m_count;
+        unsigned int m_paletteRow;
+        std::vector<GLfloat> m_vertices;
+
+        VertexArray m_vertexArray;
+        VertexBuffer m_vertexBuffer;
+        IndexBuffer m_indexBuffer;
+    };
+}
@@ -0,0 +1,91 @@
+#include "StaticSpriteBatch.h"
+
+#include "SpriteBatch.h"
+#include "ShaderProgram.h"
+#include "Renderer.h"
+
+#include <glm/mat4x4.hpp>
+
+#include <algorithm>
+
+namespace RenderEngine {
+
+    StaticSpriteBatch::StaticSpriteBatch(Texture2D* pTexture,
+                                         ShaderProgram* pShaderProgram,
+                                         const unsigned int capacity) :
+                                         m_pTexture(pTexture),
+                                         m_pShaderProgram(pShaderProgram),
+                                         m_capacity(capacity),
+                                         m_vertices(static_cast<size_t>(capacity) * SpriteBatch::FLOATS_PER_QUAD, 0.f),
+                                         m_fullUpload(true) {
+        m_dirtyRanges.reserve(MAX_DIRTY_RANGES);
+
+        m_vertexBuffer.init(nullptr, m_capacity * SpriteBatch::FLOATS_PER_QUAD * sizeof(GLfloat),
+                            GL_DYNAMIC_DRAW);
+        VertexBufferLayout vertexLayout;
+        vertexLayout.reserveElements(2);
+        vertexLayout.addElementLayout(2, false);
+        vertexLayout.addElementLayout(2, false);
+        m_vertexArray.addBuffer(m_vertexBuffer, vertexLayout);
+
+        SpriteBatch::initQuadIndices(m_indexBuffer, m_capacity);
+
+        m_vertexArray.unbind();
+        m_indexBuffer.unbind();
+    }
+
+    void StaticSpriteBatch::setQuad(const unsigned int slot, const Texture2D::SubTexture2D& subTexture,
+                                    const glm::vec2& position, const glm::vec2& size) noexcept {
+        SpriteBatch::writeQuad(m_vertices.data() + slot * SpriteBatch::FLOATS_PER_QUAD,
+                               subTexture, position, size);
+        markDirty(slot);
+    }
+
+    void StaticSpriteBatch::clearQuad(const unsigned int slot) noexcept {
+        GLfloat* quad = m_vertices.data() + slot * SpriteBatch::FLOATS_PER_QUAD;
+        std::fill(quad, quad + SpriteBatch::FLOATS_PER_QUAD, 0.f);
+        markDirty(slot);
+    }
+
+    void StaticSpriteBatch::render() const {
+        constexpr unsigned int QUAD_BYTES = SpriteBatch::FLOATS_PER_QUAD * sizeof(GLfloat);
+        if (m_fullUpload) {
+            m_vertexBuffer.update(m_vertices.data(), m_capacity * QUAD_BYTES);
+            m_vertexBuffer.unbind();
+        } else if (! m_dirtyRanges.empty()) {
+            for (const auto& range : m_dirtyRanges) {
+                m_vertexBuffer.update(m_vertices.data() + range.first * SpriteBatch::FLOATS_PER_QUAD,
+                                      (range.second - range.first) * QUAD_BYTES,
+                                      range.first * QUAD_BYTES);
+            }
+            m_vertexBuffer.unbind();
+        }
+        m_fullUpload = false;
+        m_dirtyRanges.clear();
+
+        m_pShaderProgram->use();
+        m_pShaderProgram->setUniform("modelMat", glm::mat4(1.f));
+
+        glActiveTexture(GL_TEXTURE0);
+        m_pTexture->bind();
+
+        Renderer::draw(m_vertexArray, m_indexBuffer, *m_pShaderProgram, m_capacity * 6);
+    }
+
+    void StaticSpriteBatch::markDirty(const unsigned int slot) noexcept {
+        if (m_fullUpload) {
+            return;
+        }
+        // Ячейки одной клетки карты идут подряд и сливаются в один диапазон.
+        if (! m_dirtyRanges.empty() && m_dirtyRanges.back().second == slot) {
+            ++m_dirtyRanges.back().second;
+            return;
+        }
+        if (m_dirtyRanges.size() == MAX_DIRTY_RANGES) {
+            m_fullUpload = true;
+            m_dirtyRanges.clear();
+            return;
+        }
+        m_dirtyRanges.emplace_back(slot, slot + 1);
+    }
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "VertexBuffer.h"
+#include "IndexBuffer.h"
+#include "VertexArray.h"
+#include "Texture2D.h"
+
+#include <glad/glad.h>
+#include <glm/vec2.hpp>
+
+#include <utility>
+#include <vector>
+
+namespace RenderEngine {
+
+    class ShaderProgram;
+
+    /**
+     * Класс пакета спрайтов, которые сохраняются между кадрами. Каждый прямоугольник занимает
+     * постоянную ячейку (slot), изменение ячейки загружает в видеопамять только ее вершины.
+     * Подходит для карты: при разрушении стены обновляется одна клетка, а не весь буфер.
+     * */
+    class StaticSpriteBatch {
+    public:
+        StaticSpriteBatch() = delete;
+        StaticSpriteBatch(const StaticSpriteBatch&) = delete;
+        StaticSpriteBatch& operator=(const StaticSpriteBatch&) = delete;
+
+    public:
+        /**
+         * @param pTexture текстура (атлас) всех спрайтов пакета.
+         * @param pShaderProgram шейдерная программа спрайтов.
+         * @param capacity количество ячеек. Изначально все ячейки пусты.
+         * */
+        StaticSpriteBatch(Texture2D* pTexture,
+                          ShaderProgram* pShaderProgram,
+                          unsigned int capacity);
+
+    public:
+        void setQuad(unsigned int slot, const Texture2D::SubTexture2D& subTexture,
+                     const glm::vec2& position, const glm::vec2& size) noexcept;
+        /**
+         * Метод делает ячейку пустой (вырожденный прямоугольник нулевой площади).
+         * */
+        void clearQuad(unsigned int slot) noexcept;
+        /**
+         * Метод загружает измененные ячейки и рисует весь пакет одним вызовом.
+         * */
+        void render() const;
+
+        unsigned int capacity() const noexcept { return m_capacity; }
+
+    private:
+        void markDirty(unsigned int slot) noexcept;
+
+    private:
+        // Если за кадр изменилось больше диапазонов, буфер загружается целиком.
+        static constexpr size_t MAX_DIRTY_RANGES = 64;
+
+        Texture2D* m_pTexture;
+        ShaderProgram* m_pShaderProgram;
+        unsigned int m_capacity;
+        std::vector<GLfloat> m_vertices;
+        // Диапазоны ячеек [first, second), измененные с последней отрисовки.
+        mutable std::vector<std::pair<unsigned int, unsigned int>> m_dirtyRanges;
+        mutable bool m_fullUpload;
+
+        VertexArray m_vertexArray;
+        VertexBuffer m_vertexBuffer;
+        IndexBuffer m_indexBuffer;
+    };
+}
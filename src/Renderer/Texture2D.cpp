@@ -1,37 +1,105 @@
 #include "Texture2D.h"
 
+#include "Palette.h"
+#include "Renderer.h"
+
+#include <algorithm>
+
 namespace RenderEngine {
+    namespace {
+        struct PixelFormat {
+            GLenum internalFormat;
+            GLenum format;
+        };
+
+        PixelFormat getPixelFormat(const unsigned int channels) noexcept {
+            switch (channels) {
+                case 1:
+                    return { GL_R8, GL_RED };
+                case 2:
+                    return { GL_RG8, GL_RG };
+                case 3:
+                    return { GL_RGB8, GL_RGB };
+                default:
+                    return { GL_RGBA8, GL_RGBA };
+            }
+        }
+
+        GLint getMipmapFilter(const GLint filter) noexcept {
+            return filter == GL_NEAREST ? GL_NEAREST_MIPMAP_NEAREST : GL_LINEAR_MIPMAP_LINEAR;
+        }
+    }
+
     Texture2D::Texture2D(const GLint width, const GLint height,
                          const unsigned char* data,
                          const unsigned int channels,
                          const GLint filter, const GLint wrapMode) noexcept :
-                         m_width(width), m_height(height)
-                         {
+                         Texture2D(width, height, data, channels, Options{ filter, wrapMode, false, true }) {
+    }
 
-        switch (channels) {
-            case 4:
-                m_mode = GL_RGBA;
-                break;
-            case 3:
-                m_mode = GL_RGB;
-                break;
-            default:
-                m_mode = GL_RGBA;
-                break;
+    Texture2D::Texture2D(const GLint width, const GLint height,
+                         const unsigned char* data,
+                         const unsigned int channels,
+                         const Options& options) noexcept :
+                         m_width(width), m_height(height),
+                         m_ID(0),
+                         m_channels(channels >= 1 && channels <= 4 ? channels : 4),
+                         m_options(options),
+                         m_levels(1), m_memoryBytes(0),
+                         m_lastBindFrame(0)
+                         {
+        m_mode = static_cast<GLint>(getPixelFormat(m_channels).format);
+        if (m_options.generateMipmaps) {
+            while ((std::max(m_width, m_height) >> m_levels) > 0) {
+                ++m_levels;
+            }
+        }
+        for (GLsizei level = 0; level < m_levels; ++level) {
+            const size_t levelWidth = static_cast<size_t>(std::max(m_width >> level, 1));
+            const size_t levelHeight = static_cast<size_t>(std::max(m_height >> level, 1));
+            m_memoryBytes += levelWidth * levelHeight * m_channels;
         }
+        createStorage(data);
+        ++m_texturesCount;
+    }
+
+    void Texture2D::createStorage(const unsigned char* data) const noexcept {
+        const PixelFormat pixelFormat = getPixelFormat(m_channels);
         glGenTextures(1, &m_ID);
         glActiveTexture(GL_TEXTURE0);
-
         glBindTexture(GL_TEXTURE_2D, m_ID);
-        glTexImage2D(GL_TEXTURE_2D, 0, m_mode, m_width, m_height, 0, m_mode, GL_UNSIGNED_BYTE, data);
 
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrapMode);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrapMode);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
-        glGenerateMipmap(GL_TEXTURE_2D);
+        // Строки RGB и одноканальных картинок не выровнены на 4 байта.
+        const bool unaligned = (static_cast<size_t>(m_width) * m_channels) % 4 != 0;
+        if (unaligned) {
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        }
+        if (m_options.immutableStorage && GLAD_GL_ARB_texture_storage) {
+            glTexStorage2D(GL_TEXTURE_2D, m_levels, pixelFormat.internalFormat, m_width, m_height);
+            if (data) {
+                glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, m_width, m_height, pixelFormat.format, GL_UNSIGNED_BYTE, data);
+            }
+        } else {
+            glTexImage2D(GL_TEXTURE_2D, 0, static_cast<GLint>(pixelFormat.internalFormat), m_width, m_height, 0,
+                         pixelFormat.format, GL_UNSIGNED_BYTE, data);
+        }
+        if (unaligned) {
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        }
+
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, m_options.wrapMode);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, m_options.wrapMode);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER,
+                        m_options.generateMipmaps ? getMipmapFilter(m_options.filter) : m_options.filter);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, m_options.filter);
+        // Без мип-уровней текстура полна только с одним уровнем.
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, m_levels - 1);
+        if (m_options.generateMipmaps && data) {
+            glGenerateMipmap(GL_TEXTURE_2D);
+        }
 
         glBindTexture(GL_TEXTURE_2D, 0);
+        m_totalMemoryBytes += m_memoryBytes;
     }
 
     Texture2D::Texture2D(Texture2D&& texture2D) noexcept {
@@ -40,24 +108,71 @@ namespace RenderEngine {
         m_mode = texture2D.m_mode;
         m_width = texture2D.m_width;
         m_height = texture2D.m_height;
+        m_channels = texture2D.m_channels;
+        m_options = texture2D.m_options;
+        m_levels = texture2D.m_levels;
+        m_memoryBytes = texture2D.m_memoryBytes;
+        m_lastBindFrame = texture2D.m_lastBindFrame;
+        m_subTextures = std::move(texture2D.m_subTextures);
+        m_pPalette = std::move(texture2D.m_pPalette);
+        m_reloader = std::move(texture2D.m_reloader);
+        // Перемещенный объект тоже будет уничтожен.
+        ++m_texturesCount;
     }
 
     Texture2D::~Texture2D() noexcept {
-        glDeleteTextures(1, &m_ID);
+        release();
+        --m_texturesCount;
     }
 
     Texture2D& Texture2D::operator=(Texture2D&& texture2D)  noexcept {
-        glDeleteTextures(1, &m_ID);
+        release();
         m_ID = texture2D.m_ID;
         texture2D.m_ID = 0;
         m_mode = texture2D.m_mode;
         m_width = texture2D.m_width;
         m_height = texture2D.m_height;
+        m_channels = texture2D.m_channels;
+        m_options = texture2D.m_options;
+        m_levels = texture2D.m_levels;
+        m_memoryBytes = texture2D.m_memoryBytes;
+        m_lastBindFrame = texture2D.m_lastBindFrame;
+        m_subTextures = std::move(texture2D.m_subTextures);
+        m_pPalette = std::move(texture2D.m_pPalette);
+        m_reloader = std::move(texture2D.m_reloader);
         return *this;
     }
 
+    void Texture2D::release() noexcept {
+        if (m_ID) {
+            glDeleteTextures(1, &m_ID);
+            m_ID = 0;
+            m_totalMemoryBytes -= m_memoryBytes;
+        }
+    }
+
+    void Texture2D::evict() noexcept {
+        release();
+    }
+
+    void Texture2D::reload(const unsigned char* data) const noexcept {
+        if (m_ID == 0) {
+            createStorage(data);
+        }
+    }
+
     void Texture2D::bind() const noexcept {
+        if (m_ID == 0 && m_reloader) {
+            m_reloader(*this);
+        }
+        m_lastBindFrame = Renderer::getFrameIndex();
         glBindTexture(GL_TEXTURE_2D, m_ID);
+        Renderer::countTextureBind();
+        if (m_pPalette) {
+            glActiveTexture(GL_TEXTURE0 + Palette::TEXTURE_UNIT);
+            m_pPalette->getTexture()->bind();
+            glActiveTexture(GL_TEXTURE0);
+        }
     }
 
     void
@@ -3,10 +3,17 @@
 #include <glad/glad.h>
 #include <glm/vec2.hpp>
 
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
 #include <string>
 #include <map>
 
 namespace RenderEngine {
+
+    class Palette;
+
     /**
     * Класс двумерной текстуры.
     * */
@@ -27,11 +34,28 @@ namespace RenderEngine {
 
             SubTexture2D() : leftBottomUV(0.0f), rightTopUV(1.0f) {}
         };
+        /**
+         * Параметры создания текстуры.
+         * */
+        struct Options {
+            // Текстурный фильтр для уменьшения и увеличения.
+            GLint filter = GL_LINEAR;
+            GLint wrapMode = GL_CLAMP_TO_EDGE;
+            // Построить мип-уровни и читать их при уменьшении. Без этого мип-уровни не создаются:
+            // фильтры GL_NEAREST и GL_LINEAR их никогда не читают.
+            bool generateMipmaps = false;
+            // Неизменяемое хранилище glTexStorage2D, если доступно (GL 4.2 или
+            // GL_ARB_texture_storage), иначе glTexImage2D с тем же размерным форматом.
+            bool immutableStorage = true;
+        };
+
         /**
          * @param height высота
          * @param width ширина
-         * @param data массив с данными текстуры
-         * @param channels канальность цвета (по умолчанию 4)
+         * @param data массив с данными текстуры, строки без выравнивания; nullptr - текстура
+         * без данных (например, для буфера кадра)
+         * @param channels канальность цвета (по умолчанию 4): 1 - GL_R8, 2 - GL_RG8, 3 - GL_RGB8,
+         * 4 - GL_RGBA8
          * @param filter текстурный фильтр (по умолчанию GL_LINEAR)
          * @param wrapMode опция wrapping (по умолчанию GL_CLAMP_TO_EDGE)
          * */
@@ -40,6 +64,10 @@ namespace RenderEngine {
                   unsigned int channels = 4,
                   GLint filter = GL_LINEAR,
                   GLint wrapMode = GL_CLAMP_TO_EDGE) noexcept;
+        Texture2D(GLint width, GLint height,
+                  const unsigned char* data,
+                  unsigned int channels,
+                  const Options& options) noexcept;
         Texture2D(Texture2D&& texture2D) noexcept;
         ~Texture2D() noexcept;
 
@@ -47,22 +75,85 @@ namespace RenderEngine {
         Texture2D& operator=(Texture2D&& texture2D) noexcept;
 
         /**
-         * Метод подключает текстуру к цели GL_TEXTURE_2D.
+         * Метод подключает текстуру к цели GL_TEXTURE_2D. Палитра индексированной текстуры
+         * подключается к блоку Palette::TEXTURE_UNIT, активным остается блок GL_TEXTURE0.
+         * Выгруженная текстура сначала загружается заново функцией setReloader().
          * */
         void bind() const noexcept;
 
+        /**
+         * Функция повторной загрузки выгруженной текстуры: должна вызвать reload() с данными
+         * в исходном формате.
+         * */
+        using Reloader = std::function<void(const Texture2D&)>;
+        void setReloader(Reloader reloader) { m_reloader = std::move(reloader); }
+        /**
+         * Метод освобождает видеопамять текстуры. Размеры, области, палитра и параметры
+         * сохраняются, так что после reload() текстура используется как прежде.
+         * */
+        void evict() noexcept;
+        /**
+         * Метод заново создает хранилище выгруженной текстуры с теми же форматом и
+         * параметрами. Выгрузка не меняет наблюдаемого состояния текстуры, поэтому метод
+         * константный.
+         * @param data данные в формате, переданном в конструктор.
+         * */
+        void reload(const unsigned char* data) const noexcept;
+        bool isResident() const noexcept { return m_ID != 0; }
+        /**
+         * Номер кадра (Renderer::getFrameIndex()), в котором текстура последний раз подключалась.
+         * */
+        uint64_t getLastBindFrame() const noexcept { return m_lastBindFrame; }
+
         void addSubTexture(const std::string& name,
                            const glm::vec2& leftBottomUV, const glm::vec2& rightTopUV);
         const SubTexture2D getSubTexture(const std::string& name) const;
         unsigned int width() const noexcept { return m_width; }
         unsigned int height() const noexcept {return m_height; }
+        unsigned int channels() const noexcept { return m_channels; }
+        GLuint getID() const noexcept { return m_ID; }
+        /**
+         * Объем видеопамяти текстуры в байтах со всеми мип-уровнями (оценка по размерному
+         * формату), когда она загружена.
+         * */
+        size_t memoryBytes() const noexcept { return m_memoryBytes; }
+        bool hasMipmaps() const noexcept { return m_levels > 1; }
+        /**
+         * Метод делает текстуру индексированной: в канале R хранится номер цвета палитры.
+         * Такие текстуры рисуются шейдером спрайтов с палитрой.
+         * */
+        void setPalette(std::shared_ptr<Palette> pPalette) noexcept { m_pPalette = std::move(pPalette); }
+        const std::shared_ptr<Palette>& getPalette() const noexcept { return m_pPalette; }
+        bool isIndexed() const noexcept { return m_pPalette != nullptr; }
+
+        /**
+         * Суммарный объем видеопамяти загруженных текстур и количество существующих текстур.
+         * */
+        static size_t getTotalMemoryBytes() noexcept { return m_totalMemoryBytes; }
+        static unsigned int getTexturesCount() noexcept { return m_texturesCount; }
+
+    private:
+        void createStorage(const unsigned char* data) const noexcept;
+        void release() noexcept;
 
     private:
         GLint m_width;
         GLint m_height;
-        GLuint m_ID;
+        // 0 - текстура выгружена (evict()).
+        mutable GLuint m_ID;
         GLint m_mode;
+        unsigned int m_channels;
+        Options m_options;
+        GLsizei m_levels;
+        size_t m_memoryBytes;
+        mutable uint64_t m_lastBindFrame;
+        Reloader m_reloader;
+
+        // Текстуры создаются и удаляются только в потоке, владеющем контекстом OpenGL.
+        inline static size_t m_totalMemoryBytes = 0;
+        inline static unsigned int m_texturesCount = 0;
 
         std::map<std::string, SubTexture2D> m_subTextures;
+        std::shared_ptr<Palette> m_pPalette;
     };
 }
\ No newline at end of file
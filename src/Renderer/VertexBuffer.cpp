@@ -1,5 +1,7 @@
 #include "VertexBuffer.h"
 
+#include "Renderer.h"
+
 namespace RenderEngine {
     VertexBuffer::VertexBuffer() noexcept : m_id(0) {}
 
@@ -18,15 +20,18 @@ namespace RenderEngine {
         o.m_id = 0;
     }
 
-    void VertexBuffer::init(const void *data, const unsigned int size) noexcept {
+    void VertexBuffer::init(const void *data, const unsigned int size, const GLenum usage) noexcept {
         glGenBuffers(1, &m_id);
         glBindBuffer(GL_ARRAY_BUFFER, m_id);
-        glBufferData(GL_ARRAY_BUFFER, size, data, GL_STATIC_DRAW);
+        glBufferData(GL_ARRAY_BUFFER, size, data, usage);
+        Renderer::countBufferUpload(size);
     }
 
-    void VertexBuffer::update(const void *data, const unsigned int size) const noexcept {
+    void VertexBuffer::update(const void *data, const unsigned int size,
+                              const unsigned int offset) const noexcept {
         glBindBuffer(GL_ARRAY_BUFFER, m_id);
-        glBufferSubData(GL_ARRAY_BUFFER, 0, size, data);
+        glBufferSubData(GL_ARRAY_BUFFER, offset, size, data);
+        Renderer::countBufferUpload(size);
     }
 
     void VertexBuffer::bind() const noexcept {
@@ -13,8 +13,8 @@ namespace RenderEngine {
         VertexBuffer(VertexBuffer&& o) noexcept;
         VertexBuffer& operator=(VertexBuffer&& o) noexcept;
 
-        void init(const void* data, unsigned int size) noexcept;
-        void update(const void* data, unsigned int size) const noexcept;
+        void init(const void* data, unsigned int size, GLenum usage = GL_STATIC_DRAW) noexcept;
+        void update(const void* data, unsigned int size, unsigned int offset = 0) const noexcept;
         void bind() const noexcept;
         void unbind() const noexcept;
 
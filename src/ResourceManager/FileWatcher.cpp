@@ -0,0 +1,76 @@
+#include "FileWatcher.h"
+
+#ifdef __linux__
+    #include <sys/inotify.h>
+    #include <unistd.h>
+#endif
+
+FileWatcher::FileWatcher(std::string basePath) :
+                         m_basePath(std::move(basePath)),
+                         m_handle(-1) {
+#ifdef __linux__
+    m_handle = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+#endif
+}
+
+FileWatcher::~FileWatcher() {
+#ifdef __linux__
+    if (m_handle >= 0) {
+        close(m_handle);
+    }
+#endif
+}
+
+bool FileWatcher::watch(const std::string& relativeDirectory) {
+    if (m_handle < 0) {
+        return false;
+    }
+    if (m_watchedDirectories.count(relativeDirectory)) {
+        return true;
+    }
+#ifdef __linux__
+    const std::string path = relativeDirectory.empty() ? m_basePath : m_basePath + "/" + relativeDirectory;
+    // Файл сохранен целиком: закрыт после записи или переименован поверх старого.
+    const int descriptor = inotify_add_watch(m_handle, path.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+    if (descriptor < 0) {
+        return false;
+    }
+    m_directories[descriptor] = relativeDirectory;
+    m_watchedDirectories.insert(relativeDirectory);
+    return true;
+#else
+    return false;
+#endif
+}
+
+std::vector<std::string> FileWatcher::poll() {
+    std::vector<std::string> changedFiles;
+#ifdef __linux__
+    if (m_handle < 0) {
+        return changedFiles;
+    }
+    std::set<std::string> uniqueFiles;
+    alignas(inotify_event) char buffer[4096];
+    for (;;) {
+        const ssize_t length = read(m_handle, buffer, sizeof(buffer));
+        if (length <= 0) {
+            // EAGAIN: событий больше нет.
+            break;
+        }
+        for (ssize_t offset = 0; offset < length;) {
+            const auto* pEvent = reinterpret_cast<const inotify_event*>(buffer + offset);
+            offset += static_cast<ssize_t>(sizeof(inotify_event) + pEvent->len);
+            const auto it = m_directories.find(pEvent->wd);
+            if (it == m_directories.end() || pEvent->len == 0 || (pEvent->mask & IN_ISDIR)) {
+                continue;
+            }
+            const std::string file = it->second.empty() ? std::string(pEvent->name)
+                                                        : it->second + "/" + pEvent->name;
+            if (uniqueFiles.insert(file).second) {
+                changedFiles.push_back(file);
+            }
+        }
+    }
+#endif
+    return changedFiles;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+/**
+ * Наблюдение за изменением файлов в каталогах (без вложенных). На Linux используется inotify,
+ * на остальных системах наблюдение недоступно и poll() ничего не возвращает.
+ * */
+class FileWatcher {
+public:
+    FileWatcher() = delete;
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+public:
+    /**
+     * @param basePath каталог, от которого отсчитываются пути каталогов и файлов.
+     * */
+    explicit FileWatcher(std::string basePath);
+    ~FileWatcher();
+
+    bool isAvailable() const noexcept { return m_handle >= 0; }
+    /**
+     * Метод начинает наблюдение за каталогом; повторный вызов для того же каталога ничего не делает.
+     * @param relativeDirectory путь к каталогу относительно basePath.
+     * @return false, если за каталогом нельзя наблюдать.
+     * */
+    bool watch(const std::string& relativeDirectory);
+    /**
+     * Метод возвращает файлы, записанные или замененные (переименованием, как сохраняют многие
+     * редакторы) с прошлого вызова, не дожидаясь событий. Каждый файл возвращается один раз.
+     * @return пути относительно basePath в виде "каталог/файл".
+     * */
+    std::vector<std::string> poll();
+
+private:
+    std::string m_basePath;
+    int m_handle;
+    // Дескриптор наблюдения inotify - каталог относительно basePath.
+    std::map<int, std::string> m_directories;
+    std::set<std::string> m_watchedDirectories;
+};
@@ -1,10 +1,18 @@
 #include "ResourceManager.h"
+#include "FileWatcher.h"
 #include "../Renderer/ShaderProgram.h"
 #include "../Renderer/Texture2D.h"
 #include "../Renderer/Sprite.h"
 #include "../Renderer/AnimatedSprite.h"
+#include "../Renderer/Renderer.h"
 #include "../Exception/Exception.h"
+#include "../Utils/Hash.h"
+#include "../Profiler/Profiler.h"
+#include "../Profiler/AllocationCounter.h"
 
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
 #include <sstream>
 #include <fstream>
 #include <iostream>
@@ -16,29 +24,315 @@
 #include <rapidjson/document.h>
 #include <rapidjson/error/en.h>
 
+Utils::HandlePool<RenderEngine::ShaderProgram>& ResourceManager::m_shaderProgramPool =
+        RenderEngine::getShaderProgramPool();
+Utils::HandlePool<RenderEngine::Texture2D>& ResourceManager::m_texturePool = RenderEngine::getTexturePool();
+Utils::HandlePool<RenderEngine::Sprite> ResourceManager::m_spritePool;
+Utils::HandlePool<RenderEngine::AnimatedSprite> ResourceManager::m_animatedSpritePool;
 ResourceManager::ShaderProgramMap ResourceManager::m_shaderPrograms;
+ResourceManager::PaletteMap ResourceManager::m_palettes;
 ResourceManager::TextureMap ResourceManager::m_textures;
+ResourceManager::TextureBudget ResourceManager::m_textureBudget;
+std::vector<RenderEngine::Texture2D*> ResourceManager::m_evictionCandidates;
+ResourceManager::Stats ResourceManager::m_stats;
+std::map<std::string, ResourceManager::ShaderSource> ResourceManager::m_shaderSources;
+std::string ResourceManager::m_JSONPath;
+std::vector<std::string> ResourceManager::m_JSONFiles;
+std::unique_ptr<FileWatcher> ResourceManager::m_pFileWatcher;
+bool ResourceManager::m_replaceExisting = false;
 ResourceManager::SpriteMap ResourceManager::m_sprites;
 ResourceManager::AnimatedSpriteMap ResourceManager::m_animatedSprite;
+std::vector<std::vector<std::string>> ResourceManager::m_levels;
+std::vector<std::vector<std::string>> ResourceManager::m_levelsPrefetch;
+bool ResourceManager::m_lazyLoading = false;
+uint64_t ResourceManager::m_JSONResourcesHash = 0;
 // Путь к ресурсам
 std::string ResourceManager::m_resourcePath;
 
+namespace {
+    // Пиксельная графика выводится с целым масштабом, поэтому мип-уровни не нужны.
+    const RenderEngine::Texture2D::Options PIXEL_ART_TEXTURE_OPTIONS { GL_NEAREST, GL_CLAMP_TO_EDGE, false, true };
+
+    /**
+     * Функция приводит относительный путь ресурса к виду, в котором его сообщает FileWatcher.
+     * */
+    std::string normalizePath(const std::string& path) {
+        return std::filesystem::path(path).lexically_normal().generic_string();
+    }
+
+    struct DecodedImage {
+        int width = 0;
+        int height = 0;
+        unsigned int channels = 0;
+        std::vector<unsigned char> pixels;
+        // Не пустая, если картинку не удалось прочитать.
+        std::string error;
+    };
+
+    /**
+     * Функция читает PNG и, если задана палитра, переводит его в индексы палитры.
+     * */
+    DecodedImage decodeImage(const std::string& path, const RenderEngine::Palette* pPalette) {
+        DecodedImage image;
+        int channels = 0;
+        // Чтобы картинки читались снизу вверх, а не сверху вних как обычно
+        stbi_set_flip_vertically_on_load(true);
+        // Картинки с палитрой PNG раскрываются в RGBA, чтобы сравнивать цвета с палитрой ресурсов.
+        unsigned char* pixels = stbi_load(path.c_str(), &image.width, &image.height, &channels, pPalette ? 4 : 0);
+        if (! pixels) {
+            image.error = "Can't load image";
+            return image;
+        }
+        const size_t pixelsCount = static_cast<size_t>(image.width) * image.height;
+        if (pPalette) {
+            try {
+                image.pixels = pPalette->indexImage(pixels, pixelsCount, 4);
+                image.channels = 1;
+            } catch (const Exception::Exception& ex) {
+                image.error = std::string("Can't index image with the palette (") + ex.what() + ")";
+            }
+        } else {
+            image.channels = static_cast<unsigned int>(channels);
+            image.pixels.assign(pixels, pixels + pixelsCount * image.channels);
+        }
+        stbi_image_free(pixels);
+        return image;
+    }
+
+    /**
+     * Метод разбирает цвет вида "#rrggbb" или "#rrggbbaa".
+     * @return false, если строка не является цветом.
+     * */
+    bool parseColour(const std::string& text, glm::u8vec4& colour) noexcept {
+        if ((text.size() != 7 && text.size() != 9) || text[0] != '#') {
+            return false;
+        }
+        unsigned int components[4] = { 0, 0, 0, 255 };
+        for (size_t i = 0; i * 2 + 1 < text.size(); ++i) {
+            const std::string component = text.substr(1 + i * 2, 2);
+            char* pEnd = nullptr;
+            components[i] = static_cast<unsigned int>(std::strtoul(component.c_str(), &pEnd, 16));
+            if (*pEnd != '\0') {
+                return false;
+            }
+        }
+        colour = glm::u8vec4(components[0], components[1], components[2], components[3]);
+        return true;
+    }
+}
+
+struct ResourceManager::TextureSource {
+    std::string path;
+    std::shared_ptr<RenderEngine::Palette> pPalette;
+};
+std::map<std::string, ResourceManager::TextureSource> ResourceManager::m_textureSources;
+
+/**
+ * Разобранный файл ресурсов JSON: документ и его описания ресурсов по именам. Описания
+ * загружаются сразу или, в ленивом режиме, при первом обращении к ресурсу.
+ * */
+struct ResourceManager::Manifest {
+    rapidjson::Document document;
+    std::map<std::string, const rapidjson::Value*> shaders;
+    std::map<std::string, const rapidjson::Value*> palettes;
+    std::map<std::string, const rapidjson::Value*> textureAtlases;
+    std::map<std::string, const rapidjson::Value*> animatedSprites;
+
+    void index(const char* section, std::map<std::string, const rapidjson::Value*>& entries) const {
+        const auto it = document.FindMember(section);
+        if (it == document.MemberEnd()) {
+            return;
+        }
+        for (const auto& entry : it->value.GetArray()) {
+            entries.emplace(entry["name"].GetString(), &entry);
+        }
+    }
+
+    /**
+     * Метод загружает описанный ресурс; ресурсы, от которых он зависит, загружаются через get*.
+     * @return false, если ресурса нет в файле или он не загрузился. В std::cerr будет выведено
+     * сообщение.
+     * */
+    static bool load(const std::map<std::string, const rapidjson::Value*>& entries, const std::string& name,
+                     bool (*pLoadEntry)(const rapidjson::Value&)) noexcept {
+        const auto it = entries.find(name);
+        if (it == entries.end()) {
+            return false;
+        }
+        // Отложенная загрузка происходит внутри геттеров, вызванных любой подсистемой.
+        ALLOCATION_TAG(ResourceManager);
+        try {
+            return pLoadEntry(*it->second);
+        } catch (const Exception::Exception& ex) {
+            std::cerr << "Can't load " << name << ": " << ex.what() << std::endl;
+            return false;
+        }
+    }
+
+    static bool loadShader(const rapidjson::Value& entry) {
+        const std::string name = entry["name"].GetString();
+        const std::string filePath_v = entry["filePath_v"].GetString();
+        const std::string filePath_f = entry["filePath_f"].GetString();
+        auto it = m_shaderSources.find(name);
+        if (m_replaceExisting && it != m_shaderSources.end() &&
+            it->second.vertexPath == filePath_v && it->second.fragmentPath == filePath_f) {
+            // Изменения самих файлов шейдеров перезагружаются отдельно.
+            return true;
+        }
+        loadShaders(name, filePath_v, filePath_f);
+        return true;
+    }
+
+    static bool loadPalette(const rapidjson::Value& entry) {
+        const std::string name = entry["name"].GetString();
+        std::vector<RenderEngine::Palette::Row> rows;
+        for (const auto& currRow : entry["rows"].GetArray()) {
+            RenderEngine::Palette::Row row;
+            row.name = currRow["name"].GetString();
+            for (const auto& currColour : currRow["colours"].GetArray()) {
+                glm::u8vec4 colour;
+                if (! parseColour(currColour.GetString(), colour)) {
+                    std::cerr << "Bad colour " << currColour.GetString() << " in the palette " << name << std::endl;
+                    return false;
+                }
+                row.colours.push_back(colour);
+            }
+            rows.emplace_back(std::move(row));
+        }
+        ResourceManager::loadPalette(name, std::move(rows));
+        return true;
+    }
+
+    static bool loadTextureAtlas(const rapidjson::Value& entry) {
+        const std::string name = entry["name"].GetString();
+        const auto paletteIt = entry.FindMember("palette");
+        const std::string palette = paletteIt != entry.MemberEnd() ? paletteIt->value.GetString() : "";
+
+        // Атлас упаковщика: путь к картинке и области спрайтов лежат в отдельном файле.
+        const auto atlasIt = entry.FindMember("atlas");
+        if (atlasIt != entry.MemberEnd()) {
+            const std::string atlasPath = atlasIt->value.GetString();
+            if (std::find(m_JSONFiles.begin(), m_JSONFiles.end(), normalizePath(atlasPath)) == m_JSONFiles.end()) {
+                m_JSONFiles.push_back(normalizePath(atlasPath));
+            }
+            watchFile(atlasPath);
+            const std::string atlasString = getFileString(atlasPath);
+            rapidjson::Document atlasDocument;
+            if (atlasString.empty() || atlasDocument.Parse(atlasString.c_str()).HasParseError()) {
+                std::cerr << "Can't read the texture atlas description: " << atlasPath << std::endl;
+                return false;
+            }
+            std::vector<SubTextureRect> subTextures;
+            for (const auto& currSubTexture : atlasDocument["subTextures"].GetArray()) {
+                subTextures.push_back({ currSubTexture["name"].GetString(),
+                                        currSubTexture["x"].GetUint(), currSubTexture["y"].GetUint(),
+                                        currSubTexture["width"].GetUint(), currSubTexture["height"].GetUint() });
+            }
+            return ResourceManager::loadTextureAtlas(name, atlasDocument["filePath"].GetString(),
+                                                     subTextures, palette) != nullptr;
+        }
+
+        const std::string filePath = entry["filePath"].GetString();
+        const unsigned int subTextureWidth = entry["subTextureWidth"].GetUint();
+        const unsigned int subTextureHeight = entry["subTextureHeight"].GetUint();
+
+        const auto subTexturesArray = entry["subTextures"].GetArray();
+        std::vector<std::string> subTextures;
+        subTextures.reserve(subTexturesArray.Size());
+        for (const auto& currSubTexture : subTexturesArray) {
+            subTextures.emplace_back(currSubTexture.GetString());
+        }
+        return ResourceManager::loadTextureAtlas(name, filePath, subTextures,
+                                                 subTextureWidth, subTextureHeight, palette) != nullptr;
+    }
+
+    static bool loadAnimatedSprite(const rapidjson::Value& entry) {
+        const std::string name = entry["name"].GetString();
+        const std::string textureAtlas = entry["textureAtlas"].GetString();
+        const std::string shader = entry["shader"].GetString();
+        const unsigned int initialWidth = entry["initialWidth"].GetUint();
+        const unsigned int initialHeight = entry["initialHeight"].GetUint();
+        const std::string initialSubTexture = entry["initialSubTexture"].GetString();
+
+        auto pAnimatedSprite = ResourceManager::loadAnimatedSprite(name, textureAtlas, shader,
+                                                                   initialWidth, initialHeight,
+                                                                   initialSubTexture);
+        if (! pAnimatedSprite) {
+            return false;
+        }
+
+        const auto statesArray = entry["states"].GetArray();
+        for (const auto& currState : statesArray) {
+            const std::string stateName = currState["stateName"].GetString();
+            std::vector<std::pair<std::string, uint64_t>> frames;
+            const auto framesArray = currState["frames"].GetArray();
+            frames.reserve(framesArray.Size());
+            for (const auto& currFrame : framesArray) {
+                const std::string subTexture = currFrame["subTexture"].GetString();
+                const uint64_t duration = currFrame["duration"].GetUint64();
+                frames.emplace_back(subTexture, duration);
+            }
+            pAnimatedSprite->insertState(stateName, std::move(frames));
+        }
+        return true;
+    }
+
+    /**
+     * Метод загружает описания раздела: все или, если loadedOnly, только уже загруженные
+     * (горячая перезагрузка в ленивом режиме).
+     * */
+    template <class LoadedMap>
+    static bool loadAll(const std::map<std::string, const rapidjson::Value*>& entries,
+                        bool (*pLoadEntry)(const rapidjson::Value&),
+                        const LoadedMap& loaded, const bool loadedOnly) noexcept {
+        bool result = true;
+        for (const auto& entry : entries) {
+            if (loadedOnly && loaded.find(entry.first) == loaded.end()) {
+                continue;
+            }
+            result = load(entries, entry.first, pLoadEntry) && result;
+        }
+        return result;
+    }
+};
+std::unique_ptr<ResourceManager::Manifest> ResourceManager::m_pManifest;
+
  void ResourceManager::setExecutablePath(const std::string& executablePath) noexcept {
     std::size_t found = executablePath.find_last_of("/\\");
     m_resourcePath = executablePath.substr(0, found);
 }
 
+void ResourceManager::setResourcePath(const std::string& resourcePath) noexcept {
+    m_resourcePath = resourcePath;
+}
+
 void ResourceManager::unloadAllResources() {
+     m_pFileWatcher.reset();
+     m_shaderSources.clear();
+     m_JSONFiles.clear();
+     m_JSONPath.clear();
      m_shaderPrograms.clear();
+     m_textureSources.clear();
+     m_evictionCandidates.clear();
      m_textures.clear();
+     m_palettes.clear();
      m_sprites.clear();
      m_animatedSprite.clear();
+     m_animatedSpritePool.clear();
+     m_spritePool.clear();
+     m_texturePool.clear();
+     m_shaderProgramPool.clear();
+     m_levels.clear();
+     m_levelsPrefetch.clear();
+     m_pManifest.reset();
      m_resourcePath.clear();
  }
 
-std::shared_ptr<RenderEngine::ShaderProgram> ResourceManager::loadShaders(const std::string& shaderName,
-                                                                          const std::string& vertexPath,
-                                                                          const std::string& fragmentPath){
+RenderEngine::ShaderProgram* ResourceManager::loadShaders(const std::string& shaderName,
+                                                         const std::string& vertexPath,
+                                                         const std::string& fragmentPath){
+    PROFILE_SCOPE("ResourceManager::loadShaders");
+    ALLOCATION_TAG(ResourceManager);
     std::string vertexString = getFileString(vertexPath);
     if (vertexString.empty()) {
         throw Exception::Exception("No vertex shader!");
@@ -48,10 +342,17 @@ std::shared_ptr<RenderEngine::ShaderProgram> ResourceManager::loadShaders(const
         throw Exception::Exception("No fragment shader!");
     }
     try {
-        auto temp = m_shaderPrograms.emplace(shaderName,
-                                             std::make_shared<RenderEngine::ShaderProgram>(vertexString,
-                                                                                           fragmentString));
-        return temp.first->second;
+        auto it = m_shaderPrograms.find(shaderName);
+        if (it != m_shaderPrograms.end() && m_replaceExisting) {
+            m_shaderProgramPool.get(it->second)->reload(vertexString, fragmentString);
+        } else if (it == m_shaderPrograms.end()) {
+            it = m_shaderPrograms.emplace(shaderName,
+                                          m_shaderProgramPool.create(vertexString, fragmentString)).first;
+        }
+        m_shaderSources[shaderName] = { vertexPath, fragmentPath };
+        watchFile(vertexPath);
+        watchFile(fragmentPath);
+        return m_shaderProgramPool.get(it->second);
     } catch (Exception::Exception& ex) {
         std::string msg = "\nCan't load shader program:\nVertex: ";
         msg += vertexPath + "\nFragment: ";
@@ -61,98 +362,359 @@ std::shared_ptr<RenderEngine::ShaderProgram> ResourceManager::loadShaders(const
     }
 }
 
-std::shared_ptr<RenderEngine::ShaderProgram>
-ResourceManager::getShaderProgram(const std::string& shaderName) noexcept {
+RenderEngine::ShaderProgram* ResourceManager::getShaderProgram(const std::string& shaderName) noexcept {
+    return getShaderProgram(getShaderProgramHandle(shaderName));
+}
+
+ResourceManager::ShaderProgramHandle ResourceManager::getShaderProgramHandle(const std::string& shaderName) noexcept {
     auto it = m_shaderPrograms.find(shaderName);
     if (it != m_shaderPrograms.end()) {
         return it->second;
     }
+    if (m_pManifest && Manifest::load(m_pManifest->shaders, shaderName, Manifest::loadShader)) {
+        return m_shaderPrograms.at(shaderName);
+    }
     std::cerr << "Can't find the shader program: " << shaderName << std::endl;
-    return nullptr;
+    return {};
+}
+
+RenderEngine::ShaderProgram* ResourceManager::getShaderProgram(const ShaderProgramHandle handle) noexcept {
+    return m_shaderProgramPool.get(handle);
+}
+
+std::shared_ptr<RenderEngine::Palette>
+ResourceManager::loadPalette(const std::string& paletteName, std::vector<RenderEngine::Palette::Row> rows) {
+    auto it = m_palettes.find(paletteName);
+    if (it != m_palettes.end() && m_replaceExisting) {
+        // Индексированные текстуры хранят указатель на палитру и видят новые цвета.
+        *it->second = RenderEngine::Palette(std::move(rows));
+        return it->second;
+    }
+    auto temp = m_palettes.emplace(paletteName, std::make_shared<RenderEngine::Palette>(std::move(rows)));
+    return temp.first->second;
 }
 
-std::shared_ptr<RenderEngine::Texture2D> ResourceManager::loadTexture(const std::string& textureName,
-                                                                      const std::string& texturePath) {
-    int channels = 0;
-    int width = 0;
-    int height = 0;
+std::shared_ptr<RenderEngine::Palette> ResourceManager::getPalette(const std::string& paletteName) noexcept {
+    auto it = m_palettes.find(paletteName);
+    if (it != m_palettes.end()) {
+        return it->second;
+    }
+    if (m_pManifest && Manifest::load(m_pManifest->palettes, paletteName, Manifest::loadPalette)) {
+        return m_palettes.at(paletteName);
+    }
+    std::cerr << "Can't find the palette: " << paletteName << std::endl;
+    return nullptr;
+}
 
-    // Чтобы картинки читались снизу вверх, а не сверху вних как обычно
-    stbi_set_flip_vertically_on_load(true);
+RenderEngine::Texture2D* ResourceManager::loadTexture(const std::string& textureName,
+                                                      const std::string& texturePath,
+                                                      const std::string& paletteName) {
+    PROFILE_SCOPE("ResourceManager::loadTexture");
+    ALLOCATION_TAG(ResourceManager);
+    std::shared_ptr<RenderEngine::Palette> pPalette;
+    if (! paletteName.empty()) {
+        pPalette = getPalette(paletteName);
+        if (! pPalette) {
+            return nullptr;
+        }
+    }
 
-    unsigned char* pixels = stbi_load(std::string(m_resourcePath + "/" + texturePath).c_str(),
-                                      &width, &height, &channels, 0);
-    if (! pixels) {
-        std::cerr << "Can't load image: " << texturePath << std::endl;
+    const DecodedImage image = decodeImage(m_resourcePath + "/" + texturePath, pPalette.get());
+    if (! image.error.empty()) {
+        std::cerr << image.error << ": " << texturePath << std::endl;
         return nullptr;
     }
 
-    auto temp = m_textures.emplace(textureName,
-                                   std::make_shared<RenderEngine::Texture2D>(width, height,
-                                                                             pixels,
-                                                                             channels,
-                                                                             GL_NEAREST,
-                                                                             GL_CLAMP_TO_EDGE));
-    auto newTexture = temp.first->second;
-    stbi_image_free(pixels);
-    return newTexture;
+    RenderEngine::Texture2D newTexture(image.width, image.height, image.pixels.data(),
+                                       image.channels, PIXEL_ART_TEXTURE_OPTIONS);
+    auto it = m_textures.find(textureName);
+    if (it == m_textures.end()) {
+        it = m_textures.emplace(textureName, m_texturePool.create(std::move(newTexture))).first;
+    } else if (m_replaceExisting) {
+        // Области атласа удаляются вместе со старым содержимым, загрузчик атласа добавит их заново.
+        *m_texturePool.get(it->second) = std::move(newTexture);
+    } else {
+        return m_texturePool.get(it->second);
+    }
+    RenderEngine::Texture2D* pTexture = m_texturePool.get(it->second);
+    pTexture->setPalette(pPalette);
+    TextureSource& source = m_textureSources[textureName];
+    source.path = texturePath;
+    m_evictionCandidates.reserve(m_textureSources.size());
+    source.pPalette = std::move(pPalette);
+    pTexture->setReloader([textureName](const RenderEngine::Texture2D& texture) {
+        reloadTexture(textureName, texture);
+    });
+    watchFile(texturePath);
+    return pTexture;
+}
+
+void ResourceManager::reloadTexture(const std::string& textureName, const RenderEngine::Texture2D& texture) {
+    PROFILE_SCOPE("ResourceManager::reloadTexture");
+    ALLOCATION_TAG(ResourceManager);
+    auto it = m_textureSources.find(textureName);
+    if (it == m_textureSources.end()) {
+        return;
+    }
+    TextureSource& source = it->second;
+    const DecodedImage image = decodeImage(m_resourcePath + "/" + source.path, source.pPalette.get());
+    if (! image.error.empty()) {
+        std::cerr << image.error << ": " << source.path << std::endl;
+        return;
+    }
+    texture.reload(image.pixels.data());
+    ++m_stats.misses;
+}
+
+void ResourceManager::updateTextures() {
+    PROFILE_SCOPE("ResourceManager::updateTextures");
+    ALLOCATION_TAG(ResourceManager);
+    const uint64_t frame = RenderEngine::Renderer::getFrameIndex();
+    const bool budgetSet = m_textureBudget.maxBytes != 0;
+    size_t residentBytes = 0;
+    // Буфер переиспользуется между кадрами, чтобы не обращаться к куче каждый кадр.
+    m_evictionCandidates.clear();
+    for (auto& [name, source] : m_textureSources) {
+        auto textureIt = m_textures.find(name);
+        if (textureIt == m_textures.end()) {
+            continue;
+        }
+        RenderEngine::Texture2D& texture = *m_texturePool.get(textureIt->second);
+        if (! texture.isResident()) {
+            continue;
+        }
+        if (texture.getLastBindFrame() == frame) {
+            ++m_stats.hits;
+        }
+        residentBytes += texture.memoryBytes();
+        if (budgetSet && frame - texture.getLastBindFrame() >= m_textureBudget.minIdleFrames) {
+            m_evictionCandidates.push_back(&texture);
+        }
+    }
+    if (! budgetSet || residentBytes <= m_textureBudget.maxBytes) {
+        return;
+    }
+    // Первыми выгружаются текстуры, которые дольше всех не подключались.
+    std::sort(m_evictionCandidates.begin(), m_evictionCandidates.end(),
+              [](const RenderEngine::Texture2D* pA, const RenderEngine::Texture2D* pB) {
+                  return pA->getLastBindFrame() < pB->getLastBindFrame();
+              });
+    for (RenderEngine::Texture2D* pTexture : m_evictionCandidates) {
+        if (residentBytes <= m_textureBudget.maxBytes) {
+            break;
+        }
+        residentBytes -= pTexture->memoryBytes();
+        pTexture->evict();
+        ++m_stats.evictions;
+    }
+}
+
+ResourceManager::Stats ResourceManager::getStats() noexcept {
+    Stats stats = m_stats;
+    for (const auto& [name, source] : m_textureSources) {
+        auto textureIt = m_textures.find(name);
+        if (textureIt == m_textures.end()) {
+            continue;
+        }
+        const RenderEngine::Texture2D& texture = *m_texturePool.get(textureIt->second);
+        ++stats.textures;
+        stats.textureBytes += texture.memoryBytes();
+        if (texture.isResident()) {
+            ++stats.residentTextures;
+            stats.residentTextureBytes += texture.memoryBytes();
+        }
+    }
+    stats.palettes = m_palettes.size();
+    for (const auto& palette : m_palettes) {
+        stats.paletteBytes += palette.second->getTexture()->memoryBytes();
+    }
+    stats.shaderPrograms = m_shaderPrograms.size();
+    stats.sprites = m_sprites.size();
+    stats.animatedSprites = m_animatedSprite.size();
+    return stats;
+}
+
+bool ResourceManager::enableHotReload() {
+    m_pFileWatcher = std::make_unique<FileWatcher>(m_resourcePath);
+    if (! m_pFileWatcher->isAvailable()) {
+        m_pFileWatcher.reset();
+        return false;
+    }
+    for (const std::string& file : m_JSONFiles) {
+        watchFile(file);
+    }
+    for (const auto& [name, source] : m_shaderSources) {
+        watchFile(source.vertexPath);
+        watchFile(source.fragmentPath);
+    }
+    for (const auto& [name, source] : m_textureSources) {
+        watchFile(source.path);
+    }
+    return true;
+}
+
+void ResourceManager::watchFile(const std::string& relativeFilePath) {
+    if (! m_pFileWatcher) {
+        return;
+    }
+    const std::string directory = std::filesystem::path(normalizePath(relativeFilePath)).parent_path().generic_string();
+    if (! m_pFileWatcher->watch(directory)) {
+        std::cerr << "Can't watch the directory: " << directory << std::endl;
+    }
+}
+
+bool ResourceManager::pollHotReload() {
+    if (! m_pFileWatcher) {
+        return false;
+    }
+    const std::vector<std::string> changedFiles = m_pFileWatcher->poll();
+    if (changedFiles.empty()) {
+        return false;
+    }
+    PROFILE_SCOPE("ResourceManager::pollHotReload");
+    ALLOCATION_TAG(ResourceManager);
+    bool reloadJSON = false;
+    for (const std::string& file : changedFiles) {
+        if (std::find(m_JSONFiles.begin(), m_JSONFiles.end(), file) != m_JSONFiles.end()) {
+            reloadJSON = true;
+            continue;
+        }
+        for (const auto& [name, source] : m_shaderSources) {
+            if (normalizePath(source.vertexPath) != file && normalizePath(source.fragmentPath) != file) {
+                continue;
+            }
+            const std::string vertexString = getFileString(source.vertexPath);
+            const std::string fragmentString = getFileString(source.fragmentPath);
+            if (vertexString.empty() || fragmentString.empty()) {
+                continue;
+            }
+            try {
+                m_shaderProgramPool.get(m_shaderPrograms.at(name))->reload(vertexString, fragmentString);
+                std::cout << "Reloaded the shader program: " << name << std::endl;
+            } catch (const Exception::Exception& ex) {
+                std::cerr << "Can't reload the shader program " << name << ", keeping the previous one:\n"
+                          << ex.what() << std::endl;
+            }
+        }
+        for (const auto& [name, source] : m_textureSources) {
+            if (normalizePath(source.path) == file && ! reloadTextureFile(name)) {
+                reloadJSON = true;
+            }
+        }
+    }
+    if (! reloadJSON || m_JSONPath.empty()) {
+        return false;
+    }
+    m_replaceExisting = true;
+    const bool loaded = loadJSONResources(m_JSONPath);
+    m_replaceExisting = false;
+    if (loaded) {
+        std::cout << "Reloaded the resources: " << m_JSONPath << std::endl;
+    } else {
+        std::cerr << "Can't reload the resources, the rest are kept: " << m_JSONPath << std::endl;
+    }
+    // Даже неудачная загрузка могла заменить часть атласов.
+    m_spritePool.forEach([](RenderEngine::Sprite& sprite) { sprite.resolveSubTexture(); });
+    m_animatedSpritePool.forEach([](RenderEngine::AnimatedSprite& sprite) { sprite.resolveSubTexture(); });
+    return true;
+}
+
+bool ResourceManager::reloadTextureFile(const std::string& textureName) {
+    const TextureSource& source = m_textureSources.at(textureName);
+    RenderEngine::Texture2D& texture = *m_texturePool.get(m_textures.at(textureName));
+    const DecodedImage image = decodeImage(m_resourcePath + "/" + source.path, source.pPalette.get());
+    if (! image.error.empty()) {
+        std::cerr << image.error << ", keeping the previous texture: " << source.path << std::endl;
+        return true;
+    }
+    if (static_cast<unsigned int>(image.width) != texture.width() ||
+        static_cast<unsigned int>(image.height) != texture.height() || image.channels != texture.channels()) {
+        return false;
+    }
+    texture.evict();
+    texture.reload(image.pixels.data());
+    std::cout << "Reloaded the texture: " << textureName << std::endl;
+    return true;
+}
+
+RenderEngine::Texture2D* ResourceManager::getTexture(const std::string& textureName) noexcept {
+    return getTexture(getTextureHandle(textureName));
 }
 
-std::shared_ptr<RenderEngine::Texture2D>
-ResourceManager::getTexture(const std::string& textureName) noexcept {
+ResourceManager::TextureHandle ResourceManager::getTextureHandle(const std::string& textureName) noexcept {
     auto it = m_textures.find(textureName);
     if (it != m_textures.end()) {
         return it->second;
     }
+    if (m_pManifest && Manifest::load(m_pManifest->textureAtlases, textureName, Manifest::loadTextureAtlas)) {
+        return m_textures.at(textureName);
+    }
     std::cerr << "Can't find the texture: " << textureName << std::endl;
-    return nullptr;
+    return {};
+}
+
+RenderEngine::Texture2D* ResourceManager::getTexture(const TextureHandle handle) noexcept {
+    return m_texturePool.get(handle);
 }
 
-std::shared_ptr<RenderEngine::Sprite>
+RenderEngine::Sprite*
 ResourceManager::loadSprite(const std::string& spriteName,
                             const std::string& textureName, const std::string& shaderName,
                             const unsigned int spriteWidth, const unsigned int spriteHeight,
                             const std::string& subTextureName) {
-    auto pTexture = getTexture(textureName);
-    if (! pTexture) {
+    const TextureHandle texture = getTextureHandle(textureName);
+    if (! texture) {
         throw Exception::Exception("Can't find the texture: " + textureName +
                                    " for the sprite: " + spriteName);
     }
 
-    auto pShaderProgram = getShaderProgram(shaderName);
-    if (! pShaderProgram) {
+    const ShaderProgramHandle shaderProgram = getShaderProgramHandle(shaderName);
+    if (! shaderProgram) {
         throw Exception::Exception("Can't find the shader program: " + shaderName +
                                    " for the sprite: " + spriteName);
     }
 
-    auto tmp = m_sprites.emplace(spriteName,
-                                 std::make_shared<RenderEngine::Sprite>(pTexture,
-                                                                        subTextureName,
-                                                                        pShaderProgram,
-                                                                        glm::vec2(0, 0),
-                                                                        glm::vec2(spriteWidth, spriteHeight),
-                                                                        0));
-    auto newSprite = tmp.first->second;
-    return newSprite;
+    auto it = m_sprites.find(spriteName);
+    if (it == m_sprites.end()) {
+        it = m_sprites.emplace(spriteName,
+                               m_spritePool.create(texture,
+                                                   subTextureName,
+                                                   shaderProgram,
+                                                   glm::vec2(0, 0),
+                                                   glm::vec2(spriteWidth, spriteHeight),
+                                                   0)).first;
+    }
+    return m_spritePool.get(it->second);
+}
+
+RenderEngine::Sprite* ResourceManager::getSprite(const std::string& spriteName) noexcept {
+    return getSprite(getSpriteHandle(spriteName));
 }
 
-std::shared_ptr<RenderEngine::Sprite>
-ResourceManager::getSprite(const std::string& spriteName) noexcept {
+ResourceManager::SpriteHandle ResourceManager::getSpriteHandle(const std::string& spriteName) noexcept {
     auto it = m_sprites.find(spriteName);
     if (it != m_sprites.end()) {
         return it->second;
     }
     std::cerr << "Can't find the sprite: " << spriteName << std::endl;
-    return nullptr;
+    return {};
+}
+
+RenderEngine::Sprite* ResourceManager::getSprite(const SpriteHandle handle) noexcept {
+    return m_spritePool.get(handle);
 }
 
-std::shared_ptr<RenderEngine::Texture2D>
+RenderEngine::Texture2D*
 ResourceManager::loadTextureAtlas(const std::string& textureName,
                                   const std::string& texturePath,
                                   const std::vector<std::string>& subTextures,
                                   const unsigned int subTextureWidth,
-                                  const unsigned int subTextureHeight) {
-    auto pTexture = loadTexture(textureName, texturePath);
+                                  const unsigned int subTextureHeight,
+                                  const std::string& paletteName) {
+    auto pTexture = loadTexture(textureName, texturePath, paletteName);
+    if (! pTexture) {
+        return nullptr;
+    }
     const unsigned int textureWidth = pTexture->width();
     const unsigned int textureHeight = pTexture->height();
     unsigned int currentTextureOffsetX = 0;
@@ -176,52 +738,103 @@ ResourceManager::loadTextureAtlas(const std::string& textureName,
     return pTexture;
 }
 
-std::shared_ptr<RenderEngine::AnimatedSprite>
+RenderEngine::Texture2D*
+ResourceManager::loadTextureAtlas(const std::string& textureName,
+                                  const std::string& texturePath,
+                                  const std::vector<SubTextureRect>& subTextures,
+                                  const std::string& paletteName) {
+    auto pTexture = loadTexture(textureName, texturePath, paletteName);
+    if (! pTexture) {
+        return nullptr;
+    }
+    const float textureWidth = static_cast<float>(pTexture->width());
+    const float textureHeight = static_cast<float>(pTexture->height());
+    for (const auto& currentSubTexture : subTextures) {
+        if (currentSubTexture.x + currentSubTexture.width > pTexture->width() ||
+            currentSubTexture.y + currentSubTexture.height > pTexture->height()) {
+            std::cerr << "Sub texture " << currentSubTexture.name << " is out of the texture: " << texturePath << std::endl;
+            continue;
+        }
+        // Картинка загружена снизу вверх, поэтому V отсчитывается от нижнего края.
+        glm::vec2 leftBottomUV(static_cast<float>(currentSubTexture.x) / textureWidth,
+                               static_cast<float>(pTexture->height() - currentSubTexture.y - currentSubTexture.height) /
+                               textureHeight);
+        glm::vec2 rightTopUV(static_cast<float>(currentSubTexture.x + currentSubTexture.width) / textureWidth,
+                             static_cast<float>(pTexture->height() - currentSubTexture.y) / textureHeight);
+        pTexture->addSubTexture(currentSubTexture.name, leftBottomUV, rightTopUV);
+    }
+    return pTexture;
+}
+
+RenderEngine::AnimatedSprite*
 ResourceManager::loadAnimatedSprite(const std::string& spriteName,
                                     const std::string& textureName,
                                     const std::string& shaderName,
                                     unsigned int spriteWidth, unsigned int spriteHeight,
                                     const std::string& subTextureName) {
-    auto pTexture = getTexture(textureName);
-    if (! pTexture) {
+    const TextureHandle texture = getTextureHandle(textureName);
+    if (! texture) {
         throw Exception::Exception("Can't find the texture: " + textureName +
                                    " for the sprite: " + spriteName);
     }
 
-    auto pShaderProgram = getShaderProgram(shaderName);
-    if (! pShaderProgram) {
+    const ShaderProgramHandle shaderProgram = getShaderProgramHandle(shaderName);
+    if (! shaderProgram) {
         throw Exception::Exception("Can't find the shader program: " + shaderName +
                                    " for the sprite: " + spriteName);
     }
 
-    auto tmp = m_animatedSprite.emplace(spriteName,
-                                        std::make_shared<RenderEngine::AnimatedSprite>(pTexture,
-                                                                                       subTextureName,
-                                                                                       pShaderProgram,
-                                                                                       glm::vec2(0, 0),
-                                                                                       glm::vec2(spriteWidth, spriteHeight),
-                                                                                       0));
-    auto newSprite = tmp.first->second;
-    return newSprite;
+    auto it = m_animatedSprite.find(spriteName);
+    if (it == m_animatedSprite.end()) {
+        it = m_animatedSprite.emplace(spriteName,
+                                      m_animatedSpritePool.create(texture,
+                                                                  subTextureName,
+                                                                  shaderProgram,
+                                                                  glm::vec2(0, 0),
+                                                                  glm::vec2(spriteWidth, spriteHeight),
+                                                                  0)).first;
+    }
+    return m_animatedSpritePool.get(it->second);
+}
+
+RenderEngine::AnimatedSprite* ResourceManager::getAnimatedSprite(const std::string& spriteName) noexcept {
+    return getAnimatedSprite(getAnimatedSpriteHandle(spriteName));
 }
 
-std::shared_ptr<RenderEngine::AnimatedSprite>
-ResourceManager::getAnimatedSprite(const std::string& spriteName) noexcept {
+ResourceManager::AnimatedSpriteHandle
+ResourceManager::getAnimatedSpriteHandle(const std::string& spriteName) noexcept {
     auto it = m_animatedSprite.find(spriteName);
     if (it != m_animatedSprite.end()) {
         return it->second;
     }
+    if (m_pManifest && Manifest::load(m_pManifest->animatedSprites, spriteName, Manifest::loadAnimatedSprite)) {
+        return m_animatedSprite.at(spriteName);
+    }
     std::cerr << "Can't find animated sprite: " << spriteName << std::endl;
-    return nullptr;
+    return {};
+}
+
+RenderEngine::AnimatedSprite* ResourceManager::getAnimatedSprite(const AnimatedSpriteHandle handle) noexcept {
+    return m_animatedSpritePool.get(handle);
 }
 
 bool ResourceManager::loadJSONResources(const std::string& JSONPath) noexcept {
+     PROFILE_SCOPE("ResourceManager::loadJSONResources");
+     ALLOCATION_TAG(ResourceManager);
      const std::string JSONString = getFileString(JSONPath);
      if (JSONString.empty()) {
          std::cerr << "No JSON resources file" << std::endl;
          return false;
      }
-     rapidjson::Document document;
+     Utils::Fnv1a hash;
+     hash.add(JSONString);
+     m_JSONResourcesHash = hash.value();
+     m_JSONPath = JSONPath;
+     m_JSONFiles = { normalizePath(JSONPath) };
+     watchFile(JSONPath);
+
+     auto pManifest = std::make_unique<Manifest>();
+     rapidjson::Document& document = pManifest->document;
      rapidjson::ParseResult parseResult = document.Parse(JSONString.c_str());
      if (! parseResult) {
          std::cerr << "JSON parse error: " << rapidjson::GetParseError_En(parseResult.Code())
@@ -229,70 +842,16 @@ bool ResourceManager::loadJSONResources(const std::string& JSONPath) noexcept {
          std::cerr << "In JSON file: " << JSONPath << std::endl;
          return false;
      }
-
-     auto shadersIt = document.FindMember("shaders");
-     if (shadersIt != document.MemberEnd()) {
-         for (const auto& currShader : shadersIt->value.GetArray()) {
-             const std::string name = currShader["name"].GetString();
-             const std::string filePath_v = currShader["filePath_v"].GetString();
-             const std::string filePath_f = currShader["filePath_f"].GetString();
-             loadShaders(name, filePath_v, filePath_f);
-         }
-     }
-
-     auto textureAtlasesIt = document.FindMember("textureAtlases");
-     if (textureAtlasesIt != document.MemberEnd()) {
-         for (const auto& currTextureAtlases : textureAtlasesIt->value.GetArray()) {
-             const std::string name = currTextureAtlases["name"].GetString();
-             const std::string filePath = currTextureAtlases["filePath"].GetString();
-             const unsigned int subTextureWidth = currTextureAtlases["subTextureWidth"].GetUint();
-             const unsigned int subTextureHeight = currTextureAtlases["subTextureHeight"].GetUint();
-
-             const auto subTexturesArray = currTextureAtlases["subTextures"].GetArray();
-             std::vector<std::string> subTextures;
-             subTextures.reserve(subTexturesArray.Size());
-             for (const auto& currSubTexture : subTexturesArray) {
-                 subTextures.emplace_back(currSubTexture.GetString());
-             }
-             loadTextureAtlas(name, filePath, subTextures, subTextureWidth, subTextureHeight);
-         }
-     }
-
-     auto animatedSpriteIt = document.FindMember("animatedSprites");
-     if (animatedSpriteIt != document.MemberEnd()) {
-         for (const auto& currAnimatedSprite : animatedSpriteIt->value.GetArray()) {
-             const std::string name = currAnimatedSprite["name"].GetString();
-             const std::string textureAtlas = currAnimatedSprite["textureAtlas"].GetString();
-             const std::string shader = currAnimatedSprite["shader"].GetString();
-             const unsigned int initialWidth = currAnimatedSprite["initialWidth"].GetUint();
-             const unsigned int initialHeight = currAnimatedSprite["initialHeight"].GetUint();
-             const std::string initialSubTexture = currAnimatedSprite["initialSubTexture"].GetString();
-
-            auto pAnimatedSprite = loadAnimatedSprite(name, textureAtlas, shader,
-                                                      initialWidth, initialHeight,
-                                                      initialSubTexture);
-            if (! pAnimatedSprite) {
-                continue;
-            }
-
-            const auto statesArray = currAnimatedSprite["states"].GetArray();
-            for (const auto& currState : statesArray) {
-                const std::string stateName = currState["stateName"].GetString();
-                std::vector<std::pair<std::string, uint64_t>> frames;
-                const auto framesArray = currState["frames"].GetArray();
-                frames.reserve(framesArray.Size());
-                for (const auto& currFrame : framesArray) {
-                    const std::string subTexture = currFrame["subTexture"].GetString();
-                    const uint64_t duration = currFrame["duration"].GetUint64();
-                    frames.emplace_back(subTexture, duration);
-                }
-                pAnimatedSprite->insertState(stateName, std::move(frames));
-            }
-         }
-     }
+     pManifest->index("shaders", pManifest->shaders);
+     pManifest->index("palettes", pManifest->palettes);
+     pManifest->index("textureAtlases", pManifest->textureAtlases);
+     pManifest->index("animatedSprites", pManifest->animatedSprites);
 
      auto levelsIt = document.FindMember("levels");
      if (levelsIt != document.MemberEnd()) {
+         // Повторная загрузка (несколько экземпляров Game) заменяет уровни, а не дописывает их.
+         m_levels.clear();
+         m_levelsPrefetch.clear();
          for (const auto& currLevels : levelsIt->value.GetArray()) {
              const auto description = currLevels["description"].GetArray();
              std::vector<std::string> levelRows;
@@ -300,11 +859,73 @@ bool ResourceManager::loadJSONResources(const std::string& JSONPath) noexcept {
              for (const auto& currRow : description) {
                  levelRows.emplace_back(currRow.GetString());
              }
+             m_levels.emplace_back(std::move(levelRows));
+
+             std::vector<std::string> prefetch;
+             const auto prefetchIt = currLevels.FindMember("prefetch");
+             if (prefetchIt != currLevels.MemberEnd()) {
+                 for (const auto& currName : prefetchIt->value.GetArray()) {
+                     prefetch.emplace_back(currName.GetString());
+                 }
+             }
+             m_levelsPrefetch.emplace_back(std::move(prefetch));
          }
      }
-     return true;
+
+     // Описания ссылаются на документ, поэтому он хранится, пока ресурсы могут загружаться.
+     m_pManifest = std::move(pManifest);
+     if (m_lazyLoading && ! m_replaceExisting) {
+         return true;
+     }
+     // Горячая перезагрузка в ленивом режиме заменяет только загруженные ресурсы.
+     const bool loadedOnly = m_lazyLoading;
+     bool result = Manifest::loadAll(m_pManifest->shaders, Manifest::loadShader, m_shaderPrograms, loadedOnly);
+     result = Manifest::loadAll(m_pManifest->palettes, Manifest::loadPalette, m_palettes, loadedOnly) && result;
+     result = Manifest::loadAll(m_pManifest->textureAtlases, Manifest::loadTextureAtlas, m_textures,
+                                loadedOnly) && result;
+     result = Manifest::loadAll(m_pManifest->animatedSprites, Manifest::loadAnimatedSprite, m_animatedSprite,
+                                loadedOnly) && result;
+     return result;
  }
 
+void ResourceManager::prefetchResources(const std::vector<std::string>& names) {
+    PROFILE_SCOPE("ResourceManager::prefetchResources");
+    ALLOCATION_TAG(ResourceManager);
+    for (const std::string& name : names) {
+        if (! m_pManifest) {
+            return;
+        }
+        bool found = false;
+        if (m_pManifest->shaders.count(name)) {
+            found = true;
+            if (! m_shaderPrograms.count(name)) {
+                Manifest::load(m_pManifest->shaders, name, Manifest::loadShader);
+            }
+        }
+        if (m_pManifest->palettes.count(name)) {
+            found = true;
+            if (! m_palettes.count(name)) {
+                Manifest::load(m_pManifest->palettes, name, Manifest::loadPalette);
+            }
+        }
+        if (m_pManifest->textureAtlases.count(name)) {
+            found = true;
+            if (! m_textures.count(name)) {
+                Manifest::load(m_pManifest->textureAtlases, name, Manifest::loadTextureAtlas);
+            }
+        }
+        if (m_pManifest->animatedSprites.count(name)) {
+            found = true;
+            if (! m_animatedSprite.count(name)) {
+                Manifest::load(m_pManifest->animatedSprites, name, Manifest::loadAnimatedSprite);
+            }
+        }
+        if (! found) {
+            std::cerr << "Can't prefetch " << name << ": it is not declared in " << m_JSONPath << std::endl;
+        }
+    }
+}
+
 std::string ResourceManager::getFileString(const std::string& relativeFilePath) noexcept {
     std::ifstream fin(m_resourcePath + "/" + relativeFilePath, std::ios::binary);
     if (! fin.is_open()) {
@@ -4,6 +4,13 @@
 #include <vector>
 #include <map>
 #include <memory>
+#include <cstdint>
+
+#include "../Renderer/Palette.h"
+#include "../Renderer/ResourceHandles.h"
+#include "../Utils/HandlePool.h"
+
+class FileWatcher;
 
 namespace RenderEngine {
     class ShaderProgram;
@@ -23,15 +30,30 @@ public:
     ResourceManager& operator=(ResourceManager&&) = delete;
 
 public:
+    /**
+     * Дескрипторы ресурсов: ресурсами владеет ResourceManager, дескриптор копируется как два
+     * числа и после unloadAllResources() становится устаревшим (get* вернет nullptr). Обращения
+     * к ресурсам по указателям действительны до unloadAllResources().
+     * */
+    using ShaderProgramHandle = RenderEngine::ShaderProgramHandle;
+    using TextureHandle = RenderEngine::TextureHandle;
+    using SpriteHandle = Utils::Handle<RenderEngine::Sprite>;
+    using AnimatedSpriteHandle = Utils::Handle<RenderEngine::AnimatedSprite>;
+
     /**
      * Конструктор класса.
      * @param executablePath абсолютный путь к исполняемому файлу. Папка, в которой лежит исполняемый
      * файл будет считать основной, и все относительный пути будут вестись от нее.
      * */
     static void setExecutablePath(const std::string& executablePath) noexcept;
+    /**
+     * Метод задает каталог, от которого ведутся относительные пути ресурсов, вместо каталога
+     * исполняемого файла (например, исходное дерево для горячей перезагрузки).
+     * */
+    static void setResourcePath(const std::string& resourcePath) noexcept;
     static void unloadAllResources();
 
-    static std::shared_ptr<RenderEngine::ShaderProgram>
+    static RenderEngine::ShaderProgram*
     loadShaders(const std::string& shaderName,
                 const std::string& vertexPath, const std::string& fragmentPath);
     /**
@@ -41,11 +63,33 @@ public:
      * В случае, если шейдерная программа не была найдена, в std::cerr будет выведено
      * соответствующее сообщение.
      * */
-    static std::shared_ptr<RenderEngine::ShaderProgram>
-    getShaderProgram(const std::string& shaderName) noexcept;
+    static RenderEngine::ShaderProgram* getShaderProgram(const std::string& shaderName) noexcept;
+    /**
+     * Метод возвращает дескриптор шейдерной программы с заданным именем.
+     * @return пустой дескриптор, если она не была найдена (с сообщением в std::cerr).
+     * */
+    static ShaderProgramHandle getShaderProgramHandle(const std::string& shaderName) noexcept;
+    static RenderEngine::ShaderProgram* getShaderProgram(ShaderProgramHandle handle) noexcept;
 
-    static std::shared_ptr<RenderEngine::Texture2D>
-    loadTexture(const std::string& textureName, const std::string& texturePath);
+    static std::shared_ptr<RenderEngine::Palette>
+    loadPalette(const std::string& paletteName, std::vector<RenderEngine::Palette::Row> rows);
+    /**
+     * Метод возвращает указатель на палитру с заданным именем.
+     * @return указатель на палитру или nullptr, если она не была найдена. В std::cerr будет
+     * выведено соответствующее сообщение.
+     * */
+    static std::shared_ptr<RenderEngine::Palette> getPalette(const std::string& paletteName) noexcept;
+
+    /**
+     * Метод загружает текстуру из PNG файла.
+     * @param paletteName имя загруженной палитры. Если задано, картинка переводится в индексы
+     * палитры и хранится в GL_R8 (индексированная текстура), иначе - в исходных каналах.
+     * @return указатель на текстуру или nullptr, если картинку не удалось прочитать или в ней
+     * есть цвета не из палитры. В std::cerr будет выведено сообщение.
+     * */
+    static RenderEngine::Texture2D*
+    loadTexture(const std::string& textureName, const std::string& texturePath,
+                const std::string& paletteName = "");
     /**
      * Метод возвращает указатель на текстуру с заданным именем.
      * @param textureName имя текстуры для поиска.
@@ -53,31 +97,152 @@ public:
      * В случае, если текстура не была найдена, в std::cerr будет выведено
      * соответствующее сообщение.
      * */
-    static std::shared_ptr<RenderEngine::Texture2D> getTexture(const std::string& textureName) noexcept;
+    static RenderEngine::Texture2D* getTexture(const std::string& textureName) noexcept;
+    static TextureHandle getTextureHandle(const std::string& textureName) noexcept;
+    static RenderEngine::Texture2D* getTexture(TextureHandle handle) noexcept;
 
-    static std::shared_ptr<RenderEngine::Sprite>
+    static RenderEngine::Sprite*
     loadSprite(const std::string& spriteName,
                const std::string& textureName, const std::string& shaderName,
                unsigned int spriteWidth, unsigned int spriteHeight,
                const std::string& subTextureName = "default");
 
-    static std::shared_ptr<RenderEngine::Sprite> getSprite(const std::string& spriteName) noexcept;
+    static RenderEngine::Sprite* getSprite(const std::string& spriteName) noexcept;
+    static SpriteHandle getSpriteHandle(const std::string& spriteName) noexcept;
+    static RenderEngine::Sprite* getSprite(SpriteHandle handle) noexcept;
 
-    static std::shared_ptr<RenderEngine::Texture2D>
+    /**
+     * Метод загружает атлас из одинаковых ячеек subTextureWidth x subTextureHeight, которые
+     * перечислены в subTextures построчно слева направо и сверху вниз.
+     * */
+    static RenderEngine::Texture2D*
     loadTextureAtlas(const std::string& textureName,
                      const std::string& texturePath, const std::vector<std::string>& subTextures,
-                     unsigned int subTextureWidth, unsigned int subTextureHeight);
+                     unsigned int subTextureWidth, unsigned int subTextureHeight,
+                     const std::string& paletteName = "");
 
-    static std::shared_ptr<RenderEngine::AnimatedSprite>
+    /**
+     * Область спрайта в атласе в пикселях от левого верхнего угла картинки, как ее записывает
+     * упаковщик атласов (tools/AtlasPacker.cpp).
+     * */
+    struct SubTextureRect {
+        std::string name;
+        unsigned int x;
+        unsigned int y;
+        unsigned int width;
+        unsigned int height;
+    };
+    /**
+     * Метод загружает атлас со спрайтами произвольного размера.
+     * */
+    static RenderEngine::Texture2D*
+    loadTextureAtlas(const std::string& textureName,
+                     const std::string& texturePath, const std::vector<SubTextureRect>& subTextures,
+                     const std::string& paletteName = "");
+
+    static RenderEngine::AnimatedSprite*
     loadAnimatedSprite(const std::string& spriteName,
                        const std::string& textureName, const std::string& shaderName,
                        unsigned int spriteWidth, unsigned int spriteHeight,
                        const std::string& subTextureName = "default");
 
-    static std::shared_ptr<RenderEngine::AnimatedSprite>
-    getAnimatedSprite(const std::string& spriteName) noexcept;
+    static RenderEngine::AnimatedSprite* getAnimatedSprite(const std::string& spriteName) noexcept;
+    static AnimatedSpriteHandle getAnimatedSpriteHandle(const std::string& spriteName) noexcept;
+    static RenderEngine::AnimatedSprite* getAnimatedSprite(AnimatedSpriteHandle handle) noexcept;
+
+    /**
+     * Бюджет видеопамяти текстур, загруженных из файлов. Когда загруженные текстуры его
+     * превышают, updateTextures() выгружает те, что дольше всех не подключались (LRU). Выгруженная
+     * текстура синхронно загружается заново из файла при следующем подключении (Texture2D::bind()).
+     * */
+    struct TextureBudget {
+        // 0 - без ограничения.
+        size_t maxBytes = 0;
+        // Текстура выгружается, только если не подключалась хотя бы столько кадров.
+        uint64_t minIdleFrames = 120;
+    };
+
+    /**
+     * Учет ресурсов по типам и работа бюджета текстур.
+     * */
+    struct Stats {
+        // Текстуры из файлов: всего, загруженных в видеопамять, их объем и объем всех текстур.
+        size_t textures = 0;
+        size_t residentTextures = 0;
+        size_t residentTextureBytes = 0;
+        size_t textureBytes = 0;
+        size_t palettes = 0;
+        size_t paletteBytes = 0;
+        size_t shaderPrograms = 0;
+        size_t sprites = 0;
+        size_t animatedSprites = 0;
+        // Кадры, в которых текстура использовалась загруженной.
+        uint64_t hits = 0;
+        // Повторные загрузки выгруженных текстур при подключении.
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+    };
+
+    static void setTextureBudget(const TextureBudget& budget) noexcept { m_textureBudget = budget; }
+    /**
+     * Метод вызывается раз в кадр после отрисовки в потоке, владеющем контекстом OpenGL:
+     * считает попадания и выгружает текстуры сверх бюджета.
+     * */
+    static void updateTextures();
+    static Stats getStats() noexcept;
+
+    /**
+     * Метод включает горячую перезагрузку: наблюдение за файлами шейдеров, текстур и описаний
+     * ресурсов JSON, загруженных до и после вызова.
+     * @return false, если наблюдение за файлами недоступно на этой системе.
+     * */
+    static bool enableHotReload();
+    /**
+     * Метод вызывается раз в кадр в потоке, владеющем контекстом OpenGL, и перезагружает на месте
+     * изменившиеся ресурсы: владельцы указателей на шейдерные программы и текстуры сразу используют
+     * новые объекты OpenGL. Шейдер, который не собрался, и картинка, которую не удалось прочитать,
+     * остаются прежними. При изменении файла ресурсов JSON (или описания атласа) он загружается
+     * заново: шейдеры с новыми путями, палитры и атласы заменяются на месте, новые ресурсы
+     * добавляются, у анимированных спрайтов менеджера заменяются кадры состояний с теми же именами
+     * (размер, атлас и шейдер остаются прежними), уровни применяются при следующей загрузке. Копии
+     * анимированных спрайтов (AnimatedSprite::clone()) новых состояний не получают.
+     * Области атласов при этом могут переместиться: спрайты менеджера находят их заново сами, а
+     * владельцы собственных копий областей должны сделать это, когда метод вернул true.
+     * @return true, если файл ресурсов JSON загружался заново.
+     * */
+    static bool pollHotReload();
 
+    /**
+     * Ленивый режим loadJSONResources(): файл только разбирается и индексируется по именам, а
+     * шейдер, палитра, атлас или анимированный спрайт загружается при первом get* (вместе с
+     * ресурсами, от которых зависит) или заранее через prefetchResources(). Уровни читаются сразу.
+     * */
+    static void setLazyLoading(const bool lazyLoading) noexcept { m_lazyLoading = lazyLoading; }
+    /**
+     * Метод загружает JSON файл ресурсов (в ленивом режиме - только индексирует).
+     * @return false, если файл не удалось прочитать или разобрать либо ресурс в нем не загрузился.
+     * */
     static bool loadJSONResources(const std::string& JSONPath) noexcept;
+    /**
+     * Метод загружает описанные в файле ресурсов JSON ресурсы с заданными именами любого типа,
+     * если они еще не загружены. Нужен в ленивом режиме, чтобы не загружать ресурсы посреди игры.
+     * */
+    static void prefetchResources(const std::vector<std::string>& names);
+    /**
+     * Списки ресурсов для prefetchResources() по уровням (необязательный массив "prefetch"
+     * описания уровня), в том же порядке, что и getLevels().
+     * */
+    static const std::vector<std::vector<std::string>>& getLevelsPrefetch() noexcept { return m_levelsPrefetch; }
+    /**
+     * Метод возвращает описания уровней, прочитанные из JSON файла ресурсов. Каждое описание -
+     * набор строк карты сверху вниз.
+     * */
+    static const std::vector<std::vector<std::string>>& getLevels() noexcept { return m_levels; }
+    /**
+     * Метод возвращает хеш содержимого последнего загруженного JSON файла ресурсов. Повторы
+     * сохраняют его, чтобы проверить, что воспроизводятся на том же наборе ресурсов.
+     * */
+    static uint64_t getJSONResourcesHash() noexcept { return m_JSONResourcesHash; }
 private:
     /**
      * Метод читает в std::string весь переданный файл.
@@ -86,17 +251,63 @@ private:
      * будет выведено сообщение.
      * */
     static std::string getFileString(const std::string& relativeFilePath) noexcept;
+    /**
+     * Метод загружает выгруженную текстуру заново синхронным чтением файла.
+     * */
+    static void reloadTexture(const std::string& textureName, const RenderEngine::Texture2D& texture);
+    /**
+     * Метод начинает наблюдение за файлом ресурса, если включена горячая перезагрузка.
+     * */
+    static void watchFile(const std::string& relativeFilePath);
+    /**
+     * Метод заново читает изменившуюся картинку в ту же текстуру.
+     * @return false, если размер или формат картинки изменились: ее области нужно пересчитать,
+     * загрузив файл ресурсов JSON заново.
+     * */
+    static bool reloadTextureFile(const std::string& textureName);
 
 private:
-    using ShaderProgramMap = std::map<std::string, std::shared_ptr<RenderEngine::ShaderProgram>>;
-    using TextureMap = std::map<std::string, std::shared_ptr<RenderEngine::Texture2D>>;
-    using SpriteMap = std::map<std::string, std::shared_ptr<RenderEngine::Sprite>>;
-    using AnimatedSpriteMap = std::map<std::string, std::shared_ptr<RenderEngine::AnimatedSprite>>;
+    using ShaderProgramMap = std::map<std::string, ShaderProgramHandle>;
+    using PaletteMap = std::map<std::string, std::shared_ptr<RenderEngine::Palette>>;
+    using TextureMap = std::map<std::string, TextureHandle>;
+    using SpriteMap = std::map<std::string, SpriteHandle>;
+    using AnimatedSpriteMap = std::map<std::string, AnimatedSpriteHandle>;
 
+    // Владельцы ресурсов; словари ниже ищут дескрипторы по именам. Пулы шейдерных программ и
+    // текстур принадлежат движку (RenderEngine::getTexturePool()), здесь хранятся ссылки на них.
+    static Utils::HandlePool<RenderEngine::ShaderProgram>& m_shaderProgramPool;
+    static Utils::HandlePool<RenderEngine::Texture2D>& m_texturePool;
+    static Utils::HandlePool<RenderEngine::Sprite> m_spritePool;
+    static Utils::HandlePool<RenderEngine::AnimatedSprite> m_animatedSpritePool;
     static ShaderProgramMap m_shaderPrograms;
+    static PaletteMap m_palettes;
     static TextureMap m_textures;
     static SpriteMap m_sprites;
     static AnimatedSpriteMap m_animatedSprite;
+    // Откуда загружены текстуры из файлов, для повторной загрузки после выгрузки.
+    struct TextureSource;
+    static std::map<std::string, TextureSource> m_textureSources;
+    static TextureBudget m_textureBudget;
+    // Текстуры, которые updateTextures() может выгрузить в этом кадре.
+    static std::vector<RenderEngine::Texture2D*> m_evictionCandidates;
+    static Stats m_stats;
+    struct ShaderSource {
+        std::string vertexPath;
+        std::string fragmentPath;
+    };
+    static std::map<std::string, ShaderSource> m_shaderSources;
+    // Файл ресурсов JSON и описания атласов, при изменении которых он загружается заново.
+    static std::string m_JSONPath;
+    static std::vector<std::string> m_JSONFiles;
+    static std::unique_ptr<FileWatcher> m_pFileWatcher;
+    // Загрузчики заменяют ресурсы с существующими именами на месте (горячая перезагрузка).
+    static bool m_replaceExisting;
+    static std::vector<std::vector<std::string>> m_levels;
+    static std::vector<std::vector<std::string>> m_levelsPrefetch;
+    struct Manifest;
+    static std::unique_ptr<Manifest> m_pManifest;
+    static bool m_lazyLoading;
+    static uint64_t m_JSONResourcesHash;
     // Путь к ресурсам
     static std::string m_resourcePath;
 };
\ No newline at end of file
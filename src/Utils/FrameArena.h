@@ -0,0 +1,140 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace Utils {
+
+    /**
+     * Линейный аллокатор данных, живущих один кадр. Память выдается сдвигом указателя внутри
+     * блока и не освобождается по отдельности: вся разом возвращается методом reset() в конце
+     * кадра. Если блока не хватило, берется дополнительный блок из кучи, а reset() заменяет
+     * все блоки одним общего размера, поэтому после первых кадров арена не обращается к куче.
+     * */
+    class FrameArena {
+    public:
+        FrameArena(const FrameArena&) = delete;
+        FrameArena& operator=(const FrameArena&) = delete;
+
+    public:
+        static constexpr size_t DEFAULT_CAPACITY = 64 * 1024;
+
+        explicit FrameArena(const size_t capacity = DEFAULT_CAPACITY) :
+                            m_usedInFullBlocks(0),
+                            m_offset(0),
+                            m_highWaterMark(0) {
+            addBlock(std::max<size_t>(capacity, 1));
+        }
+
+        /**
+         * Метод выделяет память до конца кадра.
+         * @param size размер в байтах.
+         * @param alignment выравнивание, степень двойки.
+         * */
+        void* allocate(const size_t size, const size_t alignment = alignof(std::max_align_t)) {
+            void* pResult = tryAllocate(size, alignment);
+            if (! pResult) {
+                m_usedInFullBlocks += m_offset;
+                addBlock(std::max(m_blocks.back().size * 2, size + alignment));
+                pResult = tryAllocate(size, alignment);
+            }
+            m_highWaterMark = std::max(m_highWaterMark, used());
+            return pResult;
+        }
+
+        /**
+         * Метод освобождает всю выделенную память. Указатели, полученные до вызова, недействительны.
+         * */
+        void reset() {
+            if (m_blocks.size() > 1) {
+                const size_t size = capacity();
+                m_blocks.clear();
+                addBlock(size);
+            }
+            m_usedInFullBlocks = 0;
+            m_offset = 0;
+        }
+
+        // Байты, выделенные с последнего reset(), с учетом выравнивания.
+        size_t used() const noexcept { return m_usedInFullBlocks + m_offset; }
+        size_t capacity() const noexcept {
+            size_t result = 0;
+            for (const Block& block : m_blocks) {
+                result += block.size;
+            }
+            return result;
+        }
+        // Наибольшее used() за все кадры.
+        size_t highWaterMark() const noexcept { return m_highWaterMark; }
+
+    private:
+        struct Block {
+            std::unique_ptr<std::byte[]> pData;
+            size_t size;
+        };
+
+        void addBlock(const size_t size) {
+            m_blocks.push_back({ std::make_unique<std::byte[]>(size), size });
+            m_offset = 0;
+        }
+
+        void* tryAllocate(const size_t size, const size_t alignment) noexcept {
+            Block& block = m_blocks.back();
+            const uintptr_t begin = reinterpret_cast<uintptr_t>(block.pData.get());
+            const uintptr_t aligned = (begin + m_offset + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1);
+            const size_t offset = static_cast<size_t>(aligned - begin) + size;
+            if (offset > block.size) {
+                return nullptr;
+            }
+            m_offset = offset;
+            return reinterpret_cast<void*>(aligned);
+        }
+
+    private:
+        // Память выдается из последнего блока, остальные заполнены.
+        std::vector<Block> m_blocks;
+        size_t m_usedInFullBlocks;
+        size_t m_offset;
+        size_t m_highWaterMark;
+    };
+
+    /**
+     * Аллокатор стандартных контейнеров поверх FrameArena. Освобождение ничего не делает, поэтому
+     * при росте контейнера старая память остается занятой до reset() арены. Контейнер нужно
+     * опустошить или пересоздать до reset(), иначе он будет ссылаться на освобожденную память.
+     * */
+    template<typename T>
+    class ArenaAllocator {
+    public:
+        using value_type = T;
+        using propagate_on_container_copy_assignment = std::true_type;
+        using propagate_on_container_move_assignment = std::true_type;
+        using propagate_on_container_swap = std::true_type;
+
+        explicit ArenaAllocator(FrameArena& arena) noexcept : m_pArena(&arena) {}
+        template<typename U>
+        ArenaAllocator(const ArenaAllocator<U>& other) noexcept : m_pArena(other.arena()) {}
+
+        T* allocate(const size_t count) {
+            return static_cast<T*>(m_pArena->allocate(count * sizeof(T), alignof(T)));
+        }
+        void deallocate(T*, size_t) noexcept {}
+
+        FrameArena* arena() const noexcept { return m_pArena; }
+
+        template<typename U>
+        bool operator==(const ArenaAllocator<U>& other) const noexcept { return m_pArena == other.arena(); }
+        template<typename U>
+        bool operator!=(const ArenaAllocator<U>& other) const noexcept { return m_pArena != other.arena(); }
+
+    private:
+        FrameArena* m_pArena;
+    };
+
+    template<typename T>
+    using FrameVector = std::vector<T, ArenaAllocator<T>>;
+}
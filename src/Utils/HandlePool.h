@@ -0,0 +1,158 @@
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Utils {
+
+    /**
+     * Дескриптор объекта HandlePool: номер слота и поколение слота на момент создания объекта.
+     * Копируется как два числа, без счетчика ссылок. Пустой дескриптор не ссылается ни на что.
+     * */
+    template<typename T>
+    struct Handle {
+        static constexpr uint32_t NULL_INDEX = UINT32_MAX;
+
+        uint32_t index = NULL_INDEX;
+        uint32_t generation = 0;
+
+        bool isNull() const noexcept { return index == NULL_INDEX; }
+        explicit operator bool() const noexcept { return ! isNull(); }
+        bool operator==(const Handle& other) const noexcept {
+            return index == other.index && generation == other.generation;
+        }
+        bool operator!=(const Handle& other) const noexcept { return ! (*this == other); }
+    };
+
+    /**
+     * Пул объектов, владеющий ими и выдающий на них дескрипторы Handle. Владельцы объектов лежат
+     * плотным массивом (удаление переносит последний на место удаленного), слоты дескрипторов
+     * ссылаются на место в нем. Удаление объекта увеличивает поколение слота, поэтому дескрипторы
+     * удаленного объекта становятся устаревшими, даже если слот уже занят другим объектом.
+     * Адрес объекта не меняется, пока объект существует.
+     *
+     * Каждый объект выделяется отдельно, а плотный массив хранит только владельцев: по адресу на
+     * объекты ссылаются указатели, которые возвращает ResourceManager, пакеты SpriteBatch и список
+     * выгрузки текстур, а при росте или удалении непрерывный массив объектов переносил бы их.
+     * Кроме того, спрайты не перемещаемы. Объекты создаются при загрузке ресурсов и уровня, а не
+     * в кадре, поэтому выделения по одному на объект игре не мешают.
+     * */
+    template<typename T>
+    class HandlePool {
+        static_assert(std::is_trivially_copyable<Handle<T>>::value, "Handle must be trivially copyable");
+
+    public:
+        HandlePool(const HandlePool&) = delete;
+        HandlePool& operator=(const HandlePool&) = delete;
+
+    public:
+        HandlePool() = default;
+
+        template<typename... Args>
+        Handle<T> create(Args&&... args) {
+            return insert(std::make_unique<T>(std::forward<Args>(args)...));
+        }
+
+        Handle<T> insert(std::unique_ptr<T> pObject) {
+            uint32_t index;
+            if (! m_freeSlots.empty()) {
+                index = m_freeSlots.back();
+                m_freeSlots.pop_back();
+            } else {
+                index = static_cast<uint32_t>(m_slots.size());
+                m_slots.emplace_back();
+            }
+            Slot& slot = m_slots[index];
+            slot.objectIndex = static_cast<uint32_t>(m_objects.size());
+            m_objects.push_back(std::move(pObject));
+            m_objectSlots.push_back(index);
+            return { index, slot.generation };
+        }
+
+        /**
+         * Метод удаляет объект.
+         * @return false, если дескриптор пустой или устаревший.
+         * */
+        bool destroy(const Handle<T> handle) noexcept {
+            if (! isAlive(handle)) {
+                return false;
+            }
+            Slot& slot = m_slots[handle.index];
+            const uint32_t lastIndex = static_cast<uint32_t>(m_objects.size() - 1);
+            if (slot.objectIndex != lastIndex) {
+                m_objects[slot.objectIndex] = std::move(m_objects[lastIndex]);
+                m_objectSlots[slot.objectIndex] = m_objectSlots[lastIndex];
+                m_slots[m_objectSlots[slot.objectIndex]].objectIndex = slot.objectIndex;
+            }
+            m_objects.pop_back();
+            m_objectSlots.pop_back();
+            slot.objectIndex = NO_OBJECT;
+            ++slot.generation;
+            m_freeSlots.push_back(handle.index);
+            return true;
+        }
+
+        /**
+         * Метод удаляет все объекты; все выданные дескрипторы становятся устаревшими.
+         * */
+        void clear() noexcept {
+            for (const uint32_t index : m_objectSlots) {
+                m_slots[index].objectIndex = NO_OBJECT;
+                ++m_slots[index].generation;
+                m_freeSlots.push_back(index);
+            }
+            m_objects.clear();
+            m_objectSlots.clear();
+        }
+
+        bool isAlive(const Handle<T> handle) const noexcept {
+            return handle.index < m_slots.size() && m_slots[handle.index].generation == handle.generation &&
+                   m_slots[handle.index].objectIndex != NO_OBJECT;
+        }
+
+        /**
+         * Метод возвращает объект по дескриптору.
+         * @return nullptr для пустого или устаревшего дескриптора. Устаревший дескриптор - ошибка
+         * владельца, поэтому в отладочной сборке он останавливает программу (assert).
+         * */
+        T* get(const Handle<T> handle) const noexcept {
+            if (handle.isNull()) {
+                return nullptr;
+            }
+            const bool alive = isAlive(handle);
+            assert(alive && "Stale handle: the object was destroyed");
+            return alive ? m_objects[m_slots[handle.index].objectIndex].get() : nullptr;
+        }
+
+        /**
+         * Метод вызывает function(T&) для каждого объекта пула в порядке хранения.
+         * */
+        template<typename Function>
+        void forEach(Function&& function) const {
+            for (const std::unique_ptr<T>& pObject : m_objects) {
+                function(*pObject);
+            }
+        }
+
+        size_t size() const noexcept { return m_objects.size(); }
+
+    private:
+        static constexpr uint32_t NO_OBJECT = UINT32_MAX;
+
+        struct Slot {
+            uint32_t generation = 0;
+            // Место объекта в m_objects, NO_OBJECT - слот свободен.
+            uint32_t objectIndex = NO_OBJECT;
+        };
+
+        std::vector<Slot> m_slots;
+        std::vector<uint32_t> m_freeSlots;
+        std::vector<std::unique_ptr<T>> m_objects;
+        // Слот каждого объекта m_objects, чтобы исправить его при переносе объекта.
+        std::vector<uint32_t> m_objectSlots;
+    };
+}
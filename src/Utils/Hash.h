@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+namespace Utils {
+    /**
+     * Накопительный 64-битный хеш FNV-1a. Используется для контрольных сумм ресурсов и
+     * состояния игры в файлах повторов.
+     * */
+    class Fnv1a {
+    public:
+        void add(const void* data, const size_t size) noexcept {
+            const auto* bytes = static_cast<const unsigned char*>(data);
+            for (size_t i = 0; i < size; ++i) {
+                m_value ^= bytes[i];
+                m_value *= PRIME;
+            }
+        }
+
+        template<typename T>
+        void add(const T& value) noexcept {
+            static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable values can be hashed");
+            add(&value, sizeof(T));
+        }
+
+        void add(const std::string& value) noexcept { add(value.data(), value.size()); }
+
+        uint64_t value() const noexcept { return m_value; }
+
+    private:
+        static constexpr uint64_t OFFSET_BASIS = 0xCBF29CE484222325ull;
+        static constexpr uint64_t PRIME = 0x100000001B3ull;
+
+        uint64_t m_value = OFFSET_BASIS;
+    };
+}
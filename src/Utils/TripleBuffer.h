@@ -0,0 +1,66 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace Utils {
+
+    /**
+     * Тройной буфер без блокировок для одного производителя и одного потребителя. Производитель
+     * заполняет свой буфер и публикует его, потребитель забирает самый свежий опубликованный.
+     * Ни одна сторона не ждет другую: если потребитель не успевает, промежуточные значения
+     * пропускаются, если производитель не успевает, потребитель продолжает видеть последнее.
+     * Объекты T создаются один раз и переиспользуются, поэтому их память (например, емкость
+     * векторов) сохраняется между кадрами.
+     * */
+    template<typename T>
+    class TripleBuffer {
+    public:
+        TripleBuffer() noexcept : m_writeIndex(0), m_readIndex(1), m_sharedState(2) {}
+        TripleBuffer(const TripleBuffer&) = delete;
+        TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+        /**
+         * Буфер, который заполняет производитель.
+         * */
+        T& writeBuffer() noexcept { return m_buffers[m_writeIndex]; }
+        /**
+         * Метод публикует заполненный буфер и выдает производителю свободный.
+         * */
+        void publish() noexcept {
+            const uint8_t previous = m_sharedState.exchange(static_cast<uint8_t>(m_writeIndex | FRESH_BIT),
+                                                            std::memory_order_acq_rel);
+            m_writeIndex = previous & INDEX_MASK;
+        }
+        /**
+         * Метод забирает самый свежий опубликованный буфер, если он появился.
+         * @return true, если readBuffer() изменился с прошлого вызова.
+         * */
+        bool acquire() noexcept {
+            if ((m_sharedState.load(std::memory_order_relaxed) & FRESH_BIT) == 0) {
+                return false;
+            }
+            const uint8_t previous = m_sharedState.exchange(m_readIndex, std::memory_order_acq_rel);
+            m_readIndex = previous & INDEX_MASK;
+            return true;
+        }
+        /**
+         * Буфер, который читает потребитель. Не меняется до следующего успешного acquire().
+         * */
+        const T& readBuffer() const noexcept { return m_buffers[m_readIndex]; }
+
+    private:
+        static constexpr uint8_t INDEX_MASK = 0x3;
+        // Опубликованный буфер еще не забран потребителем.
+        static constexpr uint8_t FRESH_BIT = 0x4;
+
+        std::array<T, 3> m_buffers;
+        // Индекс буфера производителя, меняется только производителем.
+        uint8_t m_writeIndex;
+        // Индекс буфера потребителя, меняется только потребителем.
+        uint8_t m_readIndex;
+        // Индекс среднего буфера, которым стороны обмениваются, и флаг свежести.
+        alignas(64) std::atomic<uint8_t> m_sharedState;
+    };
+}
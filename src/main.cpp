@@ -6,6 +6,10 @@
 
 #include <iostream>
 #include <chrono>
+#include <limits>
+#include <memory>
+#include <string>
+#include <type_traits>
 
 #include "Renderer/ShaderProgram.h"
 #include "ResourceManager/ResourceManager.h"
@@ -13,16 +17,427 @@
 #include "Renderer/Texture2D.h"
 #include "Renderer/Sprite.h"
 #include "Renderer/AnimatedSprite.h"
+#include "Renderer/RenderThread.h"
+#include "Renderer/OffscreenContext.h"
+#include "Renderer/FramePacer.h"
 
 #include "Game/Game.h"
+#include "Game/Replay.h"
+#include "Network/UdpSocket.h"
+#include "Network/RollbackSession.h"
+#include "Network/LoopbackHarness.h"
+#include "Offscreen/OffscreenRunner.h"
+#include "Profiler/Profiler.h"
+#include "Profiler/AllocationCounter.h"
 
 glm::ivec2 g_windowSize(640, 480);
 Game g_game(g_windowSize);
+// Поток отрисовки в режиме --render-thread, иначе nullptr.
+RenderEngine::RenderThread* g_pRenderThread = nullptr;
+
+struct CommandLine {
+    // Путь, по которому записывается повтор игры.
+    std::string recordPath;
+    // Путь к повтору, который нужно воспроизвести без отрисовки.
+    std::string replayPath;
+    uint64_t seed = 0;
+    // Отрисовка и glfwSwapBuffers выполняются в отдельном потоке.
+    bool renderThread = false;
+    // Ограничение частоты кадров: отрицательное - частота основного монитора, 0 - без ограничения.
+    double targetFps = -1.0;
+
+    // Профилирование кадров [profileFirstFrame, profileLastFrame] (сборка с BATTLECITY_PROFILING).
+    bool profile = false;
+    uint64_t profileFirstFrame = 0;
+    uint64_t profileLastFrame = 299;
+    // Файл trace_event JSON для chrome://tracing и Perfetto.
+    std::string profileTracePath;
+
+    // Сетевая игра вдвоем: локальный порт, адрес второго игрока и номер своего игрока.
+    uint16_t netPort = 0;
+    std::string netPeer;
+    unsigned int netPlayer = 0;
+    unsigned int netInputDelay = 2;
+    // Имитация плохого канала для сетевой игры и проверки на одной машине.
+    Network::LinkConditioner::Settings netLink;
+    // Длительность проверки сетевой игры через 127.0.0.1 в секундах игрового времени.
+    uint64_t netLoopbackSeconds = 0;
+
+    // Разрешение, в котором рисуется сцена перед масштабированием до окна; 0x0 - размер окна.
+    glm::uvec2 internalResolution{ 0 };
+
+    // Отрисовка без окна в каталог offscreenPath: повтор (--replay) или сценарий на offscreenFrames кадров.
+    std::string offscreenPath;
+    uint64_t offscreenFrames = 600;
+    unsigned int captureEvery = 60;
+    // Каталог эталонных кадров и допустимая разница канала пикселя.
+    std::string goldenPath;
+    unsigned int goldenTolerance = 0;
+    // Допустимое число выделений из кучи после разогрева (сборка с BATTLECITY_COUNT_ALLOCATIONS);
+    // -1 - без проверки.
+    int64_t maxSteadyAllocations = -1;
+
+    // Бюджет видеопамяти текстур; 0 - без ограничения.
+    ResourceManager::TextureBudget textureBudget;
+
+    // Каталог с папкой res вместо каталога исполняемого файла и горячая перезагрузка ресурсов.
+    std::string resourceDirectory;
+    bool hotReload = false;
+    // Ресурсы из resources.json загружаются при первом обращении.
+    bool lazyResources = false;
+};
+
+/**
+ * Функция разбирает число из аргумента командной строки целиком: без лишних символов после
+ * числа, без знака минус у беззнаковых и в пределах типа.
+ * @return false, если текст не является числом типа T.
+ * */
+template <typename T>
+bool parseNumber(const std::string& text, T& value) noexcept {
+    size_t length = 0;
+    try {
+        if constexpr (std::is_floating_point_v<T>) {
+            value = static_cast<T>(std::stod(text, &length));
+        } else if constexpr (std::is_signed_v<T>) {
+            const long long number = std::stoll(text, &length);
+            if (number < std::numeric_limits<T>::min() || number > std::numeric_limits<T>::max()) {
+                return false;
+            }
+            value = static_cast<T>(number);
+        } else {
+            // std::stoull принимает отрицательные числа, заворачивая их.
+            if (text.find('-') != std::string::npos) {
+                return false;
+            }
+            const unsigned long long number = std::stoull(text, &length);
+            if (number > std::numeric_limits<T>::max()) {
+                return false;
+            }
+            value = static_cast<T>(number);
+        }
+    } catch (const std::exception&) {
+        return false;
+    }
+    return length == text.size();
+}
+
+/**
+ * Функция разбирает аргументы командной строки.
+ * @return false, если значение какого-то параметра не удалось разобрать (ошибки уже выведены).
+ * */
+bool parseCommandLine(int argc, char** argv, CommandLine& commandLine) {
+    bool valid = true;
+    for (int i = 1; i < argc; ++i) {
+        const std::string argument = argv[i];
+        const bool hasValue = i + 1 < argc;
+        const auto invalidValue = [&argument, &valid](const std::string& text) {
+            std::cerr << "Invalid value for " << argument << ": " << text << std::endl;
+            valid = false;
+        };
+        const auto readNumber = [&](auto& value) {
+            const std::string text = argv[++i];
+            if (! parseNumber(text, value)) {
+                invalidValue(text);
+            }
+        };
+        if (argument == "--record" && hasValue) {
+            commandLine.recordPath = argv[++i];
+        } else if (argument == "--replay" && hasValue) {
+            commandLine.replayPath = argv[++i];
+        } else if (argument == "--seed" && hasValue) {
+            readNumber(commandLine.seed);
+        } else if (argument == "--render-thread") {
+            commandLine.renderThread = true;
+        } else if (argument == "--fps" && hasValue) {
+            readNumber(commandLine.targetFps);
+        } else if (argument == "--profile-frames" && hasValue) {
+            // Диапазон кадров в виде first-last.
+            const std::string range = argv[++i];
+            const size_t separator = range.find('-');
+            commandLine.profile = true;
+            if (! parseNumber(range.substr(0, separator), commandLine.profileFirstFrame)) {
+                invalidValue(range);
+            } else if (separator == std::string::npos) {
+                commandLine.profileLastFrame = commandLine.profileFirstFrame;
+            } else if (! parseNumber(range.substr(separator + 1), commandLine.profileLastFrame)) {
+                invalidValue(range);
+            }
+        } else if (argument == "--profile-trace" && hasValue) {
+            commandLine.profile = true;
+            commandLine.profileTracePath = argv[++i];
+        } else if (argument == "--net-port" && hasValue) {
+            readNumber(commandLine.netPort);
+        } else if (argument == "--net-peer" && hasValue) {
+            commandLine.netPeer = argv[++i];
+        } else if (argument == "--net-player" && hasValue) {
+            readNumber(commandLine.netPlayer);
+            commandLine.netPlayer = commandLine.netPlayer == 0 ? 0 : 1;
+        } else if (argument == "--net-delay" && hasValue) {
+            readNumber(commandLine.netInputDelay);
+        } else if (argument == "--net-latency" && hasValue) {
+            readNumber(commandLine.netLink.latencyMs);
+        } else if (argument == "--net-jitter" && hasValue) {
+            readNumber(commandLine.netLink.jitterMs);
+        } else if (argument == "--net-loss" && hasValue) {
+            readNumber(commandLine.netLink.lossPercent);
+        } else if (argument == "--net-loopback" && hasValue) {
+            readNumber(commandLine.netLoopbackSeconds);
+        } else if (argument == "--internal-resolution" && hasValue) {
+            // Размер в виде WxH, например 256x240.
+            const std::string resolution = argv[++i];
+            const size_t separator = resolution.find('x');
+            if (separator == std::string::npos
+                || ! parseNumber(resolution.substr(0, separator), commandLine.internalResolution.x)
+                || ! parseNumber(resolution.substr(separator + 1), commandLine.internalResolution.y)) {
+                invalidValue(resolution);
+            }
+        } else if (argument == "--offscreen" && hasValue) {
+            commandLine.offscreenPath = argv[++i];
+        } else if (argument == "--frames" && hasValue) {
+            readNumber(commandLine.offscreenFrames);
+        } else if (argument == "--capture-every" && hasValue) {
+            readNumber(commandLine.captureEvery);
+        } else if (argument == "--golden" && hasValue) {
+            commandLine.goldenPath = argv[++i];
+        } else if (argument == "--golden-tolerance" && hasValue) {
+            readNumber(commandLine.goldenTolerance);
+        } else if (argument == "--max-steady-allocations" && hasValue) {
+            readNumber(commandLine.maxSteadyAllocations);
+        } else if (argument == "--texture-budget" && hasValue) {
+            // Бюджет в килобайтах.
+            size_t budgetKb = 0;
+            readNumber(budgetKb);
+            commandLine.textureBudget.maxBytes = budgetKb * 1024;
+        } else if (argument == "--texture-idle-frames" && hasValue) {
+            readNumber(commandLine.textureBudget.minIdleFrames);
+        } else if (argument == "--resource-dir" && hasValue) {
+            commandLine.resourceDirectory = argv[++i];
+        } else if (argument == "--hot-reload") {
+            commandLine.hotReload = true;
+        } else if (argument == "--lazy-resources") {
+            commandLine.lazyResources = true;
+        } else {
+            std::cerr << "Unknown argument: " << argument << std::endl;
+        }
+    }
+    return valid;
+}
+
+int playReplay(const std::string& replayPath) {
+    ReplayPlayer replayPlayer(replayPath);
+    g_game.setSeed(replayPlayer.getHeader().seed);
+    g_game.init();
+    if (replayPlayer.getHeader().resourcesHash != ResourceManager::getJSONResourcesHash()) {
+        std::cerr << "Warning: replay was recorded with different resources" << std::endl;
+    }
+    const ReplayPlayer::Result result = replayPlayer.play(g_game);
+    const double elapsedSeconds = static_cast<double>(result.elapsedNs) / 1e9;
+    const double gameSeconds = static_cast<double>(result.ticks * Game::TICK_DURATION) / 1e9;
+    std::cout << "Replay: " << result.ticks << " ticks, " << result.inputEvents << " input events in "
+              << elapsedSeconds * 1000.0 << " ms (" << gameSeconds / elapsedSeconds
+              << "x real time)" << std::endl;
+    std::cout << "State hashes: " << result.checkedHashes << " checked, "
+              << result.mismatches << " mismatched";
+    if (result.mismatches > 0) {
+        std::cout << ", first at tick " << result.firstMismatchTick;
+    }
+    std::cout << std::endl;
+    return result.mismatches == 0 ? 0 : 1;
+}
+
+void printNetworkStats(const std::string& name, const Network::RollbackSession::Stats& stats) {
+    const double averageRollback = stats.rollbacks ? static_cast<double>(stats.rollbackTicks) / stats.rollbacks : 0.0;
+    const double averageResimulationUs = stats.rollbacks ? stats.resimulationNs / 1e3 / stats.rollbacks : 0.0;
+    std::cout << name << ": " << stats.frames << " frames, " << stats.stalls << " stalls, "
+              << stats.rollbacks << " rollbacks (avg " << averageRollback << " ticks, max "
+              << stats.maxRollbackTicks << "), resimulation avg " << averageResimulationUs << " us, max "
+              << stats.maxResimulationNs / 1e3 << " us, max frame " << stats.maxFrameNs / 1e3 << " us, packets "
+              << stats.packetsSent << " sent / " << stats.packetsReceived << " received / "
+              << stats.packetsDropped << " dropped, state hashes " << stats.checkedHashes << " checked / "
+              << stats.desyncs << " desynced" << std::endl;
+}
+
+int runNetworkLoopback(const CommandLine& commandLine) {
+    Game secondGame(g_windowSize);
+    for (Game* pGame : { &g_game, &secondGame }) {
+        pGame->setPlayersCount(2);
+        pGame->setSeed(commandLine.seed);
+        pGame->init();
+    }
+
+    Network::LoopbackHarness::Settings settings;
+    settings.ticks = commandLine.netLoopbackSeconds * 60;
+    settings.inputDelay = commandLine.netInputDelay;
+    settings.seed = commandLine.seed;
+    if (commandLine.netLink.latencyMs || commandLine.netLink.jitterMs || commandLine.netLink.lossPercent) {
+        settings.link = commandLine.netLink;
+    }
+    std::cout << "Loopback: latency " << settings.link.latencyMs << " ms, jitter " << settings.link.jitterMs
+              << " ms, loss " << settings.link.lossPercent << "%, input delay " << settings.inputDelay
+              << " ticks" << std::endl;
+
+    const Network::LoopbackHarness::Result result = Network::LoopbackHarness::run(g_game, secondGame, settings);
+    printNetworkStats("Player 1", result.stats[0]);
+    printNetworkStats("Player 2", result.stats[1]);
+    const bool synchronized = result.finalHashes[0] == result.finalHashes[1] &&
+                              result.stats[0].desyncs == 0 && result.stats[1].desyncs == 0;
+    std::cout << "Confirmed " << result.confirmedTick << " ticks in " << result.elapsedNs / 1e6 << " ms, final state "
+              << (synchronized ? "matches" : "DIFFERS") << std::endl;
+    return synchronized ? 0 : 1;
+}
+
+void printResourceStats() {
+    const ResourceManager::Stats stats = ResourceManager::getStats();
+    std::cout << "Resources: " << stats.residentTextures << "/" << stats.textures << " textures resident ("
+              << stats.residentTextureBytes / 1024 << "/" << stats.textureBytes / 1024 << " KB), "
+              << stats.palettes << " palettes (" << stats.paletteBytes / 1024 << " KB), "
+              << stats.shaderPrograms << " shaders, " << stats.sprites << " sprites, "
+              << stats.animatedSprites << " animated sprites" << std::endl;
+    std::cout << "Texture budget: " << stats.hits << " hits, " << stats.misses << " misses, "
+              << stats.evictions << " evictions" << std::endl;
+}
+
+/**
+ * Функция начинает запись профилировщика, если она запрошена в командной строке.
+ * */
+void startProfiling(const CommandLine& commandLine) {
+    if (! commandLine.profile) {
+        return;
+    }
+#ifdef BATTLECITY_PROFILING
+    PROFILE_THREAD_NAME("Main");
+    Profiler::startCapture(commandLine.profileFirstFrame, commandLine.profileLastFrame,
+                           commandLine.profileTracePath);
+#else
+    std::cerr << "Profiling is not available: build with -DBATTLECITY_PROFILING=ON" << std::endl;
+#endif
+}
+
+/**
+ * Отрисовка без окна (--offscreen). Контекст OpenGL создается без GLFW, поэтому режим работает
+ * и на сервере сборки без дисплея.
+ * */
+int runOffscreen(const CommandLine& commandLine, const char* executablePath) {
+    int exitCode = 0;
+    std::unique_ptr<RenderEngine::OffscreenContext> pContext;
+    try {
+        pContext = std::make_unique<RenderEngine::OffscreenContext>();
+        std::cout << "Renderer: " << RenderEngine::Renderer::getRendererStr() << std::endl;
+        RenderEngine::Renderer::setClearColour(0, 0, 0, 1);
+        ResourceManager::setExecutablePath(executablePath);
+        if (! commandLine.resourceDirectory.empty()) {
+            ResourceManager::setResourcePath(commandLine.resourceDirectory);
+        }
+
+        Offscreen::OffscreenRunner::Settings settings;
+        settings.outputDirectory = commandLine.offscreenPath;
+        settings.width = static_cast<unsigned int>(g_windowSize.x);
+        settings.height = static_cast<unsigned int>(g_windowSize.y);
+        settings.replayPath = commandLine.replayPath;
+        settings.seed = commandLine.seed;
+        settings.frames = commandLine.offscreenFrames;
+        settings.captureEvery = commandLine.captureEvery;
+        settings.goldenDirectory = commandLine.goldenPath;
+        settings.goldenTolerance = commandLine.goldenTolerance;
+        Offscreen::OffscreenRunner runner(settings);
+        startProfiling(commandLine);
+        const Offscreen::OffscreenRunner::Result result = runner.run(g_game);
+        // Диапазон профилирования длиннее прогона: сохраняем записанное.
+        Profiler::finishCapture();
+
+        std::cout << "Offscreen: " << result.frames << " frames, avg " << result.averageFrameMs << " ms, p99 "
+                  << result.p99FrameMs << " ms, " << result.capturedFrames << " captured ("
+                  << result.captureStalls << " readback stalls)" << std::endl;
+        if (! commandLine.goldenPath.empty()) {
+            std::cout << "Golden frames: " << result.goldenMatches << " match, " << result.goldenMismatches
+                      << " differ, " << result.goldenMissing << " missing" << std::endl;
+            exitCode = result.goldenMismatches == 0 && result.goldenMissing == 0 ? 0 : 1;
+        }
+        if (AllocationCounter::isEnabled()) {
+            std::cout << "Heap allocations after " << Offscreen::OffscreenRunner::WARMUP_FRAMES
+                      << " warm-up frames: " << result.steadyAllocations << " total, max "
+                      << result.maxFrameAllocations << " per frame" << std::endl;
+            for (size_t i = 0; i < AllocationCounter::TAGS_COUNT; ++i) {
+                if (result.steadyAllocationsByTag[i] > 0) {
+                    std::cout << "  " << AllocationCounter::getTagName(static_cast<AllocationCounter::ETag>(i))
+                              << ": " << result.steadyAllocationsByTag[i] << std::endl;
+                }
+            }
+        }
+        if (commandLine.maxSteadyAllocations >= 0) {
+            // Проверка для CI: установившаяся игра не должна обращаться к куче.
+            if (! AllocationCounter::isEnabled()) {
+                std::cerr << "--max-steady-allocations requires a build with BATTLECITY_COUNT_ALLOCATIONS" << std::endl;
+                exitCode = 1;
+            } else if (result.steadyAllocations > static_cast<uint64_t>(commandLine.maxSteadyAllocations)) {
+                std::cerr << "Steady-state heap allocations " << result.steadyAllocations << " exceed "
+                          << commandLine.maxSteadyAllocations << std::endl;
+                exitCode = 1;
+            }
+        }
+        std::cout << "Report written to " << commandLine.offscreenPath << "/report.json" << std::endl;
+    } catch (const std::exception& ex) {
+        std::cerr << ex.what() << std::endl;
+        exitCode = -1;
+    }
+    // Ресурсы игры освобождаются, пока контекст еще существует.
+    if (pContext) {
+        if (commandLine.textureBudget.maxBytes > 0) {
+            printResourceStats();
+        }
+        RenderEngine::Renderer::releaseGpuTimer();
+        ResourceManager::unloadAllResources();
+    }
+    return exitCode;
+}
+
+// Как долго ждать событий окна в паузе. Кадр все равно перерисовывается после пробуждения.
+constexpr double PAUSED_EVENTS_TIMEOUT = 0.25;
+
+double getTargetFps(const CommandLine& commandLine) {
+    if (commandLine.targetFps >= 0.0) {
+        return commandLine.targetFps;
+    }
+    const GLFWvidmode* pVideoMode = glfwGetVideoMode(glfwGetPrimaryMonitor());
+    return pVideoMode && pVideoMode->refreshRate > 0 ? pVideoMode->refreshRate : 60.0;
+}
+
+/**
+ * Ожидание начала кадра. В паузе и без фокуса окна процессор не занят: поток спит в ожидании
+ * событий, пока не понадобится следующий шаг симуляции (без фокуса) или не придет любое
+ * событие (в паузе). Иначе частоту кадров ограничивает framePacer, а события только опрашиваются.
+ * */
+void waitForFrame(GLFWwindow* pWindow, RenderEngine::FramePacer& framePacer) {
+    PROFILE_SCOPE("waitForFrame");
+    if (g_game.isPaused()) {
+        glfwWaitEventsTimeout(PAUSED_EVENTS_TIMEOUT);
+        framePacer.reset();
+    } else if (! glfwGetWindowAttrib(pWindow, GLFW_FOCUSED)) {
+        glfwWaitEventsTimeout(static_cast<double>(g_game.getTimeToNextTick()) / 1e9);
+        framePacer.reset();
+    } else {
+        framePacer.waitForNextFrame();
+        glfwPollEvents();
+    }
+}
+
+void printFramePacingStats(const RenderEngine::FramePacer& framePacer) {
+    const RenderEngine::FramePacer::Stats stats = framePacer.getStats();
+    std::cout << "Frame pacing: target " << framePacer.getTargetFps() << " fps, " << stats.frames
+              << " paced frames, avg interval " << stats.averageIntervalMs << " ms, jitter "
+              << stats.jitterMs << " ms, max lateness " << stats.maxLatenessMs << " ms, "
+              << stats.missedFrames << " missed, spin margin " << stats.spinMarginMs << " ms" << std::endl;
+}
 
 void glfwWindowSizeCallback(GLFWwindow* pWindow, int width, int height) {
     g_windowSize.x = width;
     g_windowSize.y = height;
-    RenderEngine::Renderer::setViewport(width, height);
+    // Контекст OpenGL принадлежит потоку отрисовки, размер применяется там.
+    if (g_pRenderThread) {
+        g_pRenderThread->setViewport(width, height);
+    } else {
+        RenderEngine::Renderer::setViewport(width, height);
+    }
 }
 
 void glfwKeyCallback(GLFWwindow* pWindow, int key, int scancode, int action, int mode) {
@@ -32,7 +447,167 @@ void glfwKeyCallback(GLFWwindow* pWindow, int key, int scancode, int action, int
     g_game.setKey(key, action);
 }
 
+/**
+ * Игровой цикл с отрисовкой в отдельном потоке. Основной поток обрабатывает события окна,
+ * выполняет шаги симуляции и после каждого нового шага публикует пакет кадра. Ожидание
+ * вертикальной синхронизации в glfwSwapBuffers происходит в потоке отрисовки и не задерживает
+ * ввод. События ждем не дольше, чем до следующего шага симуляции. Горячая перезагрузка
+ * выполняется в потоке отрисовки между шагами, пока основной поток ее ждет.
+ * */
+void runThreadedGameLoop(GLFWwindow* pWindow, const bool hotReload) {
+    glfwMakeContextCurrent(nullptr);
+    RenderEngine::RenderThread renderThread(pWindow, [](const RenderEngine::RenderPacket& packet) {
+        g_game.render(packet);
+    });
+    g_pRenderThread = &renderThread;
+
+    uint64_t publishedTick = UINT64_MAX;
+    auto lastTime = std::chrono::high_resolution_clock::now();
+    while (!glfwWindowShouldClose(pWindow) && !renderThread.isFinished()) {
+        PROFILE_FRAME();
+        glfwWaitEventsTimeout(g_game.isPaused() ? PAUSED_EVENTS_TIMEOUT
+                                                : static_cast<double>(g_game.getTimeToNextTick()) / 1e9);
+        auto currentTime = std::chrono::high_resolution_clock::now();
+        uint64_t duration = std::chrono::duration_cast<std::chrono::nanoseconds>(currentTime - lastTime).count();
+        lastTime = currentTime;
+        g_game.update(duration);
+        if (hotReload) {
+            renderThread.runTask([]() { g_game.pollHotReload(); });
+        }
+
+        // Состояние меняется только шагами симуляции, между шагами пакет тот же.
+        if (g_game.getTickCount() != publishedTick) {
+            publishedTick = g_game.getTickCount();
+            g_game.fillRenderPacket(renderThread.getWritePacket());
+            renderThread.publish();
+        }
+    }
+
+    g_pRenderThread = nullptr;
+    // Ресурсы OpenGL освобождаются в основном потоке, поэтому контекст возвращается ему.
+    try {
+        renderThread.stop();
+    } catch (...) {
+        glfwMakeContextCurrent(pWindow);
+        throw;
+    }
+    glfwMakeContextCurrent(pWindow);
+
+    const RenderEngine::RenderThread::Stats stats = renderThread.getStats();
+    std::cout << "Render thread: " << stats.packetsPublished << " packets, " << stats.framesRendered
+              << " frames (" << stats.packetsPublished - stats.framesRendered << " skipped), max render "
+              << stats.maxRenderNs / 1e6 << " ms, max swap " << stats.maxSwapNs / 1e6 << " ms" << std::endl;
+}
+
+void runGame(GLFWwindow* pWindow, const CommandLine& commandLine) {
+    g_game.setSeed(commandLine.seed);
+    g_game.init();
+    bool hotReload = false;
+    if (commandLine.hotReload) {
+        hotReload = ResourceManager::enableHotReload();
+        if (! hotReload) {
+            std::cerr << "Hot reload is not supported on this platform" << std::endl;
+        }
+    }
+
+    std::unique_ptr<ReplayRecorder> pReplayRecorder;
+    if (! commandLine.recordPath.empty()) {
+        ReplayHeader header;
+        header.tickDuration = Game::TICK_DURATION;
+        header.seed = g_game.getSeed();
+        header.resourcesHash = ResourceManager::getJSONResourcesHash();
+        pReplayRecorder = std::make_unique<ReplayRecorder>(commandLine.recordPath, header);
+        g_game.setReplayRecorder(pReplayRecorder.get());
+    }
+
+    if (commandLine.renderThread) {
+        runThreadedGameLoop(pWindow, hotReload);
+    } else {
+        RenderEngine::FramePacer framePacer(getTargetFps(commandLine));
+        auto lastTime = std::chrono::high_resolution_clock::now();
+        /* Loop until the user closes the window */
+        while (!glfwWindowShouldClose(pWindow)) {
+            PROFILE_FRAME();
+            /* Wait for the frame start and process events */
+            waitForFrame(pWindow, framePacer);
+            auto currentTime = std::chrono::high_resolution_clock::now();
+            uint64_t duration = std::chrono::duration_cast<std::chrono::nanoseconds>(currentTime - lastTime).count();
+            lastTime = currentTime;
+            g_game.update(duration);
+
+            /* Render here */
+            g_game.render();
+            if (hotReload) {
+                g_game.pollHotReload();
+            }
+
+            /* Swap front and back buffers */
+            PROFILE_SCOPE("glfwSwapBuffers");
+            glfwSwapBuffers(pWindow);
+        }
+        printFramePacingStats(framePacer);
+    }
+    if (pReplayRecorder) {
+        pReplayRecorder->finish(g_game.getTickCount());
+        g_game.setReplayRecorder(nullptr);
+    }
+}
+
+void runNetworkGame(GLFWwindow* pWindow, const CommandLine& commandLine) {
+    g_game.setPlayersCount(2);
+    g_game.setSeed(commandLine.seed);
+    g_game.init();
+
+    Network::UdpSocket socket({ 0, commandLine.netPort });
+    Network::RollbackSession::Settings settings;
+    settings.localPlayer = commandLine.netPlayer;
+    settings.inputDelay = commandLine.netInputDelay;
+    settings.link = commandLine.netLink;
+    settings.seed = commandLine.seed;
+    Network::RollbackSession session(g_game, socket, Network::Address::parse(commandLine.netPeer), settings);
+    std::cout << "Network game on port " << socket.getLocalAddress().port << ", peer " << commandLine.netPeer
+              << ", player " << commandLine.netPlayer + 1 << std::endl;
+
+    // Статистика откатов выводится раз в 5 секунд.
+    constexpr uint64_t STATS_INTERVAL = 5 * 60;
+    uint64_t nextStatsTick = STATS_INTERVAL;
+    // Сетевая игра не останавливается в паузе и без фокуса, кадры только ограничиваются.
+    RenderEngine::FramePacer framePacer(getTargetFps(commandLine));
+    auto lastTime = std::chrono::high_resolution_clock::now();
+    while (!glfwWindowShouldClose(pWindow)) {
+        PROFILE_FRAME();
+        framePacer.waitForNextFrame();
+        glfwPollEvents();
+        auto currentTime = std::chrono::high_resolution_clock::now();
+        uint64_t duration = std::chrono::duration_cast<std::chrono::nanoseconds>(currentTime - lastTime).count();
+        lastTime = currentTime;
+        session.update(duration, std::chrono::duration_cast<std::chrono::nanoseconds>(
+                currentTime.time_since_epoch()).count());
+        if (session.getCurrentTick() >= nextStatsTick) {
+            nextStatsTick += STATS_INTERVAL;
+            printNetworkStats("Network", session.getStats());
+        }
+
+        g_game.render();
+        PROFILE_SCOPE("glfwSwapBuffers");
+        glfwSwapBuffers(pWindow);
+    }
+    printNetworkStats("Network", session.getStats());
+    printFramePacingStats(framePacer);
+}
+
 int  main(int argc, char** argv) {
+    CommandLine commandLine;
+    if (! parseCommandLine(argc, argv, commandLine)) {
+        return -1;
+    }
+    g_game.setInternalResolution(commandLine.internalResolution);
+    ResourceManager::setTextureBudget(commandLine.textureBudget);
+    ResourceManager::setLazyLoading(commandLine.lazyResources);
+    if (! commandLine.offscreenPath.empty()) {
+        return runOffscreen(commandLine, argv[0]);
+    }
+
     /* Initialize the library */
     if (!glfwInit()) {
         std::cout << "glfwInit failed!" << std::endl;
@@ -43,6 +618,10 @@ int  main(int argc, char** argv) {
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 1);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
     glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+    // Повтор и проверка сети выполняются без отрисовки, окно нужно только ради контекста OpenGL.
+    if (! commandLine.replayPath.empty() || commandLine.netLoopbackSeconds > 0) {
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    }
 
     /* Create a windowed mode window and its OpenGL context */
     GLFWwindow* pWindow = glfwCreateWindow(g_windowSize.x, g_windowSize.y, "Battle City", nullptr, nullptr);
@@ -67,30 +646,36 @@ int  main(int argc, char** argv) {
 
     RenderEngine::Renderer::setClearColour(0, 0, 0, 1);
 
+    int exitCode = 0;
     try {
         ResourceManager::setExecutablePath(argv[0]);
-        g_game.init();
-        auto lastTime = std::chrono::high_resolution_clock::now();
-        /* Loop until the user closes the window */
-        while (!glfwWindowShouldClose(pWindow)) {
-            /* Poll for and process events */
-            glfwPollEvents();
-            auto currentTime = std::chrono::high_resolution_clock::now();
-            uint64_t duration = std::chrono::duration_cast<std::chrono::nanoseconds>(currentTime - lastTime).count();
-            lastTime = currentTime;
-            g_game.update(duration);
-
-            /* Render here */
-            RenderEngine::Renderer::clear();
-            g_game.render();
-
-            /* Swap front and back buffers */
-            glfwSwapBuffers(pWindow);
+        if (! commandLine.resourceDirectory.empty()) {
+            ResourceManager::setResourcePath(commandLine.resourceDirectory);
+        }
+        startProfiling(commandLine);
+        if (! commandLine.replayPath.empty()) {
+            exitCode = playReplay(commandLine.replayPath);
+        } else if (commandLine.netLoopbackSeconds > 0) {
+            exitCode = runNetworkLoopback(commandLine);
+        } else if (! commandLine.netPeer.empty()) {
+            if (! commandLine.recordPath.empty()) {
+                std::cerr << "Recording is not supported in network games" << std::endl;
+            }
+            runNetworkGame(pWindow, commandLine);
+        } else {
+            runGame(pWindow, commandLine);
         }
+        // Окно закрыли раньше конца диапазона профилирования: сохраняем записанное.
+        Profiler::finishCapture();
     } catch (const std::exception& ex) {
         std::cerr << ex.what() << std::endl;
+        exitCode = -1;
+    }
+    if (commandLine.textureBudget.maxBytes > 0) {
+        printResourceStats();
     }
+    RenderEngine::Renderer::releaseGpuTimer();
     ResourceManager::unloadAllResources();
     glfwTerminate();
-    return 0;
+    return exitCode;
 }
\ No newline at end of file
@@ -0,0 +1,280 @@
+#include "MaxRectsPacker.h"
+
+#include "../src/Offscreen/PngImage.h"
+
+#include <rapidjson/ostreamwrapper.h>
+#include <rapidjson/prettywriter.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * Упаковщик атласов текстур. Отдельные PNG спрайтов любого размера (файлы или каталоги с ними)
+ * упаковываются в один атлас алгоритмом MaxRects. Вокруг каждого спрайта остается поле padding
+ * пикселей, заполненное продолжением его краевых пикселей, чтобы фильтрация и масштабирование
+ * не подмешивали соседние спрайты. Одинаковые по содержимому спрайты занимают одну область.
+ *
+ * Результат: OUTPUT.png (с палитрой PNG, если цветов не больше 256) и OUTPUT.json с путем к
+ * картинке и областями спрайтов в пикселях от левого верхнего угла. На OUTPUT.json ссылается
+ * описание атласа в resources.json ("atlas"). Запускать из корня репозитория, чтобы путь к
+ * картинке совпадал с путями ресурсов:
+ *
+ *     AtlasPacker --output res/textures/sprites [--padding 1] [--max-size 2048] sprites/
+ * */
+
+namespace {
+    struct Sprite {
+        std::string name;
+        Offscreen::Image image;
+        Tools::MaxRectsPacker::Rect rect;
+        // Индекс спрайта с тем же содержимым, область которого используется; -1 - своя область.
+        int duplicateOf = -1;
+    };
+
+    struct Settings {
+        std::string outputPath;
+        unsigned int padding = 1;
+        unsigned int maxSize = 2048;
+        std::vector<std::string> inputs;
+    };
+
+    bool parseCommandLine(int argc, char** argv, Settings& settings) {
+        for (int i = 1; i < argc; ++i) {
+            const std::string argument = argv[i];
+            const bool hasValue = i + 1 < argc;
+            if (argument == "--output" && hasValue) {
+                settings.outputPath = argv[++i];
+            } else if (argument == "--padding" && hasValue) {
+                settings.padding = std::stoul(argv[++i]);
+            } else if (argument == "--max-size" && hasValue) {
+                settings.maxSize = std::stoul(argv[++i]);
+            } else if (argument.rfind("--", 0) == 0) {
+                std::cerr << "Unknown argument: " << argument << std::endl;
+                return false;
+            } else {
+                settings.inputs.push_back(argument);
+            }
+        }
+        return ! settings.outputPath.empty() && ! settings.inputs.empty();
+    }
+
+    /**
+     * Функция собирает PNG из входных файлов и каталогов (без вложенных) в порядке имен.
+     * Имя спрайта - имя файла без расширения.
+     * */
+    std::vector<std::filesystem::path> collectFiles(const std::vector<std::string>& inputs) {
+        std::vector<std::filesystem::path> files;
+        for (const std::string& input : inputs) {
+            if (std::filesystem::is_directory(input)) {
+                std::vector<std::filesystem::path> directoryFiles;
+                for (const auto& entry : std::filesystem::directory_iterator(input)) {
+                    if (entry.is_regular_file() && entry.path().extension() == ".png") {
+                        directoryFiles.push_back(entry.path());
+                    }
+                }
+                std::sort(directoryFiles.begin(), directoryFiles.end());
+                files.insert(files.end(), directoryFiles.begin(), directoryFiles.end());
+            } else {
+                files.emplace_back(input);
+            }
+        }
+        return files;
+    }
+
+    /**
+     * Функция пробует упаковать спрайты в атлас заданного размера.
+     * */
+    bool pack(std::vector<Sprite>& sprites, const std::vector<size_t>& order,
+              const unsigned int width, const unsigned int height, const unsigned int padding) {
+        Tools::MaxRectsPacker packer(width, height);
+        for (const size_t index : order) {
+            Sprite& sprite = sprites[index];
+            Tools::MaxRectsPacker::Rect cell;
+            if (! packer.insert(sprite.image.width + 2 * padding, sprite.image.height + 2 * padding, cell)) {
+                return false;
+            }
+            sprite.rect = { cell.x + padding, cell.y + padding, sprite.image.width, sprite.image.height };
+        }
+        return true;
+    }
+
+    /**
+     * Функция копирует спрайт в атлас вместе с полем: пиксели поля повторяют ближайший краевой
+     * пиксель спрайта. Координаты области отсчитываются сверху, а строки Image хранятся снизу вверх.
+     * */
+    void blit(Offscreen::Image& atlas, const Sprite& sprite, const unsigned int padding) {
+        const int width = static_cast<int>(sprite.image.width);
+        const int height = static_cast<int>(sprite.image.height);
+        for (int y = -static_cast<int>(padding); y < height + static_cast<int>(padding); ++y) {
+            const int sourceY = std::clamp(y, 0, height - 1);
+            const size_t sourceRow = static_cast<size_t>(height - 1 - sourceY);
+            const size_t atlasRow = atlas.height - 1 - static_cast<size_t>(static_cast<int>(sprite.rect.y) + y);
+            for (int x = -static_cast<int>(padding); x < width + static_cast<int>(padding); ++x) {
+                const int sourceX = std::clamp(x, 0, width - 1);
+                const uint8_t* pSource = sprite.image.pixels.data() + (sourceRow * sprite.image.width + sourceX) * 4;
+                uint8_t* pTarget = atlas.pixels.data() +
+                                   (atlasRow * atlas.width + static_cast<size_t>(static_cast<int>(sprite.rect.x) + x)) * 4;
+                std::copy(pSource, pSource + 4, pTarget);
+            }
+        }
+    }
+
+    bool writeDescription(const std::string& path, const std::string& imagePath,
+                          const std::vector<Sprite>& sprites, const Settings& settings) {
+        std::ofstream file(path, std::ios::out | std::ios::trunc);
+        if (! file.is_open()) {
+            return false;
+        }
+        rapidjson::OStreamWrapper stream(file);
+        rapidjson::PrettyWriter<rapidjson::OStreamWrapper> writer(stream);
+        writer.StartObject();
+        writer.Key("filePath");
+        writer.String(imagePath.c_str());
+        writer.Key("padding");
+        writer.Uint(settings.padding);
+        writer.Key("subTextures");
+        writer.StartArray();
+        for (const Sprite& sprite : sprites) {
+            const Tools::MaxRectsPacker::Rect& rect = sprite.duplicateOf < 0 ? sprite.rect
+                                                                             : sprites[sprite.duplicateOf].rect;
+            writer.StartObject();
+            writer.Key("name");
+            writer.String(sprite.name.c_str());
+            writer.Key("x");
+            writer.Uint(rect.x);
+            writer.Key("y");
+            writer.Uint(rect.y);
+            writer.Key("width");
+            writer.Uint(rect.width);
+            writer.Key("height");
+            writer.Uint(rect.height);
+            writer.EndObject();
+        }
+        writer.EndArray();
+        writer.EndObject();
+        file << std::endl;
+        return file.good();
+    }
+}
+
+int main(int argc, char** argv) {
+    Settings settings;
+    if (! parseCommandLine(argc, argv, settings)) {
+        std::cerr << "Usage: AtlasPacker --output PATH [--padding N] [--max-size N] FILE_OR_DIRECTORY..." << std::endl;
+        return 1;
+    }
+
+    std::vector<Sprite> sprites;
+    std::map<std::pair<std::vector<uint8_t>, std::pair<unsigned int, unsigned int>>, int> uniqueSprites;
+    uint64_t totalArea = 0;
+    unsigned int maxSide = 0;
+    for (const std::filesystem::path& file : collectFiles(settings.inputs)) {
+        Sprite sprite;
+        sprite.name = file.stem().string();
+        if (! Offscreen::loadPng(file.string(), sprite.image)) {
+            std::cerr << "Can't load image: " << file.string() << std::endl;
+            return 1;
+        }
+        const auto key = std::make_pair(sprite.image.pixels, std::make_pair(sprite.image.width, sprite.image.height));
+        const auto it = uniqueSprites.find(key);
+        if (it != uniqueSprites.end()) {
+            sprite.duplicateOf = it->second;
+        } else {
+            uniqueSprites.emplace(key, static_cast<int>(sprites.size()));
+            totalArea += static_cast<uint64_t>(sprite.image.width + 2 * settings.padding) *
+                         (sprite.image.height + 2 * settings.padding);
+            maxSide = std::max({ maxSide, sprite.image.width + 2 * settings.padding,
+                                 sprite.image.height + 2 * settings.padding });
+        }
+        sprites.push_back(std::move(sprite));
+    }
+    if (sprites.empty()) {
+        std::cerr << "No sprites to pack" << std::endl;
+        return 1;
+    }
+
+    // Крупные спрайты ставятся первыми; равные - по имени, чтобы результат был воспроизводимым.
+    std::vector<size_t> order;
+    for (size_t i = 0; i < sprites.size(); ++i) {
+        if (sprites[i].duplicateOf < 0) {
+            order.push_back(i);
+        }
+    }
+    std::sort(order.begin(), order.end(), [&sprites](const size_t a, const size_t b) {
+        const Offscreen::Image& imageA = sprites[a].image;
+        const Offscreen::Image& imageB = sprites[b].image;
+        const unsigned int sideA = std::max(imageA.width, imageA.height);
+        const unsigned int sideB = std::max(imageB.width, imageB.height);
+        if (sideA != sideB) {
+            return sideA > sideB;
+        }
+        if (imageA.width * imageA.height != imageB.width * imageB.height) {
+            return imageA.width * imageA.height > imageB.width * imageB.height;
+        }
+        return sprites[a].name < sprites[b].name;
+    });
+
+    // Атлас растет степенями двойки от наименьшего квадрата, вмещающего всю площадь, по очереди
+    // в ширину и в высоту; затем обрезается по занятой области.
+    unsigned int width = 1;
+    while (static_cast<uint64_t>(width) * width < totalArea || width < maxSide) {
+        width *= 2;
+    }
+    unsigned int height = width;
+    while (! pack(sprites, order, width, height, settings.padding)) {
+        if (height < width) {
+            height *= 2;
+        } else {
+            width *= 2;
+        }
+        if (width > settings.maxSize || height > settings.maxSize) {
+            std::cerr << "Sprites don't fit into " << settings.maxSize << "x" << settings.maxSize << std::endl;
+            return 1;
+        }
+    }
+    unsigned int usedWidth = 0;
+    unsigned int usedHeight = 0;
+    for (const size_t index : order) {
+        usedWidth = std::max(usedWidth, sprites[index].rect.x + sprites[index].rect.width + settings.padding);
+        usedHeight = std::max(usedHeight, sprites[index].rect.y + sprites[index].rect.height + settings.padding);
+    }
+
+    Offscreen::Image atlas;
+    atlas.width = usedWidth;
+    atlas.height = usedHeight;
+    atlas.pixels.assign(static_cast<size_t>(usedWidth) * usedHeight * 4, 0);
+    for (const size_t index : order) {
+        blit(atlas, sprites[index], settings.padding);
+    }
+
+    const std::string imagePath = settings.outputPath + ".png";
+    const std::string descriptionPath = settings.outputPath + ".json";
+    const std::filesystem::path outputDirectory = std::filesystem::path(settings.outputPath).parent_path();
+    if (! outputDirectory.empty()) {
+        std::error_code error;
+        std::filesystem::create_directories(outputDirectory, error);
+        if (error) {
+            std::cerr << "Can't create directory " << outputDirectory.string() << ": " << error.message() << std::endl;
+            return 1;
+        }
+    }
+    Offscreen::PngOptions pngOptions;
+    pngOptions.compress = true;
+    pngOptions.allowPalette = true;
+    if (! Offscreen::writePng(imagePath, atlas, pngOptions)) {
+        std::cerr << "Can't write atlas: " << imagePath << std::endl;
+        return 1;
+    }
+    if (! writeDescription(descriptionPath, imagePath, sprites, settings)) {
+        std::cerr << "Can't write atlas description: " << descriptionPath << std::endl;
+        return 1;
+    }
+    std::cout << "Packed " << sprites.size() << " sprites (" << order.size() << " unique) into " << usedWidth << "x"
+              << usedHeight << ", " << std::filesystem::file_size(imagePath) << " bytes: " << imagePath << std::endl;
+    return 0;
+}
@@ -0,0 +1,92 @@
+#include "MaxRectsPacker.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace {
+    bool contains(const Tools::MaxRectsPacker::Rect& outer, const Tools::MaxRectsPacker::Rect& inner) noexcept {
+        return inner.x >= outer.x && inner.y >= outer.y &&
+               inner.x + inner.width <= outer.x + outer.width &&
+               inner.y + inner.height <= outer.y + outer.height;
+    }
+}
+
+namespace Tools {
+
+    MaxRectsPacker::MaxRectsPacker(const unsigned int width, const unsigned int height) :
+                                   m_freeRects{ { 0, 0, width, height } } {
+    }
+
+    bool MaxRectsPacker::insert(const unsigned int width, const unsigned int height, Rect& result) {
+        unsigned int bestShortSide = std::numeric_limits<unsigned int>::max();
+        unsigned int bestLongSide = std::numeric_limits<unsigned int>::max();
+        bool found = false;
+        for (const Rect& freeRect : m_freeRects) {
+            if (freeRect.width < width || freeRect.height < height) {
+                continue;
+            }
+            const unsigned int leftoverX = freeRect.width - width;
+            const unsigned int leftoverY = freeRect.height - height;
+            const unsigned int shortSide = std::min(leftoverX, leftoverY);
+            const unsigned int longSide = std::max(leftoverX, leftoverY);
+            if (shortSide < bestShortSide || (shortSide == bestShortSide && longSide < bestLongSide)) {
+                bestShortSide = shortSide;
+                bestLongSide = longSide;
+                result = { freeRect.x, freeRect.y, width, height };
+                found = true;
+            }
+        }
+        if (! found) {
+            return false;
+        }
+        splitFreeRects(result);
+        pruneFreeRects();
+        return true;
+    }
+
+    void MaxRectsPacker::splitFreeRects(const Rect& used) {
+        // Каждый свободный прямоугольник, пересекающийся с занятым, заменяется до четырьмя
+        // максимальными частями, лежащими вне занятого.
+        std::vector<Rect> rects;
+        rects.reserve(m_freeRects.size() * 2);
+        for (const Rect& freeRect : m_freeRects) {
+            if (used.x >= freeRect.x + freeRect.width || used.x + used.width <= freeRect.x ||
+                used.y >= freeRect.y + freeRect.height || used.y + used.height <= freeRect.y) {
+                rects.push_back(freeRect);
+                continue;
+            }
+            if (used.x > freeRect.x) {
+                rects.push_back({ freeRect.x, freeRect.y, used.x - freeRect.x, freeRect.height });
+            }
+            if (used.x + used.width < freeRect.x + freeRect.width) {
+                rects.push_back({ used.x + used.width, freeRect.y,
+                                  freeRect.x + freeRect.width - used.x - used.width, freeRect.height });
+            }
+            if (used.y > freeRect.y) {
+                rects.push_back({ freeRect.x, freeRect.y, freeRect.width, used.y - freeRect.y });
+            }
+            if (used.y + used.height < freeRect.y + freeRect.height) {
+                rects.push_back({ freeRect.x, used.y + used.height,
+                                  freeRect.width, freeRect.y + freeRect.height - used.y - used.height });
+            }
+        }
+        m_freeRects = std::move(rects);
+    }
+
+    void MaxRectsPacker::pruneFreeRects() {
+        // Прямоугольники, целиком лежащие в другом свободном, не нужны.
+        for (size_t i = 0; i < m_freeRects.size(); ++i) {
+            for (size_t j = i + 1; j < m_freeRects.size();) {
+                if (contains(m_freeRects[i], m_freeRects[j])) {
+                    m_freeRects.erase(m_freeRects.begin() + static_cast<std::ptrdiff_t>(j));
+                } else if (contains(m_freeRects[j], m_freeRects[i])) {
+                    m_freeRects.erase(m_freeRects.begin() + static_cast<std::ptrdiff_t>(i));
+                    --i;
+                    break;
+                } else {
+                    ++j;
+                }
+            }
+        }
+    }
+}
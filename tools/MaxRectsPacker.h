@@ -0,0 +1,42 @@
+#pragma once
+
+#include <vector>
+
+namespace Tools {
+
+    /**
+     * Упаковка прямоугольников в атлас алгоритмом MaxRects (J. Jylänki, "A Thousand Ways to Pack
+     * the Bin"). Свободная область хранится набором максимальных пересекающихся прямоугольников;
+     * каждый новый прямоугольник ставится в свободный с наименьшим остатком по короткой стороне
+     * (Best Short Side Fit). Прямоугольники не поворачиваются: координаты текстуры спрайтов
+     * рассчитаны на исходную ориентацию.
+     * */
+    class MaxRectsPacker {
+    public:
+        MaxRectsPacker() = delete;
+
+    public:
+        struct Rect {
+            unsigned int x = 0;
+            unsigned int y = 0;
+            unsigned int width = 0;
+            unsigned int height = 0;
+        };
+
+        MaxRectsPacker(unsigned int width, unsigned int height);
+
+        /**
+         * Метод размещает прямоугольник заданного размера.
+         * @param result место прямоугольника в атласе.
+         * @return false, если свободного места нет.
+         * */
+        bool insert(unsigned int width, unsigned int height, Rect& result);
+
+    private:
+        void splitFreeRects(const Rect& used);
+        void pruneFreeRects();
+
+    private:
+        std::vector<Rect> m_freeRects;
+    };
+}